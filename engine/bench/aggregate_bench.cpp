@@ -0,0 +1,62 @@
+#include "database.h"
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <random>
+
+namespace {
+
+constexpr int TABLE_ROWS = 200000;
+
+void RunAggregate(Database& db, const std::string& label, const std::string& sql) {
+    db.ExecuteQuery(sql);
+    auto start = std::chrono::steady_clock::now();
+    db.ExecuteQuery(sql);
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << label << "  " << static_cast<size_t>(TABLE_ROWS / elapsed) << " rows/s ("
+              << db.GetLastResults().size() << " groups)" << std::endl;
+}
+
+}  // namespace
+
+// COUNT(*) off the leaf key counts against a full aggregate, and GROUP BY
+// over few and many groups, the latter with a budget small enough to spill.
+int main(int argc, char** argv) {
+    std::string db_file = argc > 1 ? argv[1] : "aggregate_bench.db";
+    std::string log_file = db_file + ".wal";
+    std::remove(db_file.c_str());
+    std::remove(log_file.c_str());
+
+    {
+        Database db(db_file);
+        db.ExecuteQuery("CREATE TABLE orders (id INT, status INT, amount DOUBLE, customer INT) "
+                        "WITH (storage = columnar)");
+        std::mt19937 rng(5);
+        int id = 0;
+        db.BulkLoad("orders", [&](Record& record) {
+            if (id == TABLE_ROWS) {
+                return false;
+            }
+            record = Record({id++, static_cast<int>(rng() % 8), (rng() % 10000) / 100.0,
+                             static_cast<int>(rng() % 50000)});
+            return true;
+        });
+    }
+
+    for (size_t budget : {size_t(64) << 20, size_t(256) << 10}) {
+        DatabaseOptions options;
+        options.aggregate_memory_bytes = budget;
+        Database db(db_file, options);
+        std::cout << "memory budget " << (budget >> 10) << " KB" << std::endl;
+        RunAggregate(db, "count(*)            ", "SELECT COUNT(*) FROM orders");
+        RunAggregate(db, "count, sum          ", "SELECT COUNT(*), SUM(amount) FROM orders");
+        RunAggregate(db, "group by status     ",
+                     "SELECT status, COUNT(*), SUM(amount), MAX(amount) FROM orders GROUP BY status");
+        RunAggregate(db, "group by customer   ",
+                     "SELECT customer, COUNT(*), AVG(amount) FROM orders GROUP BY customer");
+    }
+
+    std::remove(db_file.c_str());
+    std::remove(log_file.c_str());
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,146 @@
+#include "buffer_pool_manager.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr size_t POOL_SIZE = 64;
+constexpr size_t PAGE_COUNT = 512;
+constexpr size_t OPS_PER_THREAD = 200000;
+
+struct PageStamp {
+    page_id_t page_id;
+    uint32_t write_count;
+};
+
+bool RunWorker(BufferPoolManager& bpm, const std::vector<page_id_t>& page_ids,
+               unsigned seed, size_t& writes) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<size_t> pick(0, page_ids.size() - 1);
+
+    for (size_t op = 0; op < OPS_PER_THREAD; ++op) {
+        page_id_t page_id = page_ids[pick(rng)];
+        Page* page = bpm.FetchPage(page_id);
+        if (!page) {
+            std::cerr << "FetchPage failed for page " << page_id << std::endl;
+            return false;
+        }
+        if (page->GetPageId() != page_id) {
+            std::cerr << "Frame holds page " << page->GetPageId() << ", expected " << page_id << std::endl;
+            return false;
+        }
+
+        bool write = (rng() % 16) == 0;
+        PageStamp stamp;
+        if (write) {
+            page->WLatch();
+            std::memcpy(&stamp, page->GetData(), sizeof(stamp));
+            stamp.write_count++;
+            std::memcpy(page->GetData(), &stamp, sizeof(stamp));
+            page->WUnlatch();
+            writes++;
+        } else {
+            page->RLatch();
+            std::memcpy(&stamp, page->GetData(), sizeof(stamp));
+            page->RUnlatch();
+        }
+
+        if (stamp.page_id != page_id) {
+            std::cerr << "Page " << page_id << " carries stamp " << stamp.page_id << std::endl;
+            return false;
+        }
+        if (!bpm.UnpinPage(page_id, write)) {
+            std::cerr << "UnpinPage failed for page " << page_id << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool RunRound(ReplacerType replacer_type, size_t thread_count) {
+    const char* db_file = "buffer_pool_stress.db";
+    std::remove(db_file);
+
+    auto storage_manager = StorageManager::Open(db_file);
+    BufferPoolManager bpm(POOL_SIZE, storage_manager.get(), replacer_type);
+
+    std::vector<page_id_t> page_ids;
+    for (size_t i = 0; i < PAGE_COUNT; ++i) {
+        page_id_t page_id;
+        Page* page = bpm.NewPage(&page_id);
+        PageStamp stamp{page_id, 0};
+        std::memcpy(page->GetData(), &stamp, sizeof(stamp));
+        bpm.UnpinPage(page_id, true);
+        page_ids.push_back(page_id);
+    }
+
+    std::vector<std::thread> threads;
+    std::vector<size_t> writes(thread_count, 0);
+    std::vector<char> ok(thread_count, 0);
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t t = 0; t < thread_count; ++t) {
+        threads.emplace_back([&, t] {
+            ok[t] = RunWorker(bpm, page_ids, static_cast<unsigned>(t + 1), writes[t]);
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    bool passed = true;
+    for (char worker_ok : ok) {
+        passed = passed && worker_ok;
+    }
+
+    size_t expected_writes = 0;
+    for (size_t w : writes) {
+        expected_writes += w;
+    }
+
+    size_t observed_writes = 0;
+    for (page_id_t page_id : page_ids) {
+        if (bpm.GetPinCount(page_id) > 0) {
+            std::cerr << "Page " << page_id << " still pinned after all workers finished" << std::endl;
+            passed = false;
+        }
+        Page* page = bpm.FetchPage(page_id);
+        PageStamp stamp;
+        std::memcpy(&stamp, page->GetData(), sizeof(stamp));
+        observed_writes += stamp.write_count;
+        bpm.UnpinPage(page_id, false);
+    }
+
+    if (observed_writes != expected_writes) {
+        std::cerr << "Lost updates: expected " << expected_writes << " writes, found " << observed_writes << std::endl;
+        passed = false;
+    }
+
+    double ops = static_cast<double>(thread_count * OPS_PER_THREAD);
+    std::cout << (replacer_type == ReplacerType::CLOCK ? "CLOCK" : "LRU-K") << ", "
+              << thread_count << " threads, " << bpm.GetShardCount() << " shards: "
+              << static_cast<size_t>(ops / elapsed) << " fetch/unpin per second"
+              << (passed ? "" : " [FAILED]") << std::endl;
+
+    std::remove(db_file);
+    return passed;
+}
+
+}  // namespace
+
+int main() {
+    size_t max_threads = std::max(8u, std::thread::hardware_concurrency());
+    bool passed = true;
+    for (ReplacerType replacer_type : {ReplacerType::LRU_K, ReplacerType::CLOCK}) {
+        for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+            passed = RunRound(replacer_type, threads) && passed;
+        }
+    }
+    return passed ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,108 @@
+#include "database.h"
+#include <chrono>
+#include <cstdio>
+#include <fcntl.h>
+#include <iostream>
+#include <random>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr int ROWS = 200000;
+constexpr const char* SCAN = "SELECT * FROM events WHERE kind = 3";
+
+const char* STATUSES[] = {"order received and waiting for payment", "payment confirmed, preparing shipment",
+                          "shipped from the central warehouse", "delivered to the customer"};
+
+double Seconds(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+size_t FileSize(const std::string& file) {
+    struct stat file_stat;
+    return ::stat(file.c_str(), &file_stat) == 0 ? static_cast<size_t>(file_stat.st_size) : 0;
+}
+
+// Drops the file from the OS page cache so the next scan reads from disk.
+void DropCache(const std::string& file) {
+    int fd = ::open(file.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        ::close(fd);
+    }
+}
+
+void Run(const std::string& db_file, StorageBackend backend, const char* label) {
+    std::string log_file = db_file + ".wal";
+    std::remove(db_file.c_str());
+    std::remove(log_file.c_str());
+
+    DatabaseOptions options;
+    options.storage_backend = backend;
+    double load_seconds;
+    {
+        Database db(db_file, options);
+        db.ExecuteQuery("CREATE TABLE events (id INT, kind INT, status VARCHAR, region VARCHAR)");
+        std::mt19937 rng(11);
+        int id = 0;
+        auto start = std::chrono::steady_clock::now();
+        db.BulkLoad("events", [&](Record& record) {
+            if (id == ROWS) {
+                return false;
+            }
+            int kind = static_cast<int>(rng() % 4);
+            record = Record({id++, kind, STATUSES[kind], "region-" + std::to_string(rng() % 8)});
+            return true;
+        });
+        load_seconds = Seconds(start);
+    }
+
+    DropCache(db_file);
+    Database db(db_file, options);
+    auto start = std::chrono::steady_clock::now();
+    db.ExecuteQuery(SCAN);
+    double scan_seconds = Seconds(start);
+
+    DatabaseStats stats = db.GetStats();
+    std::cout << label << "  file " << FileSize(db_file) / 1024 << " KB, load " << load_seconds * 1000
+              << " ms, cold scan " << scan_seconds * 1000 << " ms (" << db.GetLastResults().size() << " rows)";
+    if (stats.storage.pages_read > 0) {
+        std::cout << ", " << stats.storage.DecompressMicrosPerPage() << " us/page to decompress";
+    }
+    std::cout << std::endl;
+
+    std::remove(db_file.c_str());
+    std::remove(log_file.c_str());
+}
+
+void RunWrites(const std::string& db_file) {
+    std::remove(db_file.c_str());
+    auto storage_manager = StorageManager::Open(db_file, StorageBackend::COMPRESSED);
+    Page page;
+    for (int i = 0; i < 4096; ++i) {
+        page.ResetMemory();
+        for (size_t offset = sizeof(lsn_t); offset + 40 < PAGE_SIZE / 2; offset += 40) {
+            std::memcpy(page.GetData() + offset, STATUSES[(offset + i) % 4], 32);
+        }
+        storage_manager->WritePage(storage_manager->AllocatePage(), page.GetData());
+    }
+    storage_manager->Sync();
+
+    StorageStats stats = storage_manager->GetStats();
+    std::cout << "half-full pages: ratio " << stats.CompressionRatio() << ", " << stats.CompressMicrosPerPage()
+              << " us/page to compress" << std::endl;
+    std::remove(db_file.c_str());
+}
+
+}  // namespace
+
+// Loads the same table of repetitive strings with plain and compressed
+// pages, then scans it after dropping the file from the OS page cache.
+int main(int argc, char** argv) {
+    std::string db_file = argc > 1 ? argv[1] : "compression_bench.db";
+    Run(db_file, StorageBackend::PREAD, "pread     ");
+    Run(db_file, StorageBackend::COMPRESSED, "compressed");
+    RunWrites(db_file);
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,79 @@
+#include "database.h"
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <random>
+
+namespace {
+
+constexpr int CUSTOMERS = 20000;
+constexpr int ORDERS = 100000;
+
+double Seconds(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void RunJoin(Database& db, const std::string& label, const std::string& sql) {
+    db.ExecuteQuery(sql);
+    auto start = std::chrono::steady_clock::now();
+    db.ExecuteQuery(sql);
+    double elapsed = Seconds(start);
+    std::cout << label << "  " << static_cast<size_t>(ORDERS / elapsed) << " orders/s ("
+              << db.GetLastResults().size() << " rows)" << std::endl;
+}
+
+}  // namespace
+
+// Joining orders to their customers: one lookup query per order, as clients
+// did before joins, against the index nested-loop join on the customer key
+// and a hash join on code, a copy of the key that is not indexed.
+int main(int argc, char** argv) {
+    std::string db_file = argc > 1 ? argv[1] : "join_bench.db";
+    std::string log_file = db_file + ".wal";
+    std::remove(db_file.c_str());
+    std::remove(log_file.c_str());
+
+    {
+        Database db(db_file);
+        db.ExecuteQuery("CREATE TABLE customers (id INT, code INT, name VARCHAR)");
+        db.ExecuteQuery("CREATE TABLE orders (id INT, customer INT, amount DOUBLE)");
+        std::mt19937 rng(9);
+        int id = 0;
+        db.BulkLoad("customers", [&](Record& record) {
+            if (id == CUSTOMERS) {
+                return false;
+            }
+            record = Record({id, id, "customer" + std::to_string(id)});
+            id++;
+            return true;
+        });
+        id = 0;
+        db.BulkLoad("orders", [&](Record& record) {
+            if (id == ORDERS) {
+                return false;
+            }
+            record = Record({id++, static_cast<int>(rng() % CUSTOMERS), (rng() % 10000) / 100.0});
+            return true;
+        });
+
+        auto lookup = db.Prepare("SELECT name FROM customers WHERE id = ?");
+        auto start = std::chrono::steady_clock::now();
+        size_t rows = 0;
+        db.ExecuteQuery("SELECT customer FROM orders");
+        std::vector<Record> orders = db.GetLastResults();
+        for (const auto& order : orders) {
+            lookup->Bind(0, std::get<int>(order.GetValue(0)));
+            lookup->Execute();
+            rows += db.GetLastResults().size();
+        }
+        std::cout << "N+1 lookups      " << static_cast<size_t>(ORDERS / Seconds(start)) << " orders/s (" << rows
+                  << " rows)" << std::endl;
+
+        RunJoin(db, "index nested loop", "SELECT orders.id, name FROM orders JOIN customers ON customer = customers.id");
+        RunJoin(db, "hash join        ", "SELECT orders.id, name FROM orders JOIN customers ON customer = code");
+    }
+
+    std::remove(db_file.c_str());
+    std::remove(log_file.c_str());
+    return 0;
+}
\ No newline at end of file
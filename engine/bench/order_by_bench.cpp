@@ -0,0 +1,70 @@
+#include "database.h"
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <random>
+
+namespace {
+
+constexpr int ROWS = 200000;
+
+double Seconds(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void Load(Database& db) {
+    db.ExecuteQuery("CREATE TABLE orders (id INT, customer INT, amount DOUBLE, note VARCHAR)");
+    std::mt19937 rng(5);
+    int id = 0;
+    db.BulkLoad("orders", [&](Record& record) {
+        if (id == ROWS) {
+            return false;
+        }
+        record = Record({id++, static_cast<int>(rng() % 5000), (rng() % 1000000) / 100.0, "order note"});
+        return true;
+    });
+}
+
+void RunSort(Database& db, const std::string& label, const std::string& sql) {
+    db.ExecuteQuery(sql);
+    auto start = std::chrono::steady_clock::now();
+    db.ExecuteQuery(sql);
+    double elapsed = Seconds(start);
+    std::cout << label << "  " << elapsed * 1000 << " ms (" << db.GetLastResults().size() << " rows)" << std::endl;
+}
+
+}  // namespace
+
+// Against a plain scan of the table: the first rows in key order stop the scan
+// early, the top rows by another column keep a heap of ten, and sorting the
+// whole table runs in memory with the default budget and spills sorted runs
+// with a budget of 1MB.
+int main(int argc, char** argv) {
+    std::string db_file = argc > 1 ? argv[1] : "order_by_bench.db";
+    std::string log_file = db_file + ".wal";
+    std::remove(db_file.c_str());
+    std::remove(log_file.c_str());
+
+    {
+        Database db(db_file);
+        Load(db);
+        RunSort(db, "plain scan          ", "SELECT * FROM orders");
+        RunSort(db, "key order LIMIT 10  ", "SELECT * FROM orders ORDER BY id LIMIT 10");
+        RunSort(db, "top 10 by amount    ", "SELECT * FROM orders ORDER BY amount DESC LIMIT 10");
+        RunSort(db, "sort in memory      ", "SELECT * FROM orders ORDER BY amount DESC");
+    }
+    std::remove(db_file.c_str());
+    std::remove(log_file.c_str());
+
+    {
+        DatabaseOptions options;
+        options.sort_memory_bytes = 1024 * 1024;
+        Database db(db_file, options);
+        Load(db);
+        RunSort(db, "spilling sort (1MB) ", "SELECT * FROM orders ORDER BY amount DESC");
+    }
+
+    std::remove(db_file.c_str());
+    std::remove(log_file.c_str());
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,60 @@
+#include "database.h"
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <random>
+
+namespace {
+
+constexpr int TABLE_ROWS = 200000;
+constexpr const char* FILTER = "SELECT id, amount FROM orders WHERE status = 3 AND amount > 50.0";
+
+void RunScan(const std::string& db_file, size_t threads) {
+    DatabaseOptions options;
+    options.scan_threads = threads;
+    Database db(db_file, options);
+
+    for (int round = 0; round < 3; ++round) {
+        auto start = std::chrono::steady_clock::now();
+        db.ExecuteQuery(FILTER);
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "threads " << threads << "  " << static_cast<size_t>(TABLE_ROWS / elapsed) << " rows/s ("
+                  << db.GetLastResults().size() << " matched)" << std::endl;
+    }
+}
+
+}  // namespace
+
+// Full-table filter scans over a columnar table with an increasing number of
+// scan workers. The worker count is capped by the buffer pool's shard size.
+int main(int argc, char** argv) {
+    std::string db_file = argc > 1 ? argv[1] : "parallel_scan_bench.db";
+    std::string log_file = db_file + ".wal";
+    std::remove(db_file.c_str());
+    std::remove(log_file.c_str());
+
+    {
+        Database db(db_file);
+        db.ExecuteQuery("CREATE TABLE orders (id INT, status INT, amount DOUBLE, customer INT) "
+                        "WITH (storage = columnar)");
+        std::mt19937 rng(5);
+        int id = 0;
+        db.BulkLoad("orders", [&](Record& record) {
+            if (id == TABLE_ROWS) {
+                return false;
+            }
+            record = Record({id++, static_cast<int>(rng() % 8), (rng() % 10000) / 100.0,
+                             static_cast<int>(rng() % 5000)});
+            return true;
+        });
+    }
+
+    std::cout << "hardware threads " << std::thread::hardware_concurrency() << std::endl;
+    for (size_t threads : {1, 2, 4}) {
+        RunScan(db_file, threads);
+    }
+
+    std::remove(db_file.c_str());
+    std::remove(log_file.c_str());
+    return 0;
+}
\ No newline at end of file
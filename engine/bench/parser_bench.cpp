@@ -0,0 +1,83 @@
+#include "sql_parser.h"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+static std::atomic<size_t> allocation_count{0};
+
+void* operator new(size_t size) {
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+namespace {
+
+constexpr size_t ITERATIONS = 200000;
+
+const char* const QUERIES[] = {
+    "SELECT * FROM users WHERE id = 42",
+    "select name, age from users where age > 30 and name = 'Bob Smith'",
+    "INSERT INTO users VALUES (1, 'Alice', 25), (2, 'Bob', 30), (3, 'Charlie', 35)",
+    "CREATE TABLE users (id INT, name VARCHAR(64), age INT)",
+};
+
+void RunParse(SQLParser& parser, const char* sql) {
+    size_t failures = 0;
+    size_t allocations = allocation_count.load();
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < ITERATIONS; ++i) {
+        if (!parser.Parse(sql)) {
+            failures++;
+        }
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    allocations = allocation_count.load() - allocations;
+
+    std::cout << "parse     " << static_cast<size_t>(ITERATIONS / elapsed) << " stmts/s, "
+              << static_cast<double>(allocations) / ITERATIONS << " allocs/stmt  " << sql;
+    if (failures > 0) {
+        std::cout << " [" << failures << " failed]";
+    }
+    std::cout << std::endl;
+}
+
+void RunNormalize(SQLParser& parser, const char* sql) {
+    std::vector<Value> literals;
+    size_t allocations = allocation_count.load();
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < ITERATIONS; ++i) {
+        literals.clear();
+        parser.Normalize(sql, &literals);
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    allocations = allocation_count.load() - allocations;
+
+    std::cout << "normalize " << static_cast<size_t>(ITERATIONS / elapsed) << " stmts/s, "
+              << static_cast<double>(allocations) / ITERATIONS << " allocs/stmt  " << sql << std::endl;
+}
+
+}  // namespace
+
+int main() {
+    SQLParser parser;
+    for (const char* sql : QUERIES) {
+        RunParse(parser, sql);
+    }
+    for (const char* sql : QUERIES) {
+        RunNormalize(parser, sql);
+    }
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,101 @@
+#include "database.h"
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <random>
+
+namespace {
+
+constexpr int TABLE_ROWS = 100000;
+constexpr const char* SCHEMA =
+    "(id INT, a INT, b INT, c INT, d INT, e INT, f INT, g INT, h INT, "
+    "w DOUBLE, x DOUBLE, y DOUBLE, z DOUBLE, region VARCHAR, city VARCHAR, note VARCHAR)";
+constexpr const char* PROJECTION = "SELECT a, w FROM wide WHERE b < 10";
+
+Record MakeRow(int id, std::mt19937& rng) {
+    std::vector<Value> values{id};
+    for (int i = 0; i < 8; ++i) {
+        values.emplace_back(static_cast<int>(rng() % 100));
+    }
+    for (int i = 0; i < 4; ++i) {
+        values.emplace_back((rng() % 10000) / 100.0);
+    }
+    values.emplace_back("region-" + std::to_string(rng() % 8));
+    values.emplace_back("city-" + std::to_string(rng() % 500));
+    values.emplace_back("note " + std::to_string(rng()) + " for row " + std::to_string(id));
+    return Record(values);
+}
+
+void RunLayout(const std::string& db_file, bool columnar) {
+    std::string log_file = db_file + ".wal";
+    std::remove(db_file.c_str());
+    std::remove(log_file.c_str());
+
+    const char* name = columnar ? "pax " : "row ";
+    {
+        Database db(db_file);
+        std::string create = std::string("CREATE TABLE wide ") + SCHEMA;
+        if (columnar) {
+            create += " WITH (storage = columnar)";
+        }
+        db.ExecuteQuery(create);
+
+        std::mt19937 rng(11);
+        int id = 0;
+        auto start = std::chrono::steady_clock::now();
+        db.BulkLoad("wide", [&](Record& record) {
+            if (id == TABLE_ROWS) {
+                return false;
+            }
+            record = MakeRow(id++, rng);
+            return true;
+        });
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << name << "load " << static_cast<size_t>(TABLE_ROWS / elapsed) << " rows/s, "
+                  << std::filesystem::file_size(db_file) / PAGE_SIZE << " pages" << std::endl;
+
+        for (int round = 0; round < 3; ++round) {
+            start = std::chrono::steady_clock::now();
+            db.ExecuteQuery(PROJECTION);
+            elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            std::cout << name << "scan " << static_cast<size_t>(TABLE_ROWS / elapsed) << " rows/s ("
+                      << db.GetLastResults().size() << " matched)" << std::endl;
+        }
+
+        std::mt19937 insert_rng(13);
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < 1000; ++i) {
+            Record row = MakeRow(TABLE_ROWS + i, insert_rng);
+            std::string sql = "INSERT INTO wide VALUES (" + std::to_string(TABLE_ROWS + i);
+            for (size_t v = 1; v < row.GetValues().size(); ++v) {
+                const Value& value = row.GetValues()[v];
+                sql += ", ";
+                if (std::holds_alternative<std::string>(value)) {
+                    sql += "'" + std::get<std::string>(value) + "'";
+                } else if (std::holds_alternative<double>(value)) {
+                    sql += std::to_string(std::get<double>(value));
+                } else {
+                    sql += std::to_string(std::get<int>(value));
+                }
+            }
+            db.ExecuteQuery(sql + ")");
+        }
+        elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << name << "insert " << static_cast<size_t>(1000 / elapsed) << " rows/s" << std::endl;
+    }
+
+    std::remove(db_file.c_str());
+    std::remove(log_file.c_str());
+}
+
+}  // namespace
+
+// Compares a wide table stored row-major with the same table in PAX leaves,
+// scanned for two of its sixteen columns.
+int main(int argc, char** argv) {
+    std::string db_file = argc > 1 ? argv[1] : "pax_bench.db";
+    RunLayout(db_file, false);
+    RunLayout(db_file, true);
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,92 @@
+#include "database.h"
+#include "filter_kernels.h"
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <random>
+
+namespace {
+
+constexpr int TABLE_ROWS = 200000;
+constexpr size_t KERNEL_ITERATIONS = 200000;
+constexpr const char* FILTER = "SELECT * FROM events WHERE kind < 3 AND weight > 0.9";
+
+void RunKernel(const ColumnBatch& batch, bool avx2) {
+    FilterKernels::SetAvx2Enabled(avx2);
+    std::vector<uint16_t> selection(BATCH_SIZE);
+    size_t selected = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < KERNEL_ITERATIONS; ++i) {
+        selected += FilterKernels::Filter(batch.GetColumn(1), CompareOp::LT, Value(3), true, batch.GetSize(),
+                                          selection.data());
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double values = static_cast<double>(KERNEL_ITERATIONS) * batch.GetSize();
+
+    std::cout << (avx2 ? "kernel avx2   " : "kernel scalar ") << static_cast<size_t>(values / elapsed / 1e6)
+              << " M values/s (" << selected / KERNEL_ITERATIONS << " selected per batch)" << std::endl;
+}
+
+void RunScan(Database& db, bool vectorized) {
+    size_t rows = 0;
+    auto start = std::chrono::steady_clock::now();
+    if (vectorized) {
+        db.ExecuteQuery(FILTER);
+        rows = db.GetLastResults().size();
+    } else if (auto cursor = db.Query(FILTER)) {
+        Record record;
+        while (cursor->Next(record)) {
+            rows++;
+        }
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << (vectorized ? "scan batched  " : "scan row-wise ") << static_cast<size_t>(TABLE_ROWS / elapsed)
+              << " rows/s (" << rows << " matched)" << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const char* db_file = argc > 1 ? argv[1] : "scan_bench.db";
+    std::string log_file = std::string(db_file) + ".wal";
+    std::remove(db_file);
+    std::remove(log_file.c_str());
+
+    std::mt19937 rng(7);
+    std::cout << "avx2 " << (FilterKernels::IsAvx2Supported() ? "available" : "unavailable") << std::endl;
+
+    ColumnBatch batch(2);
+    std::vector<bool> columns(2, true);
+    RowFormat format({ColumnType::INT, ColumnType::INT});
+    for (size_t i = 0; i < BATCH_SIZE; ++i) {
+        Record record({static_cast<int>(i), static_cast<int>(rng() % 10)});
+        std::string data(format.GetSize(record), '\0');
+        format.Encode(record, data.data());
+        batch.AppendSerialized(data.data(), format, columns, nullptr);
+    }
+    RunKernel(batch, false);
+    RunKernel(batch, true);
+
+    {
+        Database db(db_file);
+        db.ExecuteQuery("CREATE TABLE events (id INT, kind INT, weight DOUBLE)");
+        int id = 0;
+        db.BulkLoad("events", [&](Record& record) {
+            if (id == TABLE_ROWS) {
+                return false;
+            }
+            record = Record({id++, static_cast<int>(rng() % 10), (rng() % 1000) / 1000.0});
+            return true;
+        });
+
+        for (int round = 0; round < 3; ++round) {
+            RunScan(db, false);
+            RunScan(db, true);
+        }
+    }
+
+    std::remove(db_file);
+    std::remove(log_file.c_str());
+    return 0;
+}
\ No newline at end of file
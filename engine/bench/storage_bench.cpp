@@ -0,0 +1,74 @@
+#include "storage_manager.h"
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr size_t FILE_PAGES = 16384;  // 64 MB
+constexpr size_t READS = 100000;
+
+const char* BackendName(StorageBackend backend) {
+    switch (backend) {
+        case StorageBackend::DIRECT_IO:
+            return "pread + O_DIRECT";
+        case StorageBackend::MMAP:
+            return "mmap";
+        case StorageBackend::PREAD:
+        default:
+            return "pread";
+    }
+}
+
+void CreateFile(const char* db_file) {
+    std::remove(db_file);
+    auto storage_manager = StorageManager::Open(db_file);
+    Page page;
+    for (size_t i = 0; i < FILE_PAGES; ++i) {
+        page_id_t page_id = storage_manager->AllocatePage();
+        page.SetLSN(page_id);
+        storage_manager->WritePage(page_id, page.GetData());
+    }
+    storage_manager->Sync();
+}
+
+void RunRandomReads(const char* db_file, StorageBackend backend) {
+    auto storage_manager = StorageManager::Open(db_file, backend);
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<page_id_t> pick(0, FILE_PAGES - 1);
+    Page page;
+
+    size_t mismatches = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < READS; ++i) {
+        page_id_t page_id = pick(rng);
+        storage_manager->ReadPage(page_id, page.GetData());
+        if (page.GetLSN() != page_id) {
+            mismatches++;
+        }
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << BackendName(backend) << ": " << static_cast<size_t>(READS / elapsed) << " random 4KB reads/s, "
+              << (READS * PAGE_SIZE / elapsed) / (1024 * 1024) << " MB/s";
+    if (mismatches > 0) {
+        std::cout << " [" << mismatches << " pages read back wrong]";
+    }
+    std::cout << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const char* db_file = argc > 1 ? argv[1] : "storage_bench.db";
+    CreateFile(db_file);
+
+    for (StorageBackend backend : {StorageBackend::PREAD, StorageBackend::DIRECT_IO, StorageBackend::MMAP}) {
+        RunRandomReads(db_file, backend);
+    }
+
+    std::remove(db_file);
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,15 @@
+#include "async_io.h"
+#include "io_uring_async_io.h"
+#include "thread_pool_async_io.h"
+
+std::unique_ptr<AsyncIO> AsyncIO::Create(StorageManager* storage_manager) {
+#ifdef SIMPLEDB_HAVE_IO_URING
+    if (storage_manager->GetFileDescriptor() >= 0 && storage_manager->StoresPagesInPlace()) {
+        auto io_uring = std::make_unique<IoUringAsyncIO>(storage_manager->GetFileDescriptor());
+        if (io_uring->IsInitialized()) {
+            return io_uring;
+        }
+    }
+#endif
+    return std::make_unique<ThreadPoolAsyncIO>(storage_manager);
+}
\ No newline at end of file
@@ -0,0 +1,21 @@
+#pragma once
+#include "page.h"
+#include "storage_manager.h"
+#include <functional>
+#include <memory>
+
+// Asynchronous page reads. Requests queued with ReadPage are handed to the
+// kernel (or worker threads) on Submit; callbacks run on an I/O thread.
+class AsyncIO {
+public:
+    using Callback = std::function<void(bool success)>;
+
+    virtual ~AsyncIO() = default;
+
+    virtual void ReadPage(page_id_t page_id, char* data, Callback callback) = 0;
+    virtual void Submit() = 0;
+
+    // Prefers io_uring on the storage manager's file descriptor and falls
+    // back to a small thread pool issuing synchronous reads.
+    static std::unique_ptr<AsyncIO> Create(StorageManager* storage_manager);
+};
\ No newline at end of file
@@ -1,312 +1,875 @@
 #include "btree.h"
 #include <algorithm>
+#include <cstdint>
 #include <cstring>
 
-BTree::BTree(BufferPoolManager* buffer_pool_manager) 
-    : buffer_pool_manager_(buffer_pool_manager) {
+BTree::BTree(BufferPoolManager* buffer_pool_manager, LeafLayout leaf_layout, RowFormat row_format)
+    : buffer_pool_manager_(buffer_pool_manager), leaf_layout_(leaf_layout), row_format_(std::move(row_format)) {
     root_page_id_ = CreateNewNode(true);
 }
 
-bool BTree::Insert(int key, const Record& record) {
-    if (root_page_id_ == BTreeNode::INVALID_PAGE_ID) {
+BTree::BTree(BufferPoolManager* buffer_pool_manager, page_id_t root_page_id, LeafLayout leaf_layout,
+             RowFormat row_format)
+    : buffer_pool_manager_(buffer_pool_manager), root_page_id_(root_page_id), leaf_layout_(leaf_layout),
+      row_format_(std::move(row_format)) {}
+
+bool BTree::InitializeRoot(lsn_t lsn) {
+    Page* root_page = buffer_pool_manager_->FetchPage(root_page_id_);
+    if (!root_page) return false;
+
+    bool modified = lsn == INVALID_LSN || root_page->GetLSN() < lsn;
+    if (modified) {
+        LeafNodeView(root_page).Init(leaf_layout_);
+        StampPage(root_page, lsn);
+    }
+
+    buffer_pool_manager_->UnpinPage(root_page_id_, modified);
+    return true;
+}
+
+bool BTree::Insert(btree_key_t key, const Record& record, lsn_t lsn) {
+    if (root_page_id_ == INVALID_PAGE_ID) {
         root_page_id_ = CreateNewNode(true);
     }
-    
-    page_id_t leaf_page_id = FindLeafPage(key);
+    if (!row_format_.CanEncode(record)) {
+        return false;
+    }
+    if (row_format_.GetSize(record) <= MAX_INLINE_RECORD_SIZE) {
+        bool inserted = InsertInline(key, record, lsn);
+        LogSplit(lsn);
+        return inserted;
+    }
+
+    // Overflow pages are written only for a key that is going in, so that a
+    // duplicate or a replayed insert leaves none behind.
+    Record stored;
+    if (IsPresent(key, lsn)) {
+        RepairOverflow(key, record, lsn);
+        return false;
+    }
+    if (!SpillOverflow(record, stored, lsn)) {
+        return false;
+    }
+    bool inserted = InsertInline(key, stored, lsn);
+    LogSplit(lsn);
+    if (!inserted) {
+        FreeOverflow(stored);
+    }
+    return inserted;
+}
+
+bool BTree::InsertInline(btree_key_t key, const Record& record, lsn_t lsn) {
+    if (row_format_.GetSize(record) > LeafNodeView::MaxRecordSize()) {
+        return false;
+    }
+
+    std::vector<page_id_t> path;
+    page_id_t leaf_page_id = FindLeafPage(key, &path);
     Page* leaf_page = buffer_pool_manager_->FetchPage(leaf_page_id);
     if (!leaf_page) return false;
-    
-    BTreeNode leaf = DeserializeNode(leaf_page);
-    
-    if (leaf.keys.size() < BTREE_ORDER - 1) {
-        bool result = InsertIntoLeaf(leaf, key, record);
-        SerializeNode(leaf, leaf_page);
-        buffer_pool_manager_->UnpinPage(leaf_page_id, true);
-        return result;
-    } else {
-        SplitLeafNode(leaf_page_id, key, record);
+
+    LeafNodeView leaf(leaf_page);
+    int index = leaf.LowerBound(key);
+    bool applied = lsn != INVALID_LSN && leaf_page->GetLSN() >= lsn;
+    if (applied || (index < leaf.GetKeyCount() && leaf.KeyAt(index) == key)) {
+        buffer_pool_manager_->UnpinPage(leaf_page_id, false);
+        return false;
+    }
+
+    if (leaf.InsertAt(index, key, record, row_format_)) {
+        StampPage(leaf_page, lsn);
         buffer_pool_manager_->UnpinPage(leaf_page_id, true);
         return true;
     }
+
+    buffer_pool_manager_->UnpinPage(leaf_page_id, false);
+    return SplitLeafNode(leaf_page_id, key, record, path, lsn);
+}
+
+bool BTree::CanStore(const Record& record) const {
+    if (!row_format_.CanEncode(record)) {
+        return false;
+    }
+    // Spills the way SpillOverflow does, without writing any page.
+    Record stored = record;
+    while (row_format_.GetSize(stored) > MAX_INLINE_RECORD_SIZE) {
+        size_t longest = LongestInlineString(stored);
+        if (longest == stored.GetValues().size()) {
+            break;
+        }
+        const std::string& value = std::get<std::string>(stored.GetValues()[longest]);
+        stored.SetOverflow(longest, value.substr(0, OVERFLOW_PREFIX_SIZE), value.size(), INVALID_PAGE_ID);
+    }
+    return row_format_.GetSize(stored) <= LeafNodeView::MaxRecordSize();
+}
+
+bool BTree::ContainsAny(const std::vector<BTreeEntry>& entries) {
+    if (root_page_id_ == INVALID_PAGE_ID) {
+        return false;
+    }
+
+    size_t i = 0;
+    while (i < entries.size()) {
+        std::optional<btree_key_t> upper_bound;
+        page_id_t leaf_page_id = FindLeafPage(entries[i].key, nullptr, &upper_bound);
+        Page* leaf_page = buffer_pool_manager_->FetchPage(leaf_page_id);
+        if (!leaf_page) return false;
+
+        LeafNodeView leaf(leaf_page);
+        for (; i < entries.size() && (!upper_bound || entries[i].key < *upper_bound); ++i) {
+            if (leaf.Find(entries[i].key) >= 0) {
+                buffer_pool_manager_->UnpinPage(leaf_page_id, false);
+                return true;
+            }
+        }
+        buffer_pool_manager_->UnpinPage(leaf_page_id, false);
+    }
+    return false;
 }
 
-bool BTree::Search(int key, Record& record) {
-    if (root_page_id_ == BTreeNode::INVALID_PAGE_ID) {
+bool BTree::Search(btree_key_t key, Record& record) {
+    if (root_page_id_ == INVALID_PAGE_ID) {
         return false;
     }
-    
+
     page_id_t leaf_page_id = FindLeafPage(key);
     Page* leaf_page = buffer_pool_manager_->FetchPage(leaf_page_id);
     if (!leaf_page) return false;
-    
-    BTreeNode leaf = DeserializeNode(leaf_page);
-    
-    auto it = std::lower_bound(leaf.keys.begin(), leaf.keys.end(), key);
-    if (it != leaf.keys.end() && *it == key) {
-        int index = it - leaf.keys.begin();
-        record = leaf.records[index];
+
+    LeafNodeView leaf(leaf_page);
+    int index = leaf.Find(key);
+    if (index >= 0) {
+        record = leaf.RecordAt(index, row_format_);
         buffer_pool_manager_->UnpinPage(leaf_page_id, false);
+        LoadOverflow(record);
         return true;
     }
-    
+
     buffer_pool_manager_->UnpinPage(leaf_page_id, false);
     return false;
 }
 
-bool BTree::Delete(int key) {
-    if (root_page_id_ == BTreeNode::INVALID_PAGE_ID) {
+bool BTree::Delete(btree_key_t key, lsn_t lsn) {
+    if (root_page_id_ == INVALID_PAGE_ID) {
         return false;
     }
-    
+
     page_id_t leaf_page_id = FindLeafPage(key);
     Page* leaf_page = buffer_pool_manager_->FetchPage(leaf_page_id);
     if (!leaf_page) return false;
-    
-    BTreeNode leaf = DeserializeNode(leaf_page);
-    
-    auto it = std::lower_bound(leaf.keys.begin(), leaf.keys.end(), key);
-    if (it != leaf.keys.end() && *it == key) {
-        int index = it - leaf.keys.begin();
-        leaf.keys.erase(it);
-        leaf.records.erase(leaf.records.begin() + index);
-        
-        SerializeNode(leaf, leaf_page);
+
+    LeafNodeView leaf(leaf_page);
+    int index = leaf.Find(key);
+    bool applied = lsn != INVALID_LSN && leaf_page->GetLSN() >= lsn;
+    if (index >= 0 && !applied) {
+        Record removed = leaf.RecordAt(index, row_format_);
+        leaf.RemoveAt(index);
+        StampPage(leaf_page, lsn);
         buffer_pool_manager_->UnpinPage(leaf_page_id, true);
+        FreeOverflow(removed);
         return true;
     }
-    
+
     buffer_pool_manager_->UnpinPage(leaf_page_id, false);
     return false;
 }
 
-std::vector<Record> BTree::RangeScan(int start_key, int end_key) {
-    std::vector<Record> results;
-    
-    page_id_t leaf_page_id = FindLeafPage(start_key);
-    
-    while (leaf_page_id != BTreeNode::INVALID_PAGE_ID) {
+size_t BTree::InsertBatch(const std::vector<BTreeEntry>& entries, std::vector<bool>* inserted_entries) {
+    if (root_page_id_ == INVALID_PAGE_ID) {
+        root_page_id_ = CreateNewNode(true);
+    }
+    if (inserted_entries) {
+        inserted_entries->assign(entries.size(), false);
+    }
+
+    size_t inserted = 0;
+    size_t i = 0;
+    while (i < entries.size()) {
+        std::vector<page_id_t> path;
+        std::optional<btree_key_t> upper_bound;
+        page_id_t leaf_page_id = FindLeafPage(entries[i].key, &path, &upper_bound);
         Page* leaf_page = buffer_pool_manager_->FetchPage(leaf_page_id);
         if (!leaf_page) break;
-        
-        BTreeNode leaf = DeserializeNode(leaf_page);
-        
-        for (size_t i = 0; i < leaf.keys.size(); ++i) {
-            if (leaf.keys[i] >= start_key && leaf.keys[i] <= end_key) {
-                results.push_back(leaf.records[i]);
-            } else if (leaf.keys[i] > end_key) {
-                buffer_pool_manager_->UnpinPage(leaf_page_id, false);
-                return results;
+
+        LeafNodeView leaf(leaf_page);
+        bool modified = false;
+        bool needs_split = false;
+        while (i < entries.size() && (!upper_bound || entries[i].key < *upper_bound)) {
+            const BTreeEntry& entry = entries[i];
+            int index = leaf.LowerBound(entry.key);
+            bool applied = entry.lsn != INVALID_LSN && leaf_page->GetLSN() >= entry.lsn;
+            if (applied || (index < leaf.GetKeyCount() && leaf.KeyAt(index) == entry.key)) {
+                i++;
+                continue;
+            }
+            // Full leaves and records that need overflow pages go through Insert.
+            if (row_format_.GetSize(entry.record) > MAX_INLINE_RECORD_SIZE ||
+                !leaf.InsertAt(index, entry.key, entry.record, row_format_)) {
+                needs_split = true;
+                break;
             }
+            StampPage(leaf_page, entry.lsn);
+            if (inserted_entries) {
+                (*inserted_entries)[i] = true;
+            }
+            modified = true;
+            inserted++;
+            i++;
         }
-        
-        page_id_t next_page_id = leaf.next_leaf;
-        buffer_pool_manager_->UnpinPage(leaf_page_id, false);
-        leaf_page_id = next_page_id;
+        buffer_pool_manager_->UnpinPage(leaf_page_id, modified);
+
+        if (needs_split) {
+            if (Insert(entries[i].key, entries[i].record, entries[i].lsn)) {
+                if (inserted_entries) {
+                    (*inserted_entries)[i] = true;
+                }
+                inserted++;
+            }
+            i++;
+        }
+    }
+    return inserted;
+}
+
+bool BTree::BulkLoad(const std::function<bool(btree_key_t& key, Record& record)>& next, double fill_factor) {
+    Page* root_page = buffer_pool_manager_->FetchPage(root_page_id_);
+    if (!root_page) return false;
+    bool empty = BTreeNodeView(root_page).IsLeaf() && BTreeNodeView(root_page).GetKeyCount() == 0;
+    buffer_pool_manager_->UnpinPage(root_page_id_, false);
+    if (!empty) {
+        return false;
+    }
+
+    // A load that fails frees what it built and leaves the tree empty.
+    std::vector<page_id_t> pages;
+    if (BuildBulk(next, fill_factor, pages)) {
+        return true;
+    }
+    for (page_id_t page_id : pages) {
+        ReleaseNode(page_id, false);
+        buffer_pool_manager_->DeletePage(page_id);
+    }
+    InitializeRoot(INVALID_LSN);
+    return false;
+}
+
+void BTree::Truncate() {
+    ReleaseNode(root_page_id_, true);
+    InitializeRoot(INVALID_LSN);
+}
+
+bool BTree::BuildBulk(const std::function<bool(btree_key_t& key, Record& record)>& next, double fill_factor,
+                      std::vector<page_id_t>& pages) {
+    fill_factor = std::min(1.0, std::max(0.1, fill_factor));
+    size_t leaf_bytes = static_cast<size_t>(fill_factor * LeafNodeView::Capacity());
+    size_t fanout = std::max<size_t>(2, static_cast<size_t>(fill_factor * (InternalNodeView::MaxKeys() + 1)));
+
+    // (lowest key, page id) of every node on the level being built.
+    std::vector<std::pair<btree_key_t, page_id_t>> level;
+    page_id_t leaf_page_id = INVALID_PAGE_ID;
+    Page* leaf_page = nullptr;
+    btree_key_t key;
+    btree_key_t last_key = 0;
+    Record record;
+
+    while (next(key, record)) {
+        if ((leaf_page && key <= last_key) || !row_format_.CanEncode(record) ||
+            (row_format_.GetSize(record) > MAX_INLINE_RECORD_SIZE && !SpillOverflow(record, record))) {
+            if (leaf_page) {
+                buffer_pool_manager_->UnpinPage(leaf_page_id, true);
+            }
+            return false;
+        }
+
+        bool start_leaf = !leaf_page;
+        if (leaf_page) {
+            LeafNodeView leaf(leaf_page);
+            size_t used = LeafNodeView::Capacity() - leaf.FreeSpace();
+            size_t record_size = row_format_.GetSize(record);
+            start_leaf = used + LeafNodeView::EntrySize(record_size) > leaf_bytes || !leaf.HasRoomFor(record_size);
+        }
+
+        // A PAX leaf can turn out to be full only when the row is added.
+        while (true) {
+            if (start_leaf) {
+                page_id_t new_page_id;
+                Page* new_page = buffer_pool_manager_->NewPage(&new_page_id);
+                if (!new_page) {
+                    if (leaf_page) {
+                        buffer_pool_manager_->UnpinPage(leaf_page_id, true);
+                    }
+                    return false;
+                }
+                pages.push_back(new_page_id);
+                LeafNodeView(new_page).Init(leaf_layout_);
+                if (leaf_page) {
+                    LeafNodeView(leaf_page).SetNextLeaf(new_page_id);
+                    FinishBulkPage(leaf_page_id);
+                }
+                leaf_page_id = new_page_id;
+                leaf_page = new_page;
+                level.emplace_back(key, leaf_page_id);
+            }
+
+            LeafNodeView leaf(leaf_page);
+            if (leaf.InsertAt(leaf.GetKeyCount(), key, record, row_format_)) {
+                break;
+            }
+            if (leaf.GetKeyCount() == 0) {
+                buffer_pool_manager_->UnpinPage(leaf_page_id, true);
+                return false;
+            }
+            start_leaf = true;
+        }
+        last_key = key;
+    }
+
+    if (!leaf_page) {
+        return true;
+    }
+    FinishBulkPage(leaf_page_id);
+
+    int node_level = 1;
+    while (level.size() > fanout) {
+        std::vector<std::pair<btree_key_t, page_id_t>> parents;
+        size_t node_count = (level.size() + fanout - 1) / fanout;
+        size_t begin = 0;
+        for (size_t n = 0; n < node_count; ++n) {
+            size_t end = begin + (level.size() - begin) / (node_count - n);
+            page_id_t node_page_id;
+            Page* node_page = buffer_pool_manager_->NewPage(&node_page_id);
+            if (!node_page) return false;
+            pages.push_back(node_page_id);
+
+            InternalNodeView node(node_page);
+            node.Init(level[begin].second, node_level);
+            for (size_t j = begin + 1; j < end; ++j) {
+                node.InsertAt(node.GetKeyCount(), level[j].first, level[j].second);
+            }
+            parents.emplace_back(level[begin].first, node_page_id);
+            FinishBulkPage(node_page_id);
+            begin = end;
+        }
+        level = std::move(parents);
+        node_level++;
+    }
+
+    Page* root_page = buffer_pool_manager_->FetchPage(root_page_id_);
+    if (!root_page) return false;
+
+    if (level.size() == 1) {
+        // A single leaf is copied into the root, which keeps its page id.
+        Page* only_leaf = buffer_pool_manager_->FetchPage(level[0].second);
+        if (!only_leaf) {
+            buffer_pool_manager_->UnpinPage(root_page_id_, false);
+            return false;
+        }
+        std::memcpy(root_page->GetData(), only_leaf->GetData(), PAGE_SIZE);
+        buffer_pool_manager_->UnpinPage(level[0].second, false);
+        buffer_pool_manager_->DeletePage(level[0].second);
+    } else {
+        InternalNodeView root(root_page);
+        root.Init(level[0].second, node_level);
+        for (size_t j = 1; j < level.size(); ++j) {
+            root.InsertAt(root.GetKeyCount(), level[j].first, level[j].second);
+        }
+    }
+
+    FinishBulkPage(root_page_id_);
+    return true;
+}
+
+BTreeIterator BTree::Scan(btree_key_t start_key, btree_key_t end_key) {
+    if (root_page_id_ == INVALID_PAGE_ID) {
+        return BTreeIterator();
+    }
+    return BTreeIterator(this, start_key, end_key);
+}
+
+std::vector<btree_key_t> BTree::SplitRange(btree_key_t start_key, btree_key_t end_key, size_t parts) {
+    std::vector<btree_key_t> separators;
+    std::vector<page_id_t> level{root_page_id_};
+    while (!level.empty() && separators.size() + 1 < parts) {
+        std::vector<page_id_t> children;
+        for (page_id_t page_id : level) {
+            Page* page = buffer_pool_manager_->FetchPage(page_id);
+            if (!page) continue;
+
+            InternalNodeView node(page);
+            if (node.IsLeaf()) {
+                buffer_pool_manager_->UnpinPage(page_id, false);
+                break;
+            }
+            int first = node.ChildIndexFor(start_key);
+            int last = node.ChildIndexFor(end_key);
+            for (int i = first; i <= last; ++i) {
+                if (i > first) {
+                    separators.push_back(node.KeyAt(i - 1));
+                }
+                if (node.GetLevel() > 1) {
+                    children.push_back(node.ChildAt(i));
+                }
+            }
+            buffer_pool_manager_->UnpinPage(page_id, false);
+        }
+        level = std::move(children);
+    }
+
+    std::sort(separators.begin(), separators.end());
+    std::vector<btree_key_t> starts{start_key};
+    for (size_t i = 1; i < parts && !separators.empty(); ++i) {
+        btree_key_t key = separators[i * separators.size() / parts];
+        if (key > starts.back()) {
+            starts.push_back(key);
+        }
+    }
+    return starts;
+}
+
+std::vector<Record> BTree::RangeScan(btree_key_t start_key, btree_key_t end_key) {
+    std::vector<Record> results;
+    for (BTreeIterator it = Scan(start_key, end_key); !it.IsEnd(); it.Next()) {
+        results.push_back(it.GetRecord());
     }
-    
     return results;
 }
 
+// Leaves are discovered through their level-1 parents rather than the
+// sibling chain, so reads for the next few leaves can be issued before the
+// scan reaches them.
+void BTree::ReadAhead(ReadAheadWindow& window, btree_key_t end_key) {
+    if (window.exhausted) {
+        return;
+    }
+
+    page_id_t page_id = root_page_id_;
+    btree_key_t upper_bound = 0;
+    bool bounded = false;
+
+    while (page_id != INVALID_PAGE_ID) {
+        Page* page = buffer_pool_manager_->FetchPage(page_id);
+        if (!page) break;
+
+        InternalNodeView node(page);
+        if (node.IsLeaf()) {
+            buffer_pool_manager_->UnpinPage(page_id, false);
+            break;
+        }
+
+        int count = node.GetKeyCount();
+        int index = node.ChildIndexFor(window.next_key);
+        if (index < count) {
+            upper_bound = node.KeyAt(index);
+            bounded = true;
+        }
+
+        if (node.GetLevel() > 1) {
+            page_id_t child_page_id = node.ChildAt(index);
+            buffer_pool_manager_->UnpinPage(page_id, false);
+            page_id = child_page_id;
+            continue;
+        }
+
+        std::vector<page_id_t> leaves;
+        int next = index;
+        while (next <= count && window.leaves.size() < READ_AHEAD_LEAVES) {
+            if (next > 0 && node.KeyAt(next - 1) > end_key) {
+                window.exhausted = true;
+                break;
+            }
+            leaves.push_back(node.ChildAt(next));
+            window.leaves.push_back(node.ChildAt(next));
+            next++;
+        }
+
+        if (next <= count) {
+            window.next_key = node.KeyAt(next - 1);
+        } else if (bounded) {
+            window.next_key = upper_bound;
+        } else {
+            window.exhausted = true;
+        }
+
+        buffer_pool_manager_->UnpinPage(page_id, false);
+        buffer_pool_manager_->Prefetch(leaves);
+        return;
+    }
+
+    window.exhausted = true;
+}
+
 page_id_t BTree::CreateNewNode(bool is_leaf) {
     page_id_t new_page_id;
     Page* new_page = buffer_pool_manager_->NewPage(&new_page_id);
-    if (!new_page) return BTreeNode::INVALID_PAGE_ID;
-    
-    BTreeNode node;
-    node.is_leaf = is_leaf;
-    SerializeNode(node, new_page);
-    
+    if (!new_page) return INVALID_PAGE_ID;
+
+    if (is_leaf) {
+        LeafNodeView(new_page).Init(leaf_layout_);
+    } else {
+        InternalNodeView(new_page).Init(INVALID_PAGE_ID, 1);
+    }
+
     buffer_pool_manager_->UnpinPage(new_page_id, true);
     return new_page_id;
 }
 
-page_id_t BTree::FindLeafPage(int key) {
+bool BTree::IsApplied(btree_key_t key, lsn_t lsn) {
+    if (root_page_id_ == INVALID_PAGE_ID || lsn == INVALID_LSN) {
+        return false;
+    }
+
+    page_id_t leaf_page_id = FindLeafPage(key);
+    Page* leaf_page = buffer_pool_manager_->FetchPage(leaf_page_id);
+    if (!leaf_page) return false;
+
+    bool applied = leaf_page->GetLSN() >= lsn;
+    buffer_pool_manager_->UnpinPage(leaf_page_id, false);
+    return applied;
+}
+
+// Whether key is in the tree, or its leaf is already at or past lsn.
+bool BTree::IsPresent(btree_key_t key, lsn_t lsn) {
+    page_id_t leaf_page_id = FindLeafPage(key);
+    Page* leaf_page = buffer_pool_manager_->FetchPage(leaf_page_id);
+    if (!leaf_page) return false;
+
+    bool present = (lsn != INVALID_LSN && leaf_page->GetLSN() >= lsn) || LeafNodeView(leaf_page).Find(key) >= 0;
+    buffer_pool_manager_->UnpinPage(leaf_page_id, false);
+    return present;
+}
+
+// Moves the longest strings of record to overflow pages, one at a time, until
+// it fits MAX_INLINE_RECORD_SIZE or no string is worth moving. Fails if the
+// pages cannot be written or the record still does not fit in a leaf.
+bool BTree::SpillOverflow(const Record& record, Record& stored, lsn_t lsn) {
+    if (&stored != &record) {
+        stored = record;
+    }
+    while (row_format_.GetSize(stored) > MAX_INLINE_RECORD_SIZE) {
+        size_t longest = LongestInlineString(stored);
+        if (longest == stored.GetValues().size()) {
+            break;
+        }
+
+        const std::string& value = std::get<std::string>(stored.GetValues()[longest]);
+        page_id_t page_id;
+        if (!OverflowChain::Write(buffer_pool_manager_, std::string_view(value).substr(OVERFLOW_PREFIX_SIZE),
+                                  page_id, lsn)) {
+            FreeOverflow(stored);
+            return false;
+        }
+        stored.SetOverflow(longest, value.substr(0, OVERFLOW_PREFIX_SIZE), value.size(), page_id);
+    }
+
+    if (row_format_.GetSize(stored) > LeafNodeView::MaxRecordSize()) {
+        FreeOverflow(stored);
+        return false;
+    }
+    return true;
+}
+
+// The longest string of record that is still inline and worth moving to
+// overflow pages, or the value count if there is none.
+size_t BTree::LongestInlineString(const Record& record) {
+    const auto& values = record.GetValues();
+    size_t longest = values.size();
+    size_t longest_length = OVERFLOW_PREFIX_SIZE + OverflowRef::HEADER_SIZE;
+    for (size_t i = 0; i < values.size(); ++i) {
+        const std::string* value = std::get_if<std::string>(&values[i]);
+        bool overflowed = std::any_of(record.GetOverflow().begin(), record.GetOverflow().end(),
+                                      [i](const Record::Overflow& overflow) { return overflow.index == i; });
+        if (value && !overflowed && value->size() > longest_length) {
+            longest = i;
+            longest_length = value->size();
+        }
+    }
+    return longest;
+}
+
+// Replaying a row whose leaf reached the disk: the overflow pages it refers
+// to may not have, and are written again from the logged row.
+void BTree::RepairOverflow(btree_key_t key, const Record& record, lsn_t lsn) {
+    if (lsn == INVALID_LSN) {
+        return;
+    }
+    page_id_t leaf_page_id = FindLeafPage(key);
+    Page* leaf_page = buffer_pool_manager_->FetchPage(leaf_page_id);
+    if (!leaf_page) return;
+
+    LeafNodeView leaf(leaf_page);
+    int index = leaf.Find(key);
+    Record stored;
+    if (index >= 0 && leaf_page->GetLSN() >= lsn) {
+        stored = leaf.RecordAt(index, row_format_);
+    }
+    buffer_pool_manager_->UnpinPage(leaf_page_id, false);
+
+    for (const auto& overflow : stored.GetOverflow()) {
+        const std::string* value = std::get_if<std::string>(&record.GetValues()[overflow.index]);
+        if (value && value->size() == overflow.length) {
+            size_t prefix_size = std::get<std::string>(stored.GetValue(overflow.index)).size();
+            OverflowChain::Repair(buffer_pool_manager_, std::string_view(*value).substr(prefix_size), overflow.page,
+                                  lsn);
+        }
+    }
+}
+
+void BTree::LoadOverflow(Record& record) {
+    std::vector<Record::Overflow> overflows = record.GetOverflow();
+    for (const auto& overflow : overflows) {
+        std::string value = std::get<std::string>(record.GetValue(overflow.index));
+        OverflowChain::Read(buffer_pool_manager_, overflow.page, overflow.length - value.size(), value);
+        record.SetValue(overflow.index, std::move(value));
+    }
+}
+
+void BTree::FreeOverflow(const Record& record) {
+    for (const auto& overflow : record.GetOverflow()) {
+        OverflowChain::Free(buffer_pool_manager_, overflow.page);
+    }
+}
+
+// upper_bound receives the exclusive upper fence of the leaf; it is left
+// empty for the rightmost leaf.
+page_id_t BTree::FindLeafPage(btree_key_t key, std::vector<page_id_t>* path,
+                              std::optional<btree_key_t>* upper_bound) {
     page_id_t current_page_id = root_page_id_;
-    
-    while (current_page_id != BTreeNode::INVALID_PAGE_ID) {
+    if (upper_bound) {
+        upper_bound->reset();
+    }
+
+    while (current_page_id != INVALID_PAGE_ID) {
         Page* page = buffer_pool_manager_->FetchPage(current_page_id);
-        if (!page) return BTreeNode::INVALID_PAGE_ID;
-        
-        BTreeNode node = DeserializeNode(page);
-        
-        if (node.is_leaf) {
+        if (!page) return INVALID_PAGE_ID;
+
+        if (BTreeNodeView(page).IsLeaf()) {
             buffer_pool_manager_->UnpinPage(current_page_id, false);
             return current_page_id;
         }
-        
-        int index = FindKeyIndex(node.keys, key);
-        page_id_t next_page_id = node.children[index];
+
+        InternalNodeView node(page);
+        int index = node.ChildIndexFor(key);
+        if (upper_bound && index < node.GetKeyCount()) {
+            *upper_bound = node.KeyAt(index);
+        }
+        page_id_t next_page_id = node.ChildAt(index);
         buffer_pool_manager_->UnpinPage(current_page_id, false);
+        if (path) {
+            path->push_back(current_page_id);
+        }
         current_page_id = next_page_id;
     }
-    
-    return BTreeNode::INVALID_PAGE_ID;
+
+    return INVALID_PAGE_ID;
 }
 
-bool BTree::InsertIntoLeaf(BTreeNode& leaf, int key, const Record& record) {
-    auto it = std::lower_bound(leaf.keys.begin(), leaf.keys.end(), key);
-    if (it != leaf.keys.end() && *it == key) {
-        return false;
+// Picks the split point of a full leaf with a new record going in at index:
+// entries from the returned position on, counting the new record, move to the
+// new leaf. Row leaves split where the two halves come closest to the same
+// number of bytes; fits is false if no split point has room for the record.
+// PAX rows are not sized one by one, so PAX leaves split at the middle row.
+int BTree::ChooseLeafSplit(const LeafNodeView& leaf, int index, size_t record_size, bool& fits) {
+    int count = leaf.GetKeyCount();
+    fits = true;
+    if (leaf.IsColumnar()) {
+        return (count + 1) / 2;
     }
-    
-    int index = it - leaf.keys.begin();
-    leaf.keys.insert(it, key);
-    leaf.records.insert(leaf.records.begin() + index, record);
-    return true;
-}
 
-bool BTree::InsertIntoInternal(BTreeNode& internal, int key, page_id_t child_page_id) {
-    auto it = std::upper_bound(internal.keys.begin(), internal.keys.end(), key);
-    int index = it - internal.keys.begin();
-    
-    internal.keys.insert(it, key);
-    internal.children.insert(internal.children.begin() + index + 1, child_page_id);
-    return true;
+    auto entry_size = [&](int i) {
+        if (i == index) {
+            return LeafNodeView::EntrySize(record_size);
+        }
+        return leaf.EntrySizeAt(i < index ? i : i - 1);
+    };
+    size_t total = 0;
+    for (int i = 0; i <= count; ++i) {
+        total += entry_size(i);
+    }
+
+    int best = -1;
+    size_t best_difference = SIZE_MAX;
+    size_t left = 0;
+    for (int mid = 1; mid <= count; ++mid) {
+        left += entry_size(mid - 1);
+        size_t right = total - left;
+        size_t difference = left > right ? left - right : right - left;
+        if (left <= LeafNodeView::Capacity() && right <= LeafNodeView::Capacity() && difference < best_difference) {
+            best = mid;
+            best_difference = difference;
+        }
+    }
+    fits = best >= 0;
+    return best;
 }
 
-void BTree::SplitLeafNode(page_id_t leaf_page_id, int key, const Record& record) {
-    Page* leaf_page = buffer_pool_manager_->FetchPage(leaf_page_id);
-    BTreeNode leaf = DeserializeNode(leaf_page);
-    
+bool BTree::SplitLeafNode(page_id_t leaf_page_id, btree_key_t key, const Record& record,
+                          std::vector<page_id_t>& path, lsn_t lsn) {
     page_id_t new_leaf_page_id = CreateNewNode(true);
+    if (new_leaf_page_id == INVALID_PAGE_ID) return false;
+
+    Page* leaf_page = buffer_pool_manager_->FetchPage(leaf_page_id);
     Page* new_leaf_page = buffer_pool_manager_->FetchPage(new_leaf_page_id);
-    BTreeNode new_leaf = DeserializeNode(new_leaf_page);
-    
-    std::vector<int> all_keys = leaf.keys;
-    std::vector<Record> all_records = leaf.records;
-    
-    auto it = std::lower_bound(all_keys.begin(), all_keys.end(), key);
-    int index = it - all_keys.begin();
-    all_keys.insert(it, key);
-    all_records.insert(all_records.begin() + index, record);
-    
-    int mid = all_keys.size() / 2;
-    
-    leaf.keys.assign(all_keys.begin(), all_keys.begin() + mid);
-    leaf.records.assign(all_records.begin(), all_records.begin() + mid);
-    
-    new_leaf.keys.assign(all_keys.begin() + mid, all_keys.end());
-    new_leaf.records.assign(all_records.begin() + mid, all_records.end());
-    new_leaf.next_leaf = leaf.next_leaf;
-    leaf.next_leaf = new_leaf_page_id;
-    
-    SerializeNode(leaf, leaf_page);
-    SerializeNode(new_leaf, new_leaf_page);
-    
-    buffer_pool_manager_->UnpinPage(new_leaf_page_id, true);
-}
+    if (!leaf_page || !new_leaf_page) return false;
 
-void BTree::SplitInternalNode(page_id_t internal_page_id, int key, page_id_t child_page_id) {
-    Page* internal_page = buffer_pool_manager_->FetchPage(internal_page_id);
-    BTreeNode internal = DeserializeNode(internal_page);
-    
-    page_id_t new_internal_page_id = CreateNewNode(false);
-    Page* new_internal_page = buffer_pool_manager_->FetchPage(new_internal_page_id);
-    BTreeNode new_internal = DeserializeNode(new_internal_page);
-    
-    std::vector<int> all_keys = internal.keys;
-    std::vector<page_id_t> all_children = internal.children;
-    
-    auto it = std::upper_bound(all_keys.begin(), all_keys.end(), key);
-    int key_index = it - all_keys.begin();
-    all_keys.insert(it, key);
-    all_children.insert(all_children.begin() + key_index + 1, child_page_id);
-    
-    int mid = all_keys.size() / 2;
-    int promote_key = all_keys[mid];
-    
-    internal.keys.assign(all_keys.begin(), all_keys.begin() + mid);
-    internal.children.assign(all_children.begin(), all_children.begin() + mid + 1);
-    
-    new_internal.keys.assign(all_keys.begin() + mid + 1, all_keys.end());
-    new_internal.children.assign(all_children.begin() + mid + 1, all_children.end());
-    
-    SerializeNode(internal, internal_page);
-    SerializeNode(new_internal, new_internal_page);
-    
-    buffer_pool_manager_->UnpinPage(new_internal_page_id, true);
-    
-    if (internal_page_id == root_page_id_) {
-        page_id_t new_root_id = CreateNewNode(false);
-        Page* new_root_page = buffer_pool_manager_->FetchPage(new_root_id);
-        BTreeNode new_root = DeserializeNode(new_root_page);
-        
-        new_root.keys.push_back(promote_key);
-        new_root.children.push_back(internal_page_id);
-        new_root.children.push_back(new_internal_page_id);
-        
-        SerializeNode(new_root, new_root_page);
-        buffer_pool_manager_->UnpinPage(new_root_id, true);
-        root_page_id_ = new_root_id;
+    LeafNodeView leaf(leaf_page);
+    LeafNodeView new_leaf(new_leaf_page);
+
+    int index = leaf.LowerBound(key);
+    bool fits;
+    int mid = ChooseLeafSplit(leaf, index, row_format_.GetSize(record), fits);
+
+    bool inserted = false;
+    if (!fits) {
+        // The record is too large to share a page with the entries on either
+        // side of it: those are split apart first, and the insert is retried
+        // into a leaf where it is the first or the last entry.
+        leaf.MoveTailTo(new_leaf, index);
+    } else if (index < mid) {
+        leaf.MoveTailTo(new_leaf, mid - 1);
+        inserted = leaf.InsertAt(index, key, record, row_format_);
+    } else {
+        leaf.MoveTailTo(new_leaf, mid);
+        inserted = new_leaf.InsertAt(index - mid, key, record, row_format_);
     }
+
+    new_leaf.SetNextLeaf(leaf.GetNextLeaf());
+    leaf.SetNextLeaf(new_leaf_page_id);
+    btree_key_t separator = new_leaf.KeyAt(0);
+    if (fits) {
+        StampPage(leaf_page, lsn);
+        StampPage(new_leaf_page, lsn);
+    }
+
+    split_pages_.push_back(new_leaf_page);
+    split_pages_.push_back(leaf_page);
+
+    InsertIntoParent(path, leaf_page_id, separator, new_leaf_page_id, lsn);
+    return fits ? inserted : InsertInline(key, record, lsn);
 }
 
-int BTree::FindKeyIndex(const std::vector<int>& keys, int key) {
-    auto it = std::upper_bound(keys.begin(), keys.end(), key);
-    return it - keys.begin();
+void BTree::InsertIntoParent(std::vector<page_id_t>& path, page_id_t left_page_id, btree_key_t key,
+                             page_id_t right_page_id, lsn_t lsn) {
+    if (path.empty()) {
+        // The root keeps its page id so that the catalog never has to follow
+        // a root split: its contents move to a new left child instead.
+        page_id_t moved_page_id;
+        Page* moved_page = buffer_pool_manager_->NewPage(&moved_page_id);
+        if (!moved_page) return;
+        Page* root_page = buffer_pool_manager_->FetchPage(left_page_id);
+        if (!root_page) {
+            buffer_pool_manager_->UnpinPage(moved_page_id, false);
+            return;
+        }
+
+        std::memcpy(moved_page->GetData(), root_page->GetData(), PAGE_SIZE);
+        InternalNodeView root(root_page);
+        root.Init(moved_page_id, root.GetLevel() + 1);
+        root.InsertAt(0, key, right_page_id);
+        StampPage(moved_page, lsn);
+        StampPage(root_page, lsn);
+
+        split_pages_.push_back(root_page);
+        split_pages_.push_back(moved_page);
+        return;
+    }
+
+    page_id_t parent_page_id = path.back();
+    path.pop_back();
+
+    Page* parent_page = buffer_pool_manager_->FetchPage(parent_page_id);
+    if (!parent_page) return;
+
+    InternalNodeView parent(parent_page);
+    int index = parent.ChildIndexFor(key);
+    if (!parent.IsFull()) {
+        parent.InsertAt(index, key, right_page_id);
+        StampPage(parent_page, lsn);
+        split_pages_.push_back(parent_page);
+        return;
+    }
+
+    page_id_t sibling_page_id = CreateNewNode(false);
+    Page* sibling_page = buffer_pool_manager_->FetchPage(sibling_page_id);
+    if (!sibling_page) {
+        buffer_pool_manager_->UnpinPage(parent_page_id, false);
+        return;
+    }
+
+    InternalNodeView sibling(sibling_page);
+    btree_key_t promote_key = parent.SplitInto(sibling, index, key, right_page_id);
+    StampPage(parent_page, lsn);
+    StampPage(sibling_page, lsn);
+
+    split_pages_.push_back(sibling_page);
+    split_pages_.push_back(parent_page);
+
+    InsertIntoParent(path, parent_page_id, promote_key, sibling_page_id, lsn);
 }
 
-void BTree::SerializeNode(const BTreeNode& node, Page* page) {
-    char* data = page->GetData();
-    size_t offset = 0;
-    
-    std::memcpy(data + offset, &node.is_leaf, sizeof(node.is_leaf));
-    offset += sizeof(node.is_leaf);
-    
-    size_t key_count = node.keys.size();
-    std::memcpy(data + offset, &key_count, sizeof(key_count));
-    offset += sizeof(key_count);
-    
-    for (int key : node.keys) {
-        std::memcpy(data + offset, &key, sizeof(key));
-        offset += sizeof(key);
-    }
-    
-    if (!node.is_leaf) {
-        for (page_id_t child : node.children) {
-            std::memcpy(data + offset, &child, sizeof(child));
-            offset += sizeof(child);
+// Frees the overflow chains of the rows of a leaf or, with subtree, every
+// node below an internal node and their chains. The node itself is kept.
+void BTree::ReleaseNode(page_id_t page_id, bool subtree) {
+    Page* page = buffer_pool_manager_->FetchPage(page_id);
+    if (!page) return;
+
+    std::vector<Record> overflowed;
+    std::vector<page_id_t> children;
+    if (BTreeNodeView(page).IsLeaf()) {
+        LeafNodeView leaf(page);
+        for (int i = 0; i < leaf.GetKeyCount(); ++i) {
+            Record record = leaf.RecordAt(i, row_format_);
+            if (!record.GetOverflow().empty()) {
+                overflowed.push_back(std::move(record));
+            }
         }
-    } else {
-        for (const auto& record : node.records) {
-            record.Serialize(data + offset);
-            offset += record.GetSize();
+    } else if (subtree) {
+        InternalNodeView node(page);
+        for (int i = 0; i <= node.GetKeyCount(); ++i) {
+            children.push_back(node.ChildAt(i));
         }
-        std::memcpy(data + offset, &node.next_leaf, sizeof(node.next_leaf));
+    }
+    buffer_pool_manager_->UnpinPage(page_id, false);
+
+    for (const auto& record : overflowed) {
+        FreeOverflow(record);
+    }
+    for (page_id_t child : children) {
+        ReleaseNode(child, true);
+        buffer_pool_manager_->DeletePage(child);
     }
 }
 
-BTreeNode BTree::DeserializeNode(Page* page) {
-    BTreeNode node;
-    const char* data = page->GetData();
-    size_t offset = 0;
-    
-    std::memcpy(&node.is_leaf, data + offset, sizeof(node.is_leaf));
-    offset += sizeof(node.is_leaf);
-    
-    size_t key_count;
-    std::memcpy(&key_count, data + offset, sizeof(key_count));
-    offset += sizeof(key_count);
-    
-    node.keys.resize(key_count);
-    for (size_t i = 0; i < key_count; ++i) {
-        std::memcpy(&node.keys[i], data + offset, sizeof(int));
-        offset += sizeof(int);
-    }
-    
-    if (!node.is_leaf) {
-        node.children.resize(key_count + 1);
-        for (size_t i = 0; i < key_count + 1; ++i) {
-            std::memcpy(&node.children[i], data + offset, sizeof(page_id_t));
-            offset += sizeof(page_id_t);
-        }
-    } else {
-        node.records.reserve(key_count);
-        for (size_t i = 0; i < key_count; ++i) {
-            node.records.push_back(Record::Deserialize(data, offset));
+void BTree::FinishBulkPage(page_id_t page_id) {
+    buffer_pool_manager_->UnpinPage(page_id, true);
+    buffer_pool_manager_->FlushPage(page_id);
+}
+
+// Redo cannot tell a page that reached the disk without the rest of its
+// split from one that is up to date, so the pages a split changes stay
+// pinned until the insert is done and are then logged whole, at the LSN of
+// the insert. None of them is written back before that record is durable.
+void BTree::LogSplit(lsn_t lsn) {
+    if (split_pages_.empty()) {
+        return;
+    }
+    if (lsn != INVALID_LSN) {
+        std::vector<page_id_t> page_ids;
+        for (Page* page : split_pages_) {
+            StampPage(page, lsn);
+            page_ids.push_back(page->GetPageId());
         }
-        std::memcpy(&node.next_leaf, data + offset, sizeof(node.next_leaf));
+        std::sort(page_ids.begin(), page_ids.end());
+        page_ids.erase(std::unique(page_ids.begin(), page_ids.end()), page_ids.end());
+        buffer_pool_manager_->LogPageImages(page_ids);
+    }
+    for (Page* page : split_pages_) {
+        buffer_pool_manager_->UnpinPage(page->GetPageId(), true);
+    }
+    split_pages_.clear();
+}
+
+void BTree::StampPage(Page* page, lsn_t lsn) {
+    if (lsn != INVALID_LSN) {
+        page->SetLSN(lsn);
     }
-    
-    return node;
 }
\ No newline at end of file
@@ -1,48 +1,109 @@
 #pragma once
 #include "page.h"
+#include "btree_page.h"
+#include "btree_iterator.h"
 #include "buffer_pool_manager.h"
+#include "overflow_chain.h"
 #include "record.h"
 #include <vector>
 #include <memory>
+#include <functional>
+#include <optional>
 
-constexpr int BTREE_ORDER = 4;
+constexpr size_t READ_AHEAD_LEAVES = 16;
+constexpr double DEFAULT_FILL_FACTOR = 0.9;
+// Records larger than this keep their longest strings in overflow pages, all
+// but the first OVERFLOW_PREFIX_SIZE bytes, so that leaves stay dense.
+constexpr size_t MAX_INLINE_RECORD_SIZE = 512;
+constexpr size_t OVERFLOW_PREFIX_SIZE = 32;
 
-struct BTreeNode {
-    bool is_leaf{false};
-    std::vector<int> keys;
-    std::vector<page_id_t> children;
-    std::vector<Record> records;
-    page_id_t next_leaf{INVALID_PAGE_ID};
-    
-    static constexpr page_id_t INVALID_PAGE_ID = static_cast<page_id_t>(-1);
+struct BTreeEntry {
+    btree_key_t key;
+    Record record;
+    lsn_t lsn;
 };
 
 class BTree {
 public:
-    explicit BTree(BufferPoolManager* buffer_pool_manager);
+    explicit BTree(BufferPoolManager* buffer_pool_manager, LeafLayout leaf_layout = LeafLayout::ROW,
+                   RowFormat row_format = RowFormat());
+    BTree(BufferPoolManager* buffer_pool_manager, page_id_t root_page_id, LeafLayout leaf_layout = LeafLayout::ROW,
+          RowFormat row_format = RowFormat());
     ~BTree() = default;
 
-    bool Insert(int key, const Record& record);
-    bool Search(int key, Record& record);
-    bool Delete(int key);
-    
-    std::vector<Record> RangeScan(int start_key, int end_key);
+    page_id_t GetRootPageId() const { return root_page_id_; }
+    LeafLayout GetLeafLayout() const { return leaf_layout_; }
+    const RowFormat& GetRowFormat() const { return row_format_; }
+    bool InitializeRoot(lsn_t lsn);
+
+    // A valid lsn stamps every modified page; leaves already at or past lsn
+    // are left untouched so that replaying the log is idempotent.
+    bool Insert(btree_key_t key, const Record& record, lsn_t lsn = INVALID_LSN);
+    bool Search(btree_key_t key, Record& record);
+    bool Delete(btree_key_t key, lsn_t lsn = INVALID_LSN);
+    // Whether the leaf key belongs in is already at or past lsn.
+    bool IsApplied(btree_key_t key, lsn_t lsn);
+
+    // Inserts entries sorted by key, filling each leaf reached by one descent
+    // before descending again. Returns the number of entries inserted, and
+    // flags which ones in inserted_entries if given.
+    size_t InsertBatch(const std::vector<BTreeEntry>& entries, std::vector<bool>* inserted_entries = nullptr);
+
+    // Whether Insert can store record: it matches the row format and fits a
+    // leaf once its long strings are moved to overflow pages.
+    bool CanStore(const Record& record) const;
+    // Whether any key of entries, sorted by key, is in the tree.
+    bool ContainsAny(const std::vector<BTreeEntry>& entries);
+
+    // Builds the tree bottom-up from a stream of strictly increasing keys.
+    // Nodes are packed to fill_factor and written out in allocation order;
+    // the root is written last. The tree must be empty.
+    bool BulkLoad(const std::function<bool(btree_key_t& key, Record& record)>& next,
+                  double fill_factor = DEFAULT_FILL_FACTOR);
+    // Frees every node but the root, and every overflow chain, leaving the
+    // root an empty leaf. Nothing is logged.
+    void Truncate();
+
+    BTreeIterator Scan(btree_key_t start_key, btree_key_t end_key);
+    // Splits [start_key, end_key] into at most parts ranges of whole subtrees
+    // at separator keys of the internal nodes, descending only as far as it
+    // takes to find enough of them. Returns the first key of each range.
+    std::vector<btree_key_t> SplitRange(btree_key_t start_key, btree_key_t end_key, size_t parts);
+    std::vector<Record> RangeScan(btree_key_t start_key, btree_key_t end_key);
 
 private:
+    friend class BTreeIterator;
+
     BufferPoolManager* buffer_pool_manager_;
-    page_id_t root_page_id_{BTreeNode::INVALID_PAGE_ID};
+    page_id_t root_page_id_{INVALID_PAGE_ID};
+    LeafLayout leaf_layout_;
+    RowFormat row_format_;
+    std::vector<Page*> split_pages_;  // changed by a split, pinned until LogSplit
 
-    BTreeNode* GetNode(page_id_t page_id);
-    void SerializeNode(const BTreeNode& node, Page* page);
-    BTreeNode DeserializeNode(Page* page);
-    
     page_id_t CreateNewNode(bool is_leaf);
-    bool InsertIntoLeaf(BTreeNode& leaf, int key, const Record& record);
-    bool InsertIntoInternal(BTreeNode& internal, int key, page_id_t child_page_id);
-    
-    void SplitLeafNode(page_id_t leaf_page_id, int key, const Record& record);
-    void SplitInternalNode(page_id_t internal_page_id, int key, page_id_t child_page_id);
-    
-    page_id_t FindLeafPage(int key);
-    int FindKeyIndex(const std::vector<int>& keys, int key);
+
+    bool InsertInline(btree_key_t key, const Record& record, lsn_t lsn);
+    bool IsPresent(btree_key_t key, lsn_t lsn);
+    bool SpillOverflow(const Record& record, Record& stored, lsn_t lsn = INVALID_LSN);
+    void RepairOverflow(btree_key_t key, const Record& record, lsn_t lsn);
+    static size_t LongestInlineString(const Record& record);
+    void LoadOverflow(Record& record);
+    void FreeOverflow(const Record& record);
+
+    static int ChooseLeafSplit(const LeafNodeView& leaf, int index, size_t record_size, bool& fits);
+    bool SplitLeafNode(page_id_t leaf_page_id, btree_key_t key, const Record& record,
+                       std::vector<page_id_t>& path, lsn_t lsn);
+    void InsertIntoParent(std::vector<page_id_t>& path, page_id_t left_page_id, btree_key_t key,
+                          page_id_t right_page_id, lsn_t lsn);
+    void LogSplit(lsn_t lsn);
+    void StampPage(Page* page, lsn_t lsn);
+    void ReadAhead(ReadAheadWindow& window, btree_key_t end_key);
+
+    bool BuildBulk(const std::function<bool(btree_key_t& key, Record& record)>& next, double fill_factor,
+                   std::vector<page_id_t>& pages);
+    void ReleaseNode(page_id_t page_id, bool subtree);
+    void FinishBulkPage(page_id_t page_id);
+
+    page_id_t FindLeafPage(btree_key_t key, std::vector<page_id_t>* path = nullptr,
+                           std::optional<btree_key_t>* upper_bound = nullptr);
 };
\ No newline at end of file
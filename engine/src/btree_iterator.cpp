@@ -0,0 +1,142 @@
+#include "btree_iterator.h"
+#include "btree.h"
+#include <utility>
+
+BTreeIterator::BTreeIterator(BTree* tree, btree_key_t start_key, btree_key_t end_key)
+    : tree_(tree), buffer_pool_manager_(tree->buffer_pool_manager_), end_key_(end_key),
+      window_{{}, start_key, false} {
+    if (start_key <= end_key) {
+        Seek(start_key);
+    }
+}
+
+BTreeIterator::~BTreeIterator() {
+    Release();
+}
+
+BTreeIterator::BTreeIterator(BTreeIterator&& other) noexcept {
+    *this = std::move(other);
+}
+
+BTreeIterator& BTreeIterator::operator=(BTreeIterator&& other) noexcept {
+    if (this != &other) {
+        Release();
+        tree_ = other.tree_;
+        buffer_pool_manager_ = other.buffer_pool_manager_;
+        page_ = std::exchange(other.page_, nullptr);
+        page_id_ = std::exchange(other.page_id_, INVALID_PAGE_ID);
+        index_ = other.index_;
+        key_ = other.key_;
+        end_key_ = other.end_key_;
+        window_ = std::move(other.window_);
+    }
+    return *this;
+}
+
+Record BTreeIterator::GetRecord() const {
+    Record record = LeafNodeView(page_).RecordAt(index_, tree_->GetRowFormat());
+    tree_->LoadOverflow(record);
+    return record;
+}
+
+const RowFormat& BTreeIterator::GetRowFormat() const {
+    return tree_->GetRowFormat();
+}
+
+const char* BTreeIterator::GetRecordData() const {
+    return LeafNodeView(page_).RecordDataAt(index_);
+}
+
+int BTreeIterator::GetRunLength() const {
+    return LeafNodeView(page_).UpperBound(end_key_) - index_;
+}
+
+void BTreeIterator::Advance(int count) {
+    index_ += count;
+    Settle();
+}
+
+// The pinned leaf may have been modified since the last call, so the
+// position is recovered from the last key rather than trusted by index.
+void BTreeIterator::Next() {
+    if (IsEnd()) {
+        return;
+    }
+
+    LeafNodeView leaf(page_);
+    if (!leaf.IsLeaf()) {
+        // The leaf was the root and has since been split in place.
+        Release();
+        if (key_ < end_key_) {
+            Seek(key_ + 1);
+        }
+        return;
+    }
+
+    if (index_ < leaf.GetKeyCount() && leaf.KeyAt(index_) == key_) {
+        index_++;
+    } else {
+        index_ = leaf.UpperBound(key_);
+    }
+    Settle();
+}
+
+void BTreeIterator::Seek(btree_key_t key) {
+    window_.leaves.clear();
+    window_.next_key = key;
+    window_.exhausted = false;
+
+    if (!FetchLeaf(tree_->FindLeafPage(key))) {
+        return;
+    }
+    index_ = LeafNodeView(page_).LowerBound(key);
+    Settle();
+}
+
+bool BTreeIterator::FetchLeaf(page_id_t page_id) {
+    if (page_id == INVALID_PAGE_ID) {
+        return false;
+    }
+
+    if (window_.leaves.size() < READ_AHEAD_LEAVES / 2) {
+        tree_->ReadAhead(window_, end_key_);
+    }
+    if (!window_.leaves.empty() && window_.leaves.front() == page_id) {
+        window_.leaves.pop_front();
+    }
+
+    page_ = buffer_pool_manager_->FetchPage(page_id);
+    if (!page_) {
+        return false;
+    }
+    page_id_ = page_id;
+    return true;
+}
+
+void BTreeIterator::Settle() {
+    while (page_) {
+        LeafNodeView leaf(page_);
+        if (index_ < leaf.GetKeyCount()) {
+            key_ = leaf.KeyAt(index_);
+            if (key_ > end_key_) {
+                Release();
+            }
+            return;
+        }
+
+        page_id_t next_page_id = leaf.GetNextLeaf();
+        Release();
+        if (!FetchLeaf(next_page_id)) {
+            return;
+        }
+        index_ = 0;
+    }
+}
+
+void BTreeIterator::Release() {
+    if (page_) {
+        buffer_pool_manager_->UnpinPage(page_id_, false);
+        page_ = nullptr;
+        page_id_ = INVALID_PAGE_ID;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,65 @@
+#pragma once
+#include "page.h"
+#include "btree_page.h"
+#include "buffer_pool_manager.h"
+#include "record.h"
+#include <deque>
+
+class BTree;
+
+// Leaves queued for prefetching ahead of a scan, discovered through their
+// level-1 parents. next_key is the lower bound of the first leaf not queued.
+struct ReadAheadWindow {
+    std::deque<page_id_t> leaves;
+    btree_key_t next_key;
+    bool exhausted;
+};
+
+// Forward iterator over the keys in [start_key, end_key]. At most one leaf is
+// pinned at a time; it is released when the iterator reaches the end or is
+// destroyed.
+class BTreeIterator {
+public:
+    BTreeIterator() = default;
+    BTreeIterator(BTree* tree, btree_key_t start_key, btree_key_t end_key);
+    ~BTreeIterator();
+
+    BTreeIterator(BTreeIterator&& other) noexcept;
+    BTreeIterator& operator=(BTreeIterator&& other) noexcept;
+    BTreeIterator(const BTreeIterator&) = delete;
+    BTreeIterator& operator=(const BTreeIterator&) = delete;
+
+    bool IsEnd() const { return page_ == nullptr; }
+    btree_key_t GetKey() const { return key_; }
+    // The record at the current position, with any overflowed strings read
+    // back in full.
+    Record GetRecord() const;
+    // Encoded record at the current position, valid until Next().
+    const char* GetRecordData() const;
+    const RowFormat& GetRowFormat() const;
+    void Next();
+
+    // Leaf-at-a-time access for scans that decode a run of entries at once:
+    // the pinned leaf, the current position in it, and the number of entries
+    // from there on that are still in range. Advance moves past count of them.
+    LeafNodeView GetLeaf() const { return LeafNodeView(page_); }
+    BufferPoolManager* GetBufferPoolManager() const { return buffer_pool_manager_; }
+    int GetIndex() const { return index_; }
+    int GetRunLength() const;
+    void Advance(int count);
+
+private:
+    BTree* tree_{nullptr};
+    BufferPoolManager* buffer_pool_manager_{nullptr};
+    Page* page_{nullptr};
+    page_id_t page_id_{INVALID_PAGE_ID};
+    int index_{0};
+    btree_key_t key_{0};
+    btree_key_t end_key_{0};
+    ReadAheadWindow window_{{}, 0, true};
+
+    void Seek(btree_key_t key);
+    bool FetchLeaf(page_id_t page_id);
+    void Settle();
+    void Release();
+};
\ No newline at end of file
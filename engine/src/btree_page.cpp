@@ -0,0 +1,357 @@
+#include "btree_page.h"
+#include "pax_leaf.h"
+#include <cstring>
+#include <vector>
+
+btree_key_t BTreeNodeView::KeyAt(int index) const {
+    btree_key_t key;
+    std::memcpy(&key, SlotPtr(index), sizeof(key));
+    return key;
+}
+
+int BTreeNodeView::LowerBound(btree_key_t key) const {
+    int lo = 0;
+    int hi = GetKeyCount();
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (KeyAt(mid) < key) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+int BTreeNodeView::UpperBound(btree_key_t key) const {
+    int lo = 0;
+    int hi = GetKeyCount();
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (KeyAt(mid) <= key) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+void BTreeNodeView::InitHeader(bool is_leaf, page_id_t link, int level) {
+    BTreeNodeHeader* header = Header();
+    header->is_leaf = is_leaf ? 1 : 0;
+    header->level = static_cast<uint8_t>(level);
+    header->key_count = 0;
+    header->heap_start = static_cast<uint16_t>(PAGE_SIZE);
+    header->fragmented_bytes = 0;
+    header->link = link;
+    header->layout = static_cast<uint8_t>(LeafLayout::ROW);
+}
+
+void BTreeNodeView::OpenSlotGap(int index) {
+    int count = GetKeyCount();
+    std::memmove(SlotPtr(index + 1), SlotPtr(index), (count - index) * SLOT_SIZE);
+    Header()->key_count = static_cast<uint16_t>(count + 1);
+}
+
+void BTreeNodeView::CloseSlotGap(int index) {
+    int count = GetKeyCount();
+    std::memmove(SlotPtr(index), SlotPtr(index + 1), (count - index - 1) * SLOT_SIZE);
+    Header()->key_count = static_cast<uint16_t>(count - 1);
+}
+
+Minipage Minipage::At(const char* body, int column, int count) {
+    uint16_t offset;
+    std::memcpy(&offset, body + sizeof(uint16_t) * (1 + column), sizeof(offset));
+    return Minipage{static_cast<Kind>(body[offset]), count, body + offset + 1};
+}
+
+int Minipage::ColumnCount(const char* body) {
+    uint16_t column_count;
+    std::memcpy(&column_count, body, sizeof(column_count));
+    return column_count;
+}
+
+uint8_t Minipage::TypeAt(int row) const {
+    return kind == VARIABLE ? static_cast<uint8_t>(data[row]) : static_cast<uint8_t>(kind);
+}
+
+std::string_view Minipage::BytesAt(int row) const {
+    if (kind == INT) {
+        return std::string_view(data + sizeof(int) * row, sizeof(int));
+    }
+    if (kind == DOUBLE) {
+        return std::string_view(data + sizeof(double) * row, sizeof(double));
+    }
+
+    const char* ends = data + count;
+    const char* payload = ends + sizeof(uint16_t) * count;
+    uint16_t begin = 0;
+    uint16_t end;
+    if (row > 0) {
+        std::memcpy(&begin, ends + sizeof(uint16_t) * (row - 1), sizeof(begin));
+    }
+    std::memcpy(&end, ends + sizeof(uint16_t) * row, sizeof(end));
+    return std::string_view(payload + begin, end - begin);
+}
+
+Value Minipage::ValueAt(int row) const {
+    std::string_view bytes = BytesAt(row);
+    switch (TypeAt(row)) {
+        case 0: {
+            int value;
+            std::memcpy(&value, bytes.data(), sizeof(value));
+            return value;
+        }
+        case 1: {
+            double value;
+            std::memcpy(&value, bytes.data(), sizeof(value));
+            return value;
+        }
+        case 3:
+            return std::string(OverflowRef::Decode(bytes).prefix);
+        default:
+            return std::string(bytes);
+    }
+}
+
+void LeafNodeView::Init(LeafLayout layout) {
+    InitHeader(true, INVALID_PAGE_ID, 0);
+    Header()->layout = static_cast<uint8_t>(layout);
+}
+
+int LeafNodeView::Find(btree_key_t key) const {
+    int index = LowerBound(key);
+    if (index < GetKeyCount() && KeyAt(index) == key) {
+        return index;
+    }
+    return -1;
+}
+
+const char* LeafNodeView::RecordDataAt(int index) const {
+    return data_ + ReadSlot(index).offset;
+}
+
+size_t LeafNodeView::RecordSizeAt(int index) const {
+    return ReadSlot(index).length;
+}
+
+Record LeafNodeView::RecordAt(int index, const RowFormat& format) const {
+    if (IsColumnar()) {
+        Record record;
+        for (int column = 0; column < GetColumnCount(); ++column) {
+            Minipage minipage = MinipageAt(column);
+            record.AddValue(minipage.ValueAt(index));
+            if (minipage.TypeAt(index) == 3) {
+                OverflowRef ref = OverflowRef::Decode(minipage.BytesAt(index));
+                record.SetOverflow(column, std::string(ref.prefix), ref.length, ref.page);
+            }
+        }
+        return record;
+    }
+    return format.Decode(data_ + ReadSlot(index).offset);
+}
+
+int LeafNodeView::GetColumnCount() const {
+    return GetKeyCount() == 0 ? 0 : Minipage::ColumnCount(ColumnarBody().data());
+}
+
+Minipage LeafNodeView::MinipageAt(int column) const {
+    return Minipage::At(ColumnarBody().data(), column, GetKeyCount());
+}
+
+size_t LeafNodeView::FreeSpace() const {
+    size_t slots_end = sizeof(BTreeNodeHeader) + GetKeyCount() * SLOT_SIZE;
+    return Header()->heap_start - slots_end;
+}
+
+bool LeafNodeView::HasRoomFor(size_t record_size) const {
+    return FreeSpace() + Header()->fragmented_bytes >= SLOT_SIZE + record_size;
+}
+
+bool LeafNodeView::InsertAt(int index, btree_key_t key, const Record& record, const RowFormat& format) {
+    if (IsColumnar()) {
+        PaxLeaf columns(ColumnarBody(), GetKeyCount());
+        columns.InsertRow(index, record);
+        if (!StoreColumns(columns, GetKeyCount() + 1)) {
+            return false;
+        }
+        OpenSlotGap(index);
+        WriteSlot(index, LeafSlot{key, 0, 0});
+        return true;
+    }
+
+    size_t record_size = format.GetSize(record);
+    if (!HasRoomFor(record_size)) {
+        return false;
+    }
+
+    uint16_t offset = AllocateRecord(record_size);
+    format.Encode(record, data_ + offset);
+    OpenSlotGap(index);
+    WriteSlot(index, LeafSlot{key, offset, static_cast<uint16_t>(record_size)});
+    return true;
+}
+
+void LeafNodeView::RemoveAt(int index) {
+    if (IsColumnar()) {
+        PaxLeaf columns(ColumnarBody(), GetKeyCount());
+        columns.RemoveRow(index);
+        CloseSlotGap(index);
+        StoreColumns(columns, GetKeyCount());
+        return;
+    }
+
+    LeafSlot slot = ReadSlot(index);
+    CloseSlotGap(index);
+    if (slot.offset == Header()->heap_start) {
+        Header()->heap_start = static_cast<uint16_t>(slot.offset + slot.length);
+    } else {
+        Header()->fragmented_bytes = static_cast<uint16_t>(Header()->fragmented_bytes + slot.length);
+    }
+}
+
+void LeafNodeView::MoveTailTo(LeafNodeView& dst, int from_index) {
+    int count = GetKeyCount();
+    if (IsColumnar()) {
+        PaxLeaf columns(ColumnarBody(), count);
+        PaxLeaf moved(dst.ColumnarBody(), dst.GetKeyCount());
+        columns.MoveRowsTo(moved, from_index);
+        dst.StoreColumns(moved, moved.GetRowCount());
+        for (int i = from_index; i < count; ++i) {
+            dst.OpenSlotGap(dst.GetKeyCount());
+            dst.WriteSlot(dst.GetKeyCount() - 1, LeafSlot{KeyAt(i), 0, 0});
+        }
+        Header()->key_count = static_cast<uint16_t>(from_index);
+        StoreColumns(columns, from_index);
+        return;
+    }
+
+    for (int i = from_index; i < count; ++i) {
+        LeafSlot slot = ReadSlot(i);
+        dst.InsertRaw(dst.GetKeyCount(), slot.key, data_ + slot.offset, slot.length);
+    }
+    Header()->key_count = static_cast<uint16_t>(from_index);
+    Compact();
+}
+
+void LeafNodeView::Compact() {
+    if (IsColumnar()) {
+        return;
+    }
+
+    char heap[PAGE_SIZE];
+    size_t heap_start = PAGE_SIZE;
+    int count = GetKeyCount();
+
+    for (int i = 0; i < count; ++i) {
+        LeafSlot slot = ReadSlot(i);
+        heap_start -= slot.length;
+        std::memcpy(heap + heap_start, data_ + slot.offset, slot.length);
+        slot.offset = static_cast<uint16_t>(heap_start);
+        WriteSlot(i, slot);
+    }
+
+    std::memcpy(data_ + heap_start, heap + heap_start, PAGE_SIZE - heap_start);
+    Header()->heap_start = static_cast<uint16_t>(heap_start);
+    Header()->fragmented_bytes = 0;
+}
+
+LeafSlot LeafNodeView::ReadSlot(int index) const {
+    LeafSlot slot;
+    std::memcpy(&slot, SlotPtr(index), sizeof(slot));
+    return slot;
+}
+
+void LeafNodeView::WriteSlot(int index, const LeafSlot& slot) {
+    std::memcpy(SlotPtr(index), &slot, sizeof(slot));
+}
+
+std::string_view LeafNodeView::ColumnarBody() const {
+    return std::string_view(data_ + Header()->heap_start, PAGE_SIZE - Header()->heap_start);
+}
+
+// The minipages are written at the end of the page, below which key_count
+// slots must still fit.
+bool LeafNodeView::StoreColumns(const PaxLeaf& columns, int key_count) {
+    size_t size = columns.GetEncodedSize();
+    if (sizeof(BTreeNodeHeader) + key_count * SLOT_SIZE + size > PAGE_SIZE) {
+        return false;
+    }
+    Header()->heap_start = static_cast<uint16_t>(PAGE_SIZE - size);
+    Header()->fragmented_bytes = 0;
+    columns.Encode(data_ + Header()->heap_start);
+    return true;
+}
+
+bool LeafNodeView::InsertRaw(int index, btree_key_t key, const char* record_data, size_t record_size) {
+    if (!HasRoomFor(record_size)) {
+        return false;
+    }
+
+    uint16_t offset = AllocateRecord(record_size);
+    std::memcpy(data_ + offset, record_data, record_size);
+    OpenSlotGap(index);
+    WriteSlot(index, LeafSlot{key, offset, static_cast<uint16_t>(record_size)});
+    return true;
+}
+
+uint16_t LeafNodeView::AllocateRecord(size_t record_size) {
+    if (FreeSpace() < SLOT_SIZE + record_size) {
+        Compact();
+    }
+    uint16_t offset = static_cast<uint16_t>(Header()->heap_start - record_size);
+    Header()->heap_start = offset;
+    return offset;
+}
+
+void InternalNodeView::Init(page_id_t leftmost_child, int level) {
+    InitHeader(false, leftmost_child, level);
+}
+
+page_id_t InternalNodeView::ChildAt(int index) const {
+    if (index == 0) {
+        return Header()->link;
+    }
+    return ReadSlot(index - 1).child;
+}
+
+void InternalNodeView::InsertAt(int index, btree_key_t key, page_id_t right_child) {
+    OpenSlotGap(index);
+    WriteSlot(index, InternalSlot{key, right_child});
+}
+
+btree_key_t InternalNodeView::SplitInto(InternalNodeView& dst, int index, btree_key_t key, page_id_t right_child) {
+    int count = GetKeyCount();
+    std::vector<InternalSlot> all_slots;
+    all_slots.reserve(count + 1);
+    for (int i = 0; i < count; ++i) {
+        all_slots.push_back(ReadSlot(i));
+    }
+    all_slots.insert(all_slots.begin() + index, InternalSlot{key, right_child});
+
+    int mid = static_cast<int>(all_slots.size()) / 2;
+    const InternalSlot& promoted = all_slots[mid];
+
+    Header()->key_count = 0;
+    for (int i = 0; i < mid; ++i) {
+        InsertAt(i, all_slots[i].key, all_slots[i].child);
+    }
+
+    dst.Init(promoted.child, GetLevel());
+    for (size_t i = mid + 1; i < all_slots.size(); ++i) {
+        dst.InsertAt(dst.GetKeyCount(), all_slots[i].key, all_slots[i].child);
+    }
+
+    return promoted.key;
+}
+
+InternalSlot InternalNodeView::ReadSlot(int index) const {
+    InternalSlot slot;
+    std::memcpy(&slot, SlotPtr(index), sizeof(slot));
+    return slot;
+}
+
+void InternalNodeView::WriteSlot(int index, const InternalSlot& slot) {
+    std::memcpy(SlotPtr(index), &slot, sizeof(slot));
+}
\ No newline at end of file
@@ -0,0 +1,176 @@
+#pragma once
+#include "page.h"
+#include "record.h"
+#include "row_format.h"
+#include <cstdint>
+#include <string_view>
+
+// Slotted node layout shared by leaves and internal nodes:
+//   [header][slot 0][slot 1]...  free space  ...[record heap]
+// Slots are kept sorted by key and grow towards the end of the page; leaf
+// records are appended to a heap that grows down from the end of the page.
+struct BTreeNodeHeader {
+    lsn_t lsn;
+    uint8_t is_leaf;
+    uint8_t level;  // 0 for leaves, children of a level-1 node are leaves
+    uint16_t key_count;
+    uint16_t heap_start;
+    uint16_t fragmented_bytes;
+    page_id_t link;  // leaf: next leaf, internal: leftmost child
+    uint8_t layout;  // leaves only, a LeafLayout
+};
+
+// Row leaves keep each record serialized in the heap. PAX leaves keep only
+// the keys in the slots and store the rows column by column, one minipage per
+// column, so that a scan can read just the columns it needs.
+enum class LeafLayout : uint8_t {
+    ROW = 0,
+    PAX = 1
+};
+
+// Keys are 64-bit so that a secondary index can pack a column value prefix
+// and the primary key into one unique key.
+using btree_key_t = int64_t;
+
+// Slots are only accessed through memcpy, so they are packed to 12 bytes.
+#pragma pack(push, 4)
+struct LeafSlot {
+    btree_key_t key;
+    uint16_t offset;
+    uint16_t length;
+};
+
+struct InternalSlot {
+    btree_key_t key;
+    page_id_t child;
+};
+#pragma pack(pop)
+
+static_assert(sizeof(LeafSlot) == sizeof(InternalSlot), "slot layouts must share a stride");
+
+// One column of a PAX leaf, with a value per key. A column whose values all
+// have the same numeric type is a plain array; any other column stores a type
+// tag and an end offset per value followed by the value bytes. Types are
+// numbered as in the serialized record format.
+//   PAX body: [column count][minipage offsets][minipage 0][minipage 1]...
+struct Minipage {
+    enum Kind : uint8_t {
+        INT = 0,
+        DOUBLE = 1,
+        VARIABLE = 2
+    };
+
+    Kind kind;
+    int count;
+    const char* data;  // past the kind byte
+
+    // Minipage column of the PAX body starting at body, holding count values.
+    static Minipage At(const char* body, int column, int count);
+    static int ColumnCount(const char* body);
+
+    uint8_t TypeAt(int row) const;
+    // Raw bytes of a value: 4 for an int, 8 for a double, the characters of
+    // a string.
+    std::string_view BytesAt(int row) const;
+    Value ValueAt(int row) const;
+};
+
+class BTreeNodeView {
+public:
+    explicit BTreeNodeView(char* data) : data_(data) {}
+    explicit BTreeNodeView(Page* page) : data_(page->GetData()) {}
+
+    bool IsLeaf() const { return Header()->is_leaf != 0; }
+    int GetLevel() const { return Header()->level; }
+    int GetKeyCount() const { return Header()->key_count; }
+    btree_key_t KeyAt(int index) const;
+
+    int LowerBound(btree_key_t key) const;
+    int UpperBound(btree_key_t key) const;
+
+protected:
+    static constexpr size_t SLOT_SIZE = sizeof(LeafSlot);
+
+    char* data_;
+
+    BTreeNodeHeader* Header() { return reinterpret_cast<BTreeNodeHeader*>(data_); }
+    const BTreeNodeHeader* Header() const { return reinterpret_cast<const BTreeNodeHeader*>(data_); }
+    char* SlotPtr(int index) { return data_ + sizeof(BTreeNodeHeader) + index * SLOT_SIZE; }
+    const char* SlotPtr(int index) const { return data_ + sizeof(BTreeNodeHeader) + index * SLOT_SIZE; }
+
+    void InitHeader(bool is_leaf, page_id_t link, int level);
+    void OpenSlotGap(int index);
+    void CloseSlotGap(int index);
+};
+
+class PaxLeaf;
+
+class LeafNodeView : public BTreeNodeView {
+public:
+    using BTreeNodeView::BTreeNodeView;
+
+    void Init(LeafLayout layout = LeafLayout::ROW);
+    bool IsColumnar() const { return Header()->layout == static_cast<uint8_t>(LeafLayout::PAX); }
+
+    page_id_t GetNextLeaf() const { return Header()->link; }
+    void SetNextLeaf(page_id_t page_id) { Header()->link = page_id; }
+
+    int Find(btree_key_t key) const;
+    // Row leaves encode their records in format; PAX leaves ignore it.
+    Record RecordAt(int index, const RowFormat& format) const;
+
+    // Row leaves only.
+    const char* RecordDataAt(int index) const;
+    size_t RecordSizeAt(int index) const;
+
+    // PAX leaves only. A leaf with no keys has no columns.
+    int GetColumnCount() const;
+    Minipage MinipageAt(int column) const;
+
+    static size_t Capacity() { return PAGE_SIZE - sizeof(BTreeNodeHeader); }
+    static size_t MaxRecordSize() { return Capacity() - SLOT_SIZE; }
+
+    // Bytes a row leaf spends on an entry: its slot and its record.
+    size_t EntrySizeAt(int index) const { return SLOT_SIZE + RecordSizeAt(index); }
+    static size_t EntrySize(size_t record_size) { return SLOT_SIZE + record_size; }
+
+    size_t FreeSpace() const;
+    // Exact for row leaves; for PAX leaves only InsertAt can tell, since a
+    // record may change how its columns are encoded.
+    bool HasRoomFor(size_t record_size) const;
+
+    bool InsertAt(int index, btree_key_t key, const Record& record, const RowFormat& format);
+    void RemoveAt(int index);
+    void MoveTailTo(LeafNodeView& dst, int from_index);
+    void Compact();
+
+private:
+    LeafSlot ReadSlot(int index) const;
+    void WriteSlot(int index, const LeafSlot& slot);
+    std::string_view ColumnarBody() const;
+    bool StoreColumns(const PaxLeaf& columns, int key_count);
+    bool InsertRaw(int index, btree_key_t key, const char* record_data, size_t record_size);
+    uint16_t AllocateRecord(size_t record_size);
+};
+
+class InternalNodeView : public BTreeNodeView {
+public:
+    using BTreeNodeView::BTreeNodeView;
+
+    void Init(page_id_t leftmost_child, int level);
+
+    // Children are numbered 0..key_count; child i+1 holds keys >= KeyAt(i).
+    page_id_t ChildAt(int index) const;
+    int ChildIndexFor(btree_key_t key) const { return UpperBound(key); }
+    page_id_t ChildFor(btree_key_t key) const { return ChildAt(ChildIndexFor(key)); }
+
+    // Separator keys that fit in a page; every key has a slot of its own.
+    static int MaxKeys() { return static_cast<int>((PAGE_SIZE - sizeof(BTreeNodeHeader)) / SLOT_SIZE); }
+    bool IsFull() const { return GetKeyCount() >= MaxKeys(); }
+    void InsertAt(int index, btree_key_t key, page_id_t right_child);
+    btree_key_t SplitInto(InternalNodeView& dst, int index, btree_key_t key, page_id_t right_child);
+
+private:
+    InternalSlot ReadSlot(int index) const;
+    void WriteSlot(int index, const InternalSlot& slot);
+};
\ No newline at end of file
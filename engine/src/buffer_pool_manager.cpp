@@ -1,80 +1,157 @@
 #include "buffer_pool_manager.h"
 #include <algorithm>
+#include <cstring>
+#include <functional>
+#include <iostream>
+
+BufferPoolManager::BufferPoolManager(size_t pool_size, StorageManager* storage_manager,
+                                     ReplacerType replacer_type, LogManager* log_manager,
+                                     size_t shard_count)
+    : pool_size_(pool_size), storage_manager_(storage_manager), log_manager_(log_manager) {
+    shard_count = std::max<size_t>(1, std::min(shard_count, pool_size / MIN_FRAMES_PER_SHARD));
+    shards_.reserve(shard_count);
+    for (size_t i = 0; i < shard_count; ++i) {
+        shards_.emplace_back(std::make_unique<Shard>());
+    }
 
-BufferPoolManager::BufferPoolManager(size_t pool_size, StorageManager* storage_manager)
-    : pool_size_(pool_size), storage_manager_(storage_manager) {
     frames_.reserve(pool_size);
     for (size_t i = 0; i < pool_size; ++i) {
         frames_.emplace_back(std::make_unique<Frame>());
-        free_list_.push_back(frames_[i].get());
+        frames_[i]->page = std::make_unique<Page>();
+        Shard& shard = *shards_[i % shard_count];
+        frames_[i]->frame_id = static_cast<frame_id_t>(shard.frames.size());
+        shard.frames.push_back(frames_[i].get());
+        shard.frame_count++;
+        shard.free_list.push_back(frames_[i].get());
     }
+
+    for (auto& shard : shards_) {
+        shard->replacer = Replacer::Create(replacer_type, shard->frames.size());
+    }
+    async_io_ = AsyncIO::Create(storage_manager_);
 }
 
 Page* BufferPoolManager::FetchPage(page_id_t page_id) {
-    auto it = page_table_.find(page_id);
-    if (it != page_table_.end()) {
-        Frame* frame = it->second;
-        frame->pin_count++;
-        lru_list_.remove(frame);
-        lru_list_.push_front(frame);
-        return frame->page.get();
-    }
+    Shard& shard = GetShard(page_id);
+    std::unique_lock<std::mutex> lock(shard.latch);
 
-    Frame* frame = GetVictimFrame();
-    if (!frame) {
-        return nullptr;
-    }
+    Frame* frame = nullptr;
+    while (!frame) {
+        // An evicted page is read again only once its write-back is done.
+        if (shard.writing_pages.count(page_id) > 0) {
+            shard.io_cv.wait(lock);
+            continue;
+        }
 
-    if (frame->page && frame->is_dirty) {
-        if (!FlushFrame(frame)) {
-            return nullptr;
+        auto it = shard.page_table.find(page_id);
+        if (it != shard.page_table.end()) {
+            frame = it->second;
+            frame->pin_count.fetch_add(1);
+            if (frame->io_pending) {
+                shard.io_cv.wait(lock, [frame] { return !frame->io_pending; });
+                if (frame->page->GetPageId() != page_id) {
+                    // The read failed; the last waiter hands the frame back.
+                    if (frame->pin_count.fetch_sub(1) == 1) {
+                        shard.free_list.push_back(frame);
+                    }
+                    return nullptr;
+                }
+            }
+            shard.replacer->Pin(frame->frame_id);
+            frame->last_access = ++shard.clock;
+            shard.hits++;
+            return frame->page.get();
         }
-    }
 
-    if (frame->page) {
-        page_table_.erase(frame->page->GetPageId());
-    }
+        // Frames being read ahead cannot be evicted until their reads
+        // complete, so concurrent scans wait for them rather than fail.
+        frame = GetVictimFrame(shard);
+        if (!frame) {
+            lock.unlock();
+            bool stolen = StealFrame(shard);
+            lock.lock();
+            if (!stolen && shard.pending_reads == 0) {
+                return nullptr;
+            }
+            if (!stolen) {
+                shard.io_cv.wait(lock);
+            }
+            continue;
+        }
 
-    frame->page = storage_manager_->ReadPage(page_id);
-    if (!frame->page) {
-        return nullptr;
+        if (!EvictFrame(shard, frame, lock)) {
+            return nullptr;
+        }
+        // The latch may have been released for a write-back, and another
+        // FetchPage may have read the page meanwhile.
+        if (shard.page_table.count(page_id) > 0) {
+            shard.free_list.push_back(frame);
+            frame = nullptr;
+        }
     }
 
-    frame->pin_count = 1;
+    // The read is issued outside the latch. FetchPage calls for the same
+    // page wait for it as they do for a read-ahead.
+    frame->page->SetPageId(page_id);
+    frame->pin_count.store(1);
     frame->is_dirty = false;
-    page_table_[page_id] = frame;
-    lru_list_.push_front(frame);
+    frame->image_lsn = INVALID_LSN;
+    frame->io_pending = true;
+    frame->last_access = ++shard.clock;
+    shard.misses++;
+    shard.page_table[page_id] = frame;
+    shard.replacer->Pin(frame->frame_id);
+    lock.unlock();
+
+    bool success = storage_manager_->ReadPage(page_id, frame->page->GetData());
 
+    lock.lock();
+    frame->io_pending = false;
+    shard.io_cv.notify_all();
+    if (!success) {
+        shard.page_table.erase(page_id);
+        shard.replacer->Remove(frame->frame_id);
+        frame->page->SetPageId(INVALID_PAGE_ID);
+        if (frame->pin_count.fetch_sub(1) == 1) {
+            shard.free_list.push_back(frame);
+        }
+        return nullptr;
+    }
     return frame->page.get();
 }
 
 bool BufferPoolManager::UnpinPage(page_id_t page_id, bool is_dirty) {
-    auto it = page_table_.find(page_id);
-    if (it == page_table_.end()) {
+    Shard& shard = GetShard(page_id);
+    std::lock_guard<std::mutex> guard(shard.latch);
+
+    auto it = shard.page_table.find(page_id);
+    if (it == shard.page_table.end()) {
         return false;
     }
 
     Frame* frame = it->second;
-    if (frame->pin_count <= 0) {
+    if (frame->pin_count.load() <= 0) {
         return false;
     }
 
-    frame->pin_count--;
     if (is_dirty) {
         frame->is_dirty = true;
     }
 
-    if (frame->pin_count == 0) {
-        lru_list_.remove(frame);
-        lru_list_.push_back(frame);
+    if (frame->pin_count.fetch_sub(1) == 1) {
+        shard.replacer->Unpin(frame->frame_id);
     }
 
     return true;
 }
 
 bool BufferPoolManager::FlushPage(page_id_t page_id) {
-    auto it = page_table_.find(page_id);
-    if (it == page_table_.end()) {
+    Shard& shard = GetShard(page_id);
+    std::unique_lock<std::mutex> lock(shard.latch);
+    shard.io_cv.wait(lock, [&shard, page_id] { return shard.writing_pages.count(page_id) == 0; });
+
+    auto it = shard.page_table.find(page_id);
+    if (it == shard.page_table.end()) {
         return false;
     }
 
@@ -82,76 +159,463 @@ bool BufferPoolManager::FlushPage(page_id_t page_id) {
     return FlushFrame(frame);
 }
 
-Page* BufferPoolManager::NewPage(page_id_t* page_id) {
-    Frame* frame = GetVictimFrame();
-    if (!frame) {
-        return nullptr;
+bool BufferPoolManager::FlushAllPages() {
+    bool flushed = true;
+    for (auto& shard : shards_) {
+        // Pages evicted before this call must be on disk when it returns.
+        std::unique_lock<std::mutex> lock(shard->latch);
+        shard->io_cv.wait(lock, [&shard] { return shard->writing_pages.empty(); });
+        for (auto& entry : shard->page_table) {
+            flushed = FlushFrame(entry.second) && flushed;
+        }
+    }
+    return flushed;
+}
+
+Page* BufferPoolManager::NewPage(page_id_t* page_id, bool scratch) {
+    page_id_t new_page_id = TakeFreePage(scratch);
+    if (new_page_id == INVALID_PAGE_ID) {
+        new_page_id = storage_manager_->AllocatePage();
     }
+    Shard& shard = GetShard(new_page_id);
+    std::unique_lock<std::mutex> lock(shard.latch);
 
-    if (frame->page && frame->is_dirty) {
-        if (!FlushFrame(frame)) {
-            return nullptr;
+    // A free page may still be resident if a warm restart read it ahead;
+    // its frame is taken over once the read is done.
+    Frame* frame = nullptr;
+    auto it = shard.page_table.find(new_page_id);
+    if (it != shard.page_table.end()) {
+        Frame* resident = it->second;
+        shard.io_cv.wait(lock, [resident] { return !resident->io_pending; });
+        it = shard.page_table.find(new_page_id);
+        if (it != shard.page_table.end()) {
+            frame = it->second;
+            if (frame->pin_count.load() > 0) {
+                std::cerr << "Free page " << new_page_id << " is pinned" << std::endl;
+                return nullptr;
+            }
         }
     }
 
-    if (frame->page) {
-        page_table_.erase(frame->page->GetPageId());
+    // Without a frame for it the page goes back on the free list.
+    while (!frame) {
+        frame = GetVictimFrame(shard);
+        if (!frame) {
+            lock.unlock();
+            bool stolen = StealFrame(shard);
+            lock.lock();
+            if (stolen) {
+                continue;
+            }
+        }
+        if (!frame || !EvictFrame(shard, frame, lock)) {
+            lock.unlock();
+            DeletePage(new_page_id, true);
+            return nullptr;
+        }
     }
 
-    *page_id = storage_manager_->AllocatePage();
-    frame->page = std::make_unique<Page>(*page_id);
-    frame->pin_count = 1;
+    *page_id = new_page_id;
+    frame->page->SetPageId(new_page_id);
+    frame->page->ResetMemory();
+    frame->pin_count.store(1);
     frame->is_dirty = true;
-    page_table_[*page_id] = frame;
-    lru_list_.push_front(frame);
+    frame->image_lsn = INVALID_LSN;
+    frame->last_access = ++shard.clock;
+    shard.page_table[new_page_id] = frame;
+    shard.replacer->Pin(frame->frame_id);
 
     return frame->page.get();
 }
 
-bool BufferPoolManager::DeletePage(page_id_t page_id) {
-    auto it = page_table_.find(page_id);
-    if (it != page_table_.end()) {
-        Frame* frame = it->second;
-        if (frame->pin_count > 0) {
+bool BufferPoolManager::DeletePage(page_id_t page_id, bool scratch) {
+    {
+        // A page being written back is freed once the write is done, so
+        // that no write of it lands after it is reused.
+        Shard& shard = GetShard(page_id);
+        std::unique_lock<std::mutex> lock(shard.latch);
+        shard.io_cv.wait(lock, [&shard, page_id] { return shard.writing_pages.count(page_id) == 0; });
+
+        auto it = shard.page_table.find(page_id);
+        if (it != shard.page_table.end()) {
+            Frame* frame = it->second;
+            if (frame->pin_count.load() > 0 || frame->io_pending) {
+                return false;
+            }
+
+            shard.page_table.erase(page_id);
+            shard.replacer->Remove(frame->frame_id);
+            shard.free_list.push_front(frame);
+            frame->page->SetPageId(INVALID_PAGE_ID);
+            frame->is_dirty = false;
+            frame->pin_count.store(0);
+        }
+    }
+
+    std::lock_guard<std::mutex> guard(free_latch_);
+    if (scratch) {
+        free_pages_.insert(page_id);
+    } else if (deleted_pages_.insert(page_id).second && log_manager_) {
+        LogRecord log_record;
+        log_record.type = LogRecordType::FREE_PAGE;
+        log_record.key = static_cast<int>(page_id);
+        log_manager_->AppendLogRecord(log_record);
+    }
+    return true;
+}
+
+std::vector<page_id_t> BufferPoolManager::GetFreePages() {
+    std::lock_guard<std::mutex> guard(free_latch_);
+    std::vector<page_id_t> page_ids(free_pages_.begin(), free_pages_.end());
+    page_ids.insert(page_ids.end(), deleted_pages_.begin(), deleted_pages_.end());
+    return page_ids;
+}
+
+void BufferPoolManager::SetFreePages(const std::vector<page_id_t>& page_ids) {
+    std::lock_guard<std::mutex> guard(free_latch_);
+    free_pages_ = std::set<page_id_t>(page_ids.begin(), page_ids.end());
+    deleted_pages_.clear();
+}
+
+void BufferPoolManager::ReleaseDeletedPages(const std::vector<page_id_t>& free_pages) {
+    std::lock_guard<std::mutex> guard(free_latch_);
+    for (page_id_t page_id : free_pages) {
+        if (deleted_pages_.erase(page_id) > 0) {
+            free_pages_.insert(page_id);
+        }
+    }
+}
+
+void BufferPoolManager::RedoFreeList(const LogRecord& log_record) {
+    auto page_id = static_cast<page_id_t>(log_record.key);
+    std::lock_guard<std::mutex> guard(free_latch_);
+    if (log_record.type == LogRecordType::ALLOCATE_PAGE) {
+        free_pages_.erase(page_id);
+    } else if (log_record.type == LogRecordType::FREE_PAGE) {
+        deleted_pages_.insert(page_id);
+    }
+}
+
+void BufferPoolManager::LogPageImages(const std::vector<page_id_t>& page_ids) {
+    if (!log_manager_ || page_ids.empty()) {
+        return;
+    }
+
+    std::vector<Frame*> frames;
+    LogRecord log_record;
+    log_record.type = LogRecordType::PAGE_IMAGES;
+    log_record.key = static_cast<int>(page_ids.size());
+    log_record.payload.reserve(page_ids.size() * (sizeof(page_id_t) + PAGE_SIZE));
+    for (page_id_t page_id : page_ids) {
+        Shard& shard = GetShard(page_id);
+        std::lock_guard<std::mutex> guard(shard.latch);
+        Frame* frame = shard.page_table.at(page_id);
+        frames.push_back(frame);
+        log_record.payload.append(reinterpret_cast<const char*>(&page_id), sizeof(page_id));
+        log_record.payload.append(frame->page->GetData(), PAGE_SIZE);
+    }
+
+    lsn_t lsn = log_manager_->AppendLogRecord(log_record);
+    for (size_t i = 0; i < frames.size(); ++i) {
+        std::lock_guard<std::mutex> guard(GetShard(page_ids[i]).latch);
+        frames[i]->image_lsn = lsn;
+    }
+}
+
+bool BufferPoolManager::RedoPageImages(const LogRecord& log_record) {
+    const char* data = log_record.payload.data();
+    for (int i = 0; i < log_record.key; ++i) {
+        page_id_t page_id;
+        std::memcpy(&page_id, data, sizeof(page_id));
+        data += sizeof(page_id);
+
+        // The file extension that made room for the page may be lost.
+        while (storage_manager_->GetPageCount() <= page_id) {
+            storage_manager_->AllocatePage();
+        }
+        Page* page = FetchPage(page_id);
+        if (!page) {
             return false;
         }
+        std::memcpy(page->GetData(), data, PAGE_SIZE);
+        UnpinPage(page_id, true);
+        data += PAGE_SIZE;
+    }
+    return true;
+}
+
+void BufferPoolManager::Prefetch(const std::vector<page_id_t>& page_ids) {
+    std::vector<std::pair<Shard*, Frame*>> reads;
+    page_id_t page_count = storage_manager_->GetPageCount();
+
+    for (page_id_t page_id : page_ids) {
+        if (page_id == INVALID_PAGE_ID || page_id >= page_count) {
+            continue;
+        }
 
-        page_table_.erase(page_id);
-        lru_list_.remove(frame);
-        free_list_.push_front(frame);
-        frame->page.reset();
+        Shard& shard = GetShard(page_id);
+        std::unique_lock<std::mutex> lock(shard.latch);
+        if (shard.page_table.count(page_id) > 0 || shard.writing_pages.count(page_id) > 0) {
+            continue;
+        }
+
+        Frame* frame = GetVictimFrame(shard);
+        if (!frame) {
+            continue;
+        }
+        if (!EvictFrame(shard, frame, lock)) {
+            continue;
+        }
+        if (shard.page_table.count(page_id) > 0 || shard.writing_pages.count(page_id) > 0) {
+            shard.free_list.push_back(frame);
+            continue;
+        }
+
+        frame->page->SetPageId(page_id);
+        frame->pin_count.store(0);
         frame->is_dirty = false;
-        frame->pin_count = 0;
+        frame->image_lsn = INVALID_LSN;
+        frame->io_pending = true;
+        frame->last_access = 0;
+        shard.pending_reads++;
+        shard.page_table[page_id] = frame;
+        reads.emplace_back(&shard, frame);
     }
 
-    return true;
+    // Issued outside the shard latches: completions need them, and a full
+    // submission queue blocks until earlier reads complete.
+    for (auto& read : reads) {
+        Shard* shard = read.first;
+        Frame* frame = read.second;
+        page_id_t page_id = frame->page->GetPageId();
+        async_io_->ReadPage(page_id, frame->page->GetData(), [this, shard, frame, page_id](bool success) {
+            if (!success) {
+                success = storage_manager_->ReadPage(page_id, frame->page->GetData());
+            }
+            CompleteRead(*shard, frame, success);
+        });
+    }
+    if (!reads.empty()) {
+        async_io_->Submit();
+    }
+}
+
+std::vector<page_id_t> BufferPoolManager::GetHotPages() {
+    std::vector<std::vector<std::pair<uint64_t, page_id_t>>> ranked(shards_.size());
+    size_t most_ranked = 0;
+    for (size_t i = 0; i < shards_.size(); ++i) {
+        std::lock_guard<std::mutex> guard(shards_[i]->latch);
+        for (const auto& entry : shards_[i]->page_table) {
+            ranked[i].emplace_back(entry.second->last_access, entry.first);
+        }
+        std::sort(ranked[i].begin(), ranked[i].end(), std::greater<>());
+        most_ranked = std::max(most_ranked, ranked[i].size());
+    }
+
+    std::vector<page_id_t> page_ids;
+    for (size_t rank = 0; rank < most_ranked; ++rank) {
+        for (const auto& shard_pages : ranked) {
+            if (rank < shard_pages.size()) {
+                page_ids.push_back(shard_pages[rank].second);
+            }
+        }
+    }
+    return page_ids;
+}
+
+size_t BufferPoolManager::WarmUp(const std::vector<page_id_t>& hot_pages) {
+    std::vector<size_t> taken(shards_.size(), 0);
+    std::vector<page_id_t> page_ids;
+    for (page_id_t page_id : hot_pages) {
+        size_t shard = page_id % shards_.size();
+        if (taken[shard] < shards_[shard]->frame_count) {
+            taken[shard]++;
+            page_ids.push_back(page_id);
+        }
+    }
+
+    // Reading in page order turns runs of hot pages into sequential I/O.
+    std::sort(page_ids.begin(), page_ids.end());
+    Prefetch(page_ids);
+    return page_ids.size();
+}
+
+void BufferPoolManager::WaitForReads() {
+    for (auto& shard : shards_) {
+        std::unique_lock<std::mutex> lock(shard->latch);
+        shard->io_cv.wait(lock, [&shard] { return shard->pending_reads == 0; });
+    }
+}
+
+uint64_t BufferPoolManager::GetHitCount() {
+    uint64_t hits = 0;
+    for (auto& shard : shards_) {
+        std::lock_guard<std::mutex> guard(shard->latch);
+        hits += shard->hits;
+    }
+    return hits;
+}
+
+uint64_t BufferPoolManager::GetMissCount() {
+    uint64_t misses = 0;
+    for (auto& shard : shards_) {
+        std::lock_guard<std::mutex> guard(shard->latch);
+        misses += shard->misses;
+    }
+    return misses;
+}
+
+int BufferPoolManager::GetPinCount(page_id_t page_id) {
+    Shard& shard = GetShard(page_id);
+    std::lock_guard<std::mutex> guard(shard.latch);
+
+    auto it = shard.page_table.find(page_id);
+    if (it == shard.page_table.end()) {
+        return -1;
+    }
+    return it->second->pin_count.load();
+}
+
+// The lowest free page keeps the file dense at the front.
+page_id_t BufferPoolManager::TakeFreePage(bool scratch) {
+    std::lock_guard<std::mutex> guard(free_latch_);
+    if (free_pages_.empty()) {
+        return INVALID_PAGE_ID;
+    }
+    page_id_t page_id = *free_pages_.begin();
+    free_pages_.erase(free_pages_.begin());
+    if (!scratch && log_manager_) {
+        LogRecord log_record;
+        log_record.type = LogRecordType::ALLOCATE_PAGE;
+        log_record.key = static_cast<int>(page_id);
+        allocation_lsn_.store(log_manager_->AppendLogRecord(log_record));
+    }
+    return page_id;
 }
 
-BufferPoolManager::Frame* BufferPoolManager::GetVictimFrame() {
-    if (!free_list_.empty()) {
-        Frame* frame = free_list_.front();
-        free_list_.pop_front();
+BufferPoolManager::Frame* BufferPoolManager::GetVictimFrame(Shard& shard) {
+    if (!shard.free_list.empty()) {
+        Frame* frame = shard.free_list.front();
+        shard.free_list.pop_front();
         return frame;
     }
 
-    for (auto it = lru_list_.rbegin(); it != lru_list_.rend(); ++it) {
-        Frame* frame = *it;
-        if (frame->pin_count == 0) {
-            lru_list_.remove(frame);
-            return frame;
+    frame_id_t frame_id;
+    if (!shard.replacer->Victim(&frame_id)) {
+        return nullptr;
+    }
+    return shard.frames[frame_id];
+}
+
+// Called with no other shard latch held. Another shard's frames are only
+// taken from its free list or replacer, and are written back before they
+// move, so a frame changes shards without a page.
+bool BufferPoolManager::StealFrame(Shard& shard) {
+    for (auto& other : shards_) {
+        if (other.get() == &shard) {
+            continue;
         }
+
+        Frame* frame;
+        {
+            std::unique_lock<std::mutex> lock(other->latch);
+            frame = GetVictimFrame(*other);
+            if (!frame || !EvictFrame(*other, frame, lock)) {
+                continue;
+            }
+            frame->page->SetPageId(INVALID_PAGE_ID);
+            other->replacer->Remove(frame->frame_id);
+            other->frames[frame->frame_id] = nullptr;
+            other->free_slots.push_back(frame->frame_id);
+            other->frame_count--;
+        }
+
+        std::lock_guard<std::mutex> guard(shard.latch);
+        AdoptFrame(shard, frame);
+        return true;
     }
+    return false;
+}
 
-    return nullptr;
+void BufferPoolManager::AdoptFrame(Shard& shard, Frame* frame) {
+    if (shard.free_slots.empty()) {
+        frame->frame_id = static_cast<frame_id_t>(shard.frames.size());
+        shard.frames.push_back(frame);
+        shard.replacer->Resize(shard.frames.size());
+    } else {
+        frame->frame_id = shard.free_slots.back();
+        shard.free_slots.pop_back();
+        shard.frames[frame->frame_id] = frame;
+    }
+    shard.frame_count++;
+    shard.free_list.push_back(frame);
+}
+
+// A dirty page is written back with the latch released. Until the write is
+// done the page is in writing_pages rather than the page table, and reading
+// it again waits, so no read sees the stale copy on disk.
+bool BufferPoolManager::EvictFrame(Shard& shard, Frame* frame, std::unique_lock<std::mutex>& lock) {
+    page_id_t page_id = frame->page->GetPageId();
+    if (page_id == INVALID_PAGE_ID) {
+        return true;
+    }
+
+    shard.page_table.erase(page_id);
+    if (!frame->is_dirty) {
+        return true;
+    }
+
+    shard.writing_pages.insert(page_id);
+    lock.unlock();
+    bool flushed = FlushFrame(frame);
+    lock.lock();
+    shard.writing_pages.erase(page_id);
+    shard.io_cv.notify_all();
+
+    if (!flushed) {
+        shard.page_table[page_id] = frame;
+        shard.replacer->Unpin(frame->frame_id);
+        return false;
+    }
+    return true;
+}
+
+void BufferPoolManager::CompleteRead(Shard& shard, Frame* frame, bool success) {
+    std::lock_guard<std::mutex> guard(shard.latch);
+    frame->io_pending = false;
+    shard.pending_reads--;
+
+    if (success) {
+        if (frame->pin_count.load() == 0) {
+            shard.replacer->Unpin(frame->frame_id);
+        }
+    } else {
+        shard.page_table.erase(frame->page->GetPageId());
+        frame->page->SetPageId(INVALID_PAGE_ID);
+        if (frame->pin_count.load() == 0) {
+            shard.free_list.push_back(frame);
+        }
+    }
+    shard.io_cv.notify_all();
 }
 
 bool BufferPoolManager::FlushFrame(Frame* frame) {
-    if (!frame->page) {
+    if (frame->page->GetPageId() == INVALID_PAGE_ID) {
         return false;
     }
 
     frame->page->SetDirty(frame->is_dirty);
-    if (frame->is_dirty && !storage_manager_->WritePage(*frame->page)) {
+    if (!frame->is_dirty) {
+        return true;
+    }
+
+    // Write-ahead rule: the log must be durable up to the page LSN before the
+    // page itself reaches the data file, past the last reuse of a free page,
+    // which the page may refer to, and past any logged image of the page.
+    if (log_manager_) {
+        log_manager_->Flush(std::max({frame->page->GetLSN(), allocation_lsn_.load(), frame->image_lsn}));
+    }
+    if (!storage_manager_->WritePage(frame->page->GetPageId(), frame->page->GetData())) {
         return false;
     }
 
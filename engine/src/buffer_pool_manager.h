@@ -1,35 +1,132 @@
 #pragma once
 #include "page.h"
 #include "storage_manager.h"
+#include "replacer.h"
+#include "log_manager.h"
+#include "async_io.h"
 #include <unordered_map>
 #include <list>
+#include <set>
 #include <memory>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
 
 class BufferPoolManager {
 public:
-    explicit BufferPoolManager(size_t pool_size, StorageManager* storage_manager);
+    static constexpr size_t DEFAULT_SHARD_COUNT = 16;
+    static constexpr size_t MIN_FRAMES_PER_SHARD = 8;
+
+    explicit BufferPoolManager(size_t pool_size, StorageManager* storage_manager,
+                               ReplacerType replacer_type = ReplacerType::LRU_K,
+                               LogManager* log_manager = nullptr,
+                               size_t shard_count = DEFAULT_SHARD_COUNT);
     ~BufferPoolManager() = default;
 
     Page* FetchPage(page_id_t page_id);
     bool UnpinPage(page_id_t page_id, bool is_dirty);
     bool FlushPage(page_id_t page_id);
-    Page* NewPage(page_id_t* page_id);
-    bool DeletePage(page_id_t page_id);
+    bool FlushAllPages();
+    // Takes a page off the free list, or extends the file if it is empty.
+    // Taking a page off the list is logged, and no page reaches the data file
+    // before that record does, since it may refer to the page. Scratch pages,
+    // which nothing on disk ever refers to, skip the log.
+    Page* NewPage(page_id_t* page_id, bool scratch = false);
+    // Drops the page from the pool and frees it. A scratch page is free
+    // again at once; other pages are logged as freed and wait for
+    // ReleaseDeletedPages, since redo from the last checkpoint may still
+    // read them.
+    bool DeletePage(page_id_t page_id, bool scratch = false);
+
+    // The free list and the pages deleted since, for a checkpoint to persist.
+    std::vector<page_id_t> GetFreePages();
+    // Sets the free list from the last checkpoint, when opening.
+    void SetFreePages(const std::vector<page_id_t>& page_ids);
+    // Once the checkpoint that persisted free_pages, from GetFreePages, is
+    // on disk, the deleted pages among them join the free list.
+    void ReleaseDeletedPages(const std::vector<page_id_t>& free_pages);
+    // Replays a logged ALLOCATE_PAGE or FREE_PAGE on the free list.
+    void RedoFreeList(const LogRecord& log_record);
+
+    // Logs the current images of pages the caller has pinned, and keeps
+    // them from the data file until that record is durable.
+    void LogPageImages(const std::vector<page_id_t>& page_ids);
+    // Writes back the images of a logged PAGE_IMAGES, whatever is on disk:
+    // later records on those pages are replayed after it.
+    bool RedoPageImages(const LogRecord& log_record);
+
+    // Starts asynchronous reads for pages that are not yet resident. The
+    // frames stay unpinned; a FetchPage that arrives first waits for the read.
+    void Prefetch(const std::vector<page_id_t>& page_ids);
+
+    // Resident pages, most recently used first. Recency is tracked per shard,
+    // so shards are interleaved rank by rank.
+    std::vector<page_id_t> GetHotPages();
+    // Prefetches pages from GetHotPages of an earlier run, in page order and
+    // as many of the first ones as each shard has frames for. Returns the
+    // number of pages read.
+    size_t WarmUp(const std::vector<page_id_t>& hot_pages);
+    // Waits until every prefetched page has been read.
+    void WaitForReads();
+
+    // FetchPage calls that found the page resident or being read ahead,
+    // and those that had to read it.
+    uint64_t GetHitCount();
+    uint64_t GetMissCount();
+
+    int GetPinCount(page_id_t page_id);
+    size_t GetPoolSize() const { return pool_size_; }
+    size_t GetShardCount() const { return shards_.size(); }
 
 private:
     struct Frame {
         std::unique_ptr<Page> page;
-        int pin_count{0};
+        frame_id_t frame_id{0};
+        std::atomic<int> pin_count{0};
         bool is_dirty{false};
+        bool io_pending{false};
+        uint64_t last_access{0};        // shard clock at the last fetch
+        lsn_t image_lsn{INVALID_LSN};   // a logged image of the page
+    };
+
+    // Frames are partitioned across shards by page id; each shard owns its
+    // own page table, free list and replacer behind a single mutex. A shard
+    // whose frames are all pinned takes one from another shard, so frames
+    // move between shards and frame ids are local to the shard.
+    struct Shard {
+        std::mutex latch;
+        std::unordered_map<page_id_t, Frame*> page_table;
+        std::vector<Frame*> frames;            // by frame id; null where a frame moved away
+        std::vector<frame_id_t> free_slots;    // frame ids without a frame
+        size_t frame_count{0};
+        std::list<Frame*> free_list;
+        std::set<page_id_t> writing_pages;     // evicted, and being written back
+        std::unique_ptr<Replacer> replacer;
+        std::condition_variable io_cv;
+        size_t pending_reads{0};
+        uint64_t clock{0};
+        uint64_t hits{0};
+        uint64_t misses{0};
     };
 
     size_t pool_size_;
     StorageManager* storage_manager_;
-    std::unordered_map<page_id_t, Frame*> page_table_;
+    LogManager* log_manager_;
     std::vector<std::unique_ptr<Frame>> frames_;
-    std::list<Frame*> free_list_;
-    std::list<Frame*> lru_list_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+    std::unique_ptr<AsyncIO> async_io_;
+
+    std::mutex free_latch_;
+    std::set<page_id_t> free_pages_;
+    std::set<page_id_t> deleted_pages_;               // free once a checkpoint is on disk
+    std::atomic<lsn_t> allocation_lsn_{INVALID_LSN};  // the last logged reuse of a free page
 
-    Frame* GetVictimFrame();
+    Shard& GetShard(page_id_t page_id) { return *shards_[page_id % shards_.size()]; }
+    page_id_t TakeFreePage(bool scratch);
+    Frame* GetVictimFrame(Shard& shard);
+    bool StealFrame(Shard& shard);
+    void AdoptFrame(Shard& shard, Frame* frame);
+    bool EvictFrame(Shard& shard, Frame* frame, std::unique_lock<std::mutex>& lock);
     bool FlushFrame(Frame* frame);
+    void CompleteRead(Shard& shard, Frame* frame, bool success);
 };
\ No newline at end of file
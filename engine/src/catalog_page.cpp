@@ -0,0 +1,100 @@
+#include "catalog_page.h"
+#include "overflow_chain.h"
+#include <cstring>
+#include <iostream>
+
+static constexpr uint64_t MAGIC = 0x474C544344424453ULL;
+static constexpr size_t MAGIC_OFFSET = sizeof(lsn_t);
+static constexpr size_t CATALOG_LSN_OFFSET = MAGIC_OFFSET + sizeof(uint64_t);
+static constexpr size_t LENGTH_OFFSET = CATALOG_LSN_OFFSET + sizeof(lsn_t);
+static constexpr size_t CURRENT_OFFSET = LENGTH_OFFSET + sizeof(uint64_t);
+static constexpr size_t CHAINS_OFFSET = CURRENT_OFFSET + sizeof(uint32_t);
+static constexpr size_t CHAIN_SIZE = sizeof(page_id_t) + sizeof(uint32_t);
+
+static CatalogPage::Chain ReadChain(const Page* page, uint32_t slot) {
+    CatalogPage::Chain chain;
+    const char* data = page->GetData() + CHAINS_OFFSET + slot * CHAIN_SIZE;
+    std::memcpy(&chain.first_page, data, sizeof(chain.first_page));
+    std::memcpy(&chain.page_count, data + sizeof(chain.first_page), sizeof(chain.page_count));
+    return chain;
+}
+
+bool CatalogPage::Initialize(BufferPoolManager* buffer_pool_manager) {
+    page_id_t page_id;
+    Page* page = buffer_pool_manager->NewPage(&page_id);
+    if (!page) {
+        return false;
+    }
+    buffer_pool_manager->UnpinPage(page_id, true);
+    if (page_id != PAGE_ID) {
+        std::cerr << "Catalog page allocated as page " << page_id << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool CatalogPage::Read(BufferPoolManager* buffer_pool_manager, std::string& catalog, lsn_t& catalog_lsn) {
+    Page* page = buffer_pool_manager->FetchPage(PAGE_ID);
+    if (!page) {
+        return false;
+    }
+    uint64_t magic;
+    uint64_t length;
+    uint32_t current;
+    std::memcpy(&magic, page->GetData() + MAGIC_OFFSET, sizeof(magic));
+    std::memcpy(&catalog_lsn, page->GetData() + CATALOG_LSN_OFFSET, sizeof(catalog_lsn));
+    std::memcpy(&length, page->GetData() + LENGTH_OFFSET, sizeof(length));
+    std::memcpy(&current, page->GetData() + CURRENT_OFFSET, sizeof(current));
+    Chain chain = ReadChain(page, current & 1);
+    buffer_pool_manager->UnpinPage(PAGE_ID, false);
+
+    catalog.clear();
+    if (magic == 0) {
+        catalog_lsn = INVALID_LSN;
+        return true;
+    }
+    if (magic != MAGIC) {
+        std::cerr << "Not a database file: page 0 is not a catalog page" << std::endl;
+        return false;
+    }
+    return OverflowChain::Read(buffer_pool_manager, chain.first_page, length, catalog);
+}
+
+bool CatalogPage::GetSpareChain(BufferPoolManager* buffer_pool_manager, Chain& chain) {
+    Page* page = buffer_pool_manager->FetchPage(PAGE_ID);
+    if (!page) {
+        return false;
+    }
+    uint64_t magic;
+    uint32_t current;
+    std::memcpy(&magic, page->GetData() + MAGIC_OFFSET, sizeof(magic));
+    std::memcpy(&current, page->GetData() + CURRENT_OFFSET, sizeof(current));
+    // The first catalog of a file goes to chain 0.
+    chain = magic == MAGIC ? ReadChain(page, (current & 1) ^ 1) : Chain();
+    buffer_pool_manager->UnpinPage(PAGE_ID, false);
+    return true;
+}
+
+bool CatalogPage::Switch(BufferPoolManager* buffer_pool_manager, const Chain& chain, size_t length,
+                         lsn_t catalog_lsn) {
+    Page* page = buffer_pool_manager->FetchPage(PAGE_ID);
+    if (!page) {
+        return false;
+    }
+    uint64_t magic;
+    uint32_t current;
+    std::memcpy(&magic, page->GetData() + MAGIC_OFFSET, sizeof(magic));
+    std::memcpy(&current, page->GetData() + CURRENT_OFFSET, sizeof(current));
+    current = magic == MAGIC ? (current & 1) ^ 1 : 0;
+
+    uint64_t stored_length = length;
+    char* slot = page->GetData() + CHAINS_OFFSET + current * CHAIN_SIZE;
+    std::memcpy(page->GetData() + MAGIC_OFFSET, &MAGIC, sizeof(MAGIC));
+    std::memcpy(page->GetData() + CATALOG_LSN_OFFSET, &catalog_lsn, sizeof(catalog_lsn));
+    std::memcpy(page->GetData() + LENGTH_OFFSET, &stored_length, sizeof(stored_length));
+    std::memcpy(page->GetData() + CURRENT_OFFSET, &current, sizeof(current));
+    std::memcpy(slot, &chain.first_page, sizeof(chain.first_page));
+    std::memcpy(slot + sizeof(chain.first_page), &chain.page_count, sizeof(chain.page_count));
+    buffer_pool_manager->UnpinPage(PAGE_ID, true);
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,36 @@
+#pragma once
+#include "buffer_pool_manager.h"
+#include "page.h"
+#include <string>
+#include <string_view>
+
+// Page 0 of a database file. It points to the catalog and holds the LSN of
+// the last log record the catalog and the pages it refers to reflect. Two
+// overflow chains take turns holding the catalog, so a checkpoint writes the
+// new one while page 0 still points to the old one, and no chain is freed:
+//   [lsn][magic][catalog lsn][catalog length][current chain]
+//   [chain 0 first page][chain 0 page count][chain 1 first page][chain 1 page count]
+class CatalogPage {
+public:
+    static constexpr page_id_t PAGE_ID = 0;
+
+    struct Chain {
+        page_id_t first_page{INVALID_PAGE_ID};
+        uint32_t page_count{0};
+    };
+
+    // Reserves page 0 of a new file.
+    static bool Initialize(BufferPoolManager* buffer_pool_manager);
+
+    // Reads the catalog into catalog. A file that was never checkpointed has
+    // an empty catalog; a page 0 of some other kind of file fails.
+    static bool Read(BufferPoolManager* buffer_pool_manager, std::string& catalog, lsn_t& catalog_lsn);
+
+    // The chain page 0 does not point to, for the next catalog. Pages that
+    // OverflowChain::Rewrite adds to it come off the free list unlogged:
+    // page 0 only refers to them from Switch on, after the checkpoint has
+    // written a free list without them.
+    static bool GetSpareChain(BufferPoolManager* buffer_pool_manager, Chain& chain);
+    // Points page 0 to the catalog written to chain.
+    static bool Switch(BufferPoolManager* buffer_pool_manager, const Chain& chain, size_t length, lsn_t catalog_lsn);
+};
\ No newline at end of file
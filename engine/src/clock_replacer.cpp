@@ -0,0 +1,59 @@
+#include "clock_replacer.h"
+
+ClockReplacer::ClockReplacer(size_t num_frames)
+    : evictable_(num_frames, 0), reference_(num_frames, 0) {}
+
+void ClockReplacer::Pin(frame_id_t frame_id) {
+    if (evictable_[frame_id]) {
+        evictable_[frame_id] = 0;
+        size_--;
+    }
+    reference_[frame_id] = 1;
+}
+
+void ClockReplacer::Unpin(frame_id_t frame_id) {
+    if (!evictable_[frame_id]) {
+        evictable_[frame_id] = 1;
+        size_++;
+    }
+}
+
+bool ClockReplacer::Victim(frame_id_t* frame_id) {
+    if (size_ == 0) {
+        return false;
+    }
+
+    // Every evictable frame is visited at most twice: once to clear its
+    // reference bit and once to evict it.
+    size_t num_frames = evictable_.size();
+    while (true) {
+        size_t candidate = hand_;
+        hand_ = (hand_ + 1) % num_frames;
+
+        if (!evictable_[candidate]) {
+            continue;
+        }
+        if (reference_[candidate]) {
+            reference_[candidate] = 0;
+            continue;
+        }
+
+        evictable_[candidate] = 0;
+        size_--;
+        *frame_id = static_cast<frame_id_t>(candidate);
+        return true;
+    }
+}
+
+void ClockReplacer::Remove(frame_id_t frame_id) {
+    if (evictable_[frame_id]) {
+        evictable_[frame_id] = 0;
+        size_--;
+    }
+    reference_[frame_id] = 0;
+}
+
+void ClockReplacer::Resize(size_t num_frames) {
+    evictable_.resize(num_frames, 0);
+    reference_.resize(num_frames, 0);
+}
\ No newline at end of file
@@ -0,0 +1,22 @@
+#pragma once
+#include "replacer.h"
+#include <vector>
+
+class ClockReplacer : public Replacer {
+public:
+    explicit ClockReplacer(size_t num_frames);
+    ~ClockReplacer() override = default;
+
+    void Pin(frame_id_t frame_id) override;
+    void Unpin(frame_id_t frame_id) override;
+    bool Victim(frame_id_t* frame_id) override;
+    void Remove(frame_id_t frame_id) override;
+    size_t Size() const override { return size_; }
+    void Resize(size_t num_frames) override;
+
+private:
+    std::vector<uint8_t> evictable_;
+    std::vector<uint8_t> reference_;
+    size_t hand_{0};
+    size_t size_{0};
+};
\ No newline at end of file
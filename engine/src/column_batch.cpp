@@ -0,0 +1,134 @@
+#include "column_batch.h"
+#include "overflow_chain.h"
+#include <algorithm>
+#include <cstring>
+
+Value ColumnVector::ValueAt(size_t row) const {
+    switch (static_cast<ValueTag>(tags[row])) {
+        case ValueTag::DOUBLE:
+            return doubles[row];
+        case ValueTag::STRING:
+            return std::string(StringAt(row));
+        case ValueTag::INT:
+        default:
+            return ints[row];
+    }
+}
+
+ColumnBatch::ColumnBatch(size_t column_count) : columns_(column_count) {
+    Clear();
+}
+
+void ColumnBatch::Clear() {
+    size_ = 0;
+    selected_ = 0;
+    for (auto& column : columns_) {
+        column.offsets[0] = 0;
+        column.chars.clear();
+    }
+}
+
+void ColumnBatch::AppendSerialized(const char* data, const RowFormat& format, const std::vector<bool>& needed,
+                                   BufferPoolManager* buffer_pool_manager) {
+    size_t row = size_++;
+    for (auto& column : columns_) {
+        column.ints[row] = 0;
+        column.doubles[row] = 0;
+        column.tags[row] = static_cast<uint8_t>(ValueTag::INT);
+    }
+
+    format.Visit(data, &needed, [&](size_t index, const auto& value) {
+        if (index >= columns_.size()) {
+            return;
+        }
+        ColumnVector& column = columns_[index];
+        using T = std::decay_t<decltype(value)>;
+        if constexpr (std::is_same_v<T, int>) {
+            column.ints[row] = value;
+        } else if constexpr (std::is_same_v<T, double>) {
+            column.doubles[row] = value;
+            column.tags[row] = static_cast<uint8_t>(ValueTag::DOUBLE);
+        } else if constexpr (std::is_same_v<T, OverflowRef>) {
+            column.chars.append(value.prefix);
+            OverflowChain::Read(buffer_pool_manager, value.page, value.length - value.prefix.size(), column.chars);
+            column.tags[row] = static_cast<uint8_t>(ValueTag::STRING);
+        } else {
+            column.chars.append(value);
+            column.tags[row] = static_cast<uint8_t>(ValueTag::STRING);
+        }
+    });
+
+    for (auto& column : columns_) {
+        column.offsets[row + 1] = static_cast<uint32_t>(column.chars.size());
+    }
+}
+
+void ColumnBatch::AppendLeaf(const LeafNodeView& leaf, int index, size_t count, const std::vector<bool>& needed,
+                             BufferPoolManager* buffer_pool_manager) {
+    size_t first = size_;
+    size_ += count;
+    int leaf_columns = leaf.GetColumnCount();
+
+    for (size_t c = 0; c < columns_.size(); ++c) {
+        if (!needed[c]) {
+            continue;
+        }
+        ColumnVector& column = columns_[c];
+        if (static_cast<int>(c) >= leaf_columns) {
+            std::fill_n(column.ints.begin() + first, count, 0);
+            std::fill_n(column.tags.begin() + first, count, static_cast<uint8_t>(ValueTag::INT));
+            std::fill_n(column.offsets.begin() + first + 1, count, static_cast<uint32_t>(column.chars.size()));
+            continue;
+        }
+
+        Minipage minipage = leaf.MinipageAt(static_cast<int>(c));
+        if (minipage.kind == Minipage::INT) {
+            std::memcpy(column.ints.data() + first, minipage.data + sizeof(int) * index, sizeof(int) * count);
+        } else if (minipage.kind == Minipage::DOUBLE) {
+            std::memcpy(column.doubles.data() + first, minipage.data + sizeof(double) * index,
+                        sizeof(double) * count);
+        }
+        if (minipage.kind != Minipage::VARIABLE) {
+            std::fill_n(column.tags.begin() + first, count, static_cast<uint8_t>(minipage.kind));
+            std::fill_n(column.offsets.begin() + first + 1, count, static_cast<uint32_t>(column.chars.size()));
+            continue;
+        }
+
+        for (size_t i = 0; i < count; ++i) {
+            size_t row = first + i;
+            int entry = index + static_cast<int>(i);
+            uint8_t type = minipage.TypeAt(entry);
+            std::string_view bytes = minipage.BytesAt(entry);
+            column.tags[row] = type;
+            if (type == static_cast<uint8_t>(ValueTag::INT)) {
+                std::memcpy(&column.ints[row], bytes.data(), sizeof(int));
+            } else if (type == static_cast<uint8_t>(ValueTag::DOUBLE)) {
+                std::memcpy(&column.doubles[row], bytes.data(), sizeof(double));
+            } else if (type == 3) {
+                OverflowRef ref = OverflowRef::Decode(bytes);
+                column.chars.append(ref.prefix);
+                OverflowChain::Read(buffer_pool_manager, ref.page, ref.length - ref.prefix.size(), column.chars);
+                column.tags[row] = static_cast<uint8_t>(ValueTag::STRING);
+            } else {
+                column.chars.append(bytes);
+            }
+            column.offsets[row + 1] = static_cast<uint32_t>(column.chars.size());
+        }
+    }
+}
+
+Record ColumnBatch::GetRow(size_t row) const {
+    Record record;
+    for (const auto& column : columns_) {
+        record.AddValue(column.ValueAt(row));
+    }
+    return record;
+}
+
+Record ColumnBatch::GetRow(size_t row, const std::vector<int>& columns) const {
+    Record record;
+    for (int column : columns) {
+        record.AddValue(columns_[column].ValueAt(row));
+    }
+    return record;
+}
\ No newline at end of file
@@ -0,0 +1,71 @@
+#pragma once
+#include "btree_page.h"
+#include "buffer_pool_manager.h"
+#include "record.h"
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+constexpr size_t BATCH_SIZE = 1024;
+
+// Type of a value in a batch, numbered as in the serialized record format.
+enum class ValueTag : uint8_t {
+    INT = 0,
+    DOUBLE = 1,
+    STRING = 2
+};
+
+// One column of a batch. Each row has a tag and a slot in every typed array,
+// of which only the slot matching the tag is meaningful. String bytes are
+// stored back to back; row i spans [offsets[i], offsets[i + 1]).
+struct ColumnVector {
+    alignas(32) std::array<int32_t, BATCH_SIZE> ints;
+    alignas(32) std::array<double, BATCH_SIZE> doubles;
+    alignas(32) std::array<uint8_t, BATCH_SIZE> tags;
+    std::array<uint32_t, BATCH_SIZE + 1> offsets;
+    std::string chars;
+
+    std::string_view StringAt(size_t row) const {
+        return std::string_view(chars.data() + offsets[row], offsets[row + 1] - offsets[row]);
+    }
+    Value ValueAt(size_t row) const;
+};
+
+// Up to BATCH_SIZE rows decoded column by column, with a selection vector
+// listing the rows that survived filtering.
+class ColumnBatch {
+public:
+    explicit ColumnBatch(size_t column_count);
+    ~ColumnBatch() = default;
+
+    void Clear();
+    bool IsFull() const { return size_ == BATCH_SIZE; }
+    size_t GetSize() const { return size_; }
+    size_t GetColumnCount() const { return columns_.size(); }
+    const ColumnVector& GetColumn(size_t column) const { return columns_[column]; }
+
+    // Decodes one record encoded in format into the next row, reading only
+    // the columns set in needed; the others, and missing values, read as 0.
+    // Overflowed strings are read from their overflow pages.
+    void AppendSerialized(const char* data, const RowFormat& format, const std::vector<bool>& needed,
+                          BufferPoolManager* buffer_pool_manager);
+    // Decodes count entries of a PAX leaf from index on, copying only the
+    // minipages of the columns set in needed; other columns are left unset.
+    void AppendLeaf(const LeafNodeView& leaf, int index, size_t count, const std::vector<bool>& needed,
+                    BufferPoolManager* buffer_pool_manager);
+    Record GetRow(size_t row) const;
+    Record GetRow(size_t row, const std::vector<int>& columns) const;
+
+    uint16_t* GetSelection() { return selection_.data(); }
+    const uint16_t* GetSelection() const { return selection_.data(); }
+    size_t GetSelectedCount() const { return selected_; }
+    void SetSelectedCount(size_t count) { selected_ = count; }
+
+private:
+    std::vector<ColumnVector> columns_;
+    size_t size_{0};
+    std::array<uint16_t, BATCH_SIZE> selection_;
+    size_t selected_{0};
+};
\ No newline at end of file
@@ -0,0 +1,50 @@
+#pragma once
+#include <cstdint>
+#include <string_view>
+
+enum class CompareOp : uint8_t {
+    EQ,
+    NE,
+    LT,
+    LE,
+    GT,
+    GE
+};
+
+constexpr size_t COMPARE_OP_COUNT = 6;
+
+inline bool ToCompareOp(std::string_view op, CompareOp& compare_op) {
+    if (op == "=") {
+        compare_op = CompareOp::EQ;
+    } else if (op == "!=" || op == "<>") {
+        compare_op = CompareOp::NE;
+    } else if (op == "<") {
+        compare_op = CompareOp::LT;
+    } else if (op == "<=") {
+        compare_op = CompareOp::LE;
+    } else if (op == ">") {
+        compare_op = CompareOp::GT;
+    } else if (op == ">=") {
+        compare_op = CompareOp::GE;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+template <CompareOp OP, typename T>
+inline bool Compare(const T& a, const T& b) {
+    if constexpr (OP == CompareOp::EQ) {
+        return a == b;
+    } else if constexpr (OP == CompareOp::NE) {
+        return a != b;
+    } else if constexpr (OP == CompareOp::LT) {
+        return a < b;
+    } else if constexpr (OP == CompareOp::LE) {
+        return a <= b;
+    } else if constexpr (OP == CompareOp::GT) {
+        return a > b;
+    } else {
+        return a >= b;
+    }
+}
\ No newline at end of file
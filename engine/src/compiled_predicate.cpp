@@ -0,0 +1,66 @@
+#include "compiled_predicate.h"
+#include <string>
+
+template <typename T, CompareOp OP>
+static bool CompareValue(const Value& value, const Value& constant) {
+    const T* typed = std::get_if<T>(&value);
+    return typed && Compare<OP>(*typed, *std::get_if<T>(&constant));
+}
+
+static bool Never(const Value&, const Value&) {
+    return false;
+}
+
+template <typename T>
+static constexpr bool (*COMPARATORS_FOR[COMPARE_OP_COUNT])(const Value&, const Value&) = {
+    CompareValue<T, CompareOp::EQ>, CompareValue<T, CompareOp::NE>, CompareValue<T, CompareOp::LT>,
+    CompareValue<T, CompareOp::LE>, CompareValue<T, CompareOp::GT>, CompareValue<T, CompareOp::GE>,
+};
+
+// Indexed by the variant index of the constant, then by operator.
+static constexpr bool (*const* COMPARATORS[])(const Value&, const Value&) = {
+    COMPARATORS_FOR<int>,
+    COMPARATORS_FOR<double>,
+    COMPARATORS_FOR<std::string>,
+};
+
+void CompiledPredicate::AddTerm(int column, CompareOp op, const Value& constant) {
+    Comparator compare = column < 0 ? Never : SelectComparator(op, constant);
+    terms_.push_back(Term{column < 0 ? 0 : static_cast<size_t>(column), compare, constant});
+}
+
+void CompiledPredicate::EndGroup() {
+    if (group_ends_.empty() ? !terms_.empty() : group_ends_.back() != terms_.size()) {
+        group_ends_.push_back(terms_.size());
+    }
+}
+
+bool CompiledPredicate::Evaluate(const Record& record) const {
+    static const Value missing = 0;
+    const auto& values = record.GetValues();
+    if (terms_.empty()) {
+        return true;
+    }
+
+    size_t term = 0;
+    for (size_t group = 0; group <= group_ends_.size(); ++group) {
+        size_t group_end = group < group_ends_.size() ? group_ends_[group] : terms_.size();
+        if (term == group_end) {
+            continue;
+        }
+        bool matched = true;
+        for (; term < group_end && matched; ++term) {
+            const Term& t = terms_[term];
+            matched = t.compare(t.column < values.size() ? values[t.column] : missing, t.constant);
+        }
+        if (matched) {
+            return true;
+        }
+        term = group_end;
+    }
+    return false;
+}
+
+CompiledPredicate::Comparator CompiledPredicate::SelectComparator(CompareOp op, const Value& constant) {
+    return COMPARATORS[constant.index()][static_cast<size_t>(op)];
+}
\ No newline at end of file
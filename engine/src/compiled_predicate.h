@@ -0,0 +1,38 @@
+#pragma once
+#include "compare_op.h"
+#include "record.h"
+#include <vector>
+
+// WHERE clause bound to column ordinals and constants, in disjunctive normal
+// form: groups of terms that must all hold, any one of which satisfies the
+// predicate. Each term calls a comparator specialized for the type of its
+// constant and its operator, picked once when the term is added, so
+// evaluating a row does no name lookup, operator parsing or type dispatch
+// beyond one tag check per term.
+class CompiledPredicate {
+public:
+    CompiledPredicate() = default;
+    ~CompiledPredicate() = default;
+
+    // A negative column never matches, like a condition on an unknown column.
+    void AddTerm(int column, CompareOp op, const Value& constant);
+    // Closes the current group; the next term starts a new one.
+    void EndGroup();
+
+    bool IsEmpty() const { return terms_.empty(); }
+    bool Evaluate(const Record& record) const;
+
+private:
+    using Comparator = bool (*)(const Value& value, const Value& constant);
+
+    struct Term {
+        size_t column;
+        Comparator compare;
+        Value constant;
+    };
+
+    std::vector<Term> terms_;
+    std::vector<size_t> group_ends_;
+
+    static Comparator SelectComparator(CompareOp op, const Value& constant);
+};
\ No newline at end of file
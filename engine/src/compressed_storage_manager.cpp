@@ -0,0 +1,293 @@
+#include "compressed_storage_manager.h"
+#include "lz4_codec.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <iostream>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+// Map entries pack an extent's first unit above its stored length.
+constexpr int LENGTH_BITS = 13;
+
+uint64_t ElapsedNanos(std::chrono::steady_clock::time_point start) {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+}
+
+}  // namespace
+
+CompressedStorageManager::CompressedStorageManager(const std::string& db_file) : StorageManager(db_file) {
+    free_runs_.resize(PAGE_UNITS + 1);
+    if (OpenFile(0) && !Load()) {
+        std::cerr << "Not a compressed database file: " << db_file << std::endl;
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+bool CompressedStorageManager::ReadPage(page_id_t page_id, char* data) {
+    Extent extent;
+    {
+        std::lock_guard<std::mutex> guard(latch_);
+        if (page_id >= extents_.size()) {
+            std::memset(data, 0, PAGE_SIZE);
+            return false;
+        }
+        extent = extents_[page_id];
+    }
+
+    if (extent.length == 0) {
+        std::memset(data, 0, PAGE_SIZE);
+        return true;
+    }
+    if (extent.length == PAGE_SIZE) {
+        pages_read_++;
+        return ReadAt(extent.unit, data, PAGE_SIZE);
+    }
+
+    thread_local char buffer[PAGE_SIZE];
+    if (!ReadAt(extent.unit, buffer, extent.length)) {
+        std::memset(data, 0, PAGE_SIZE);
+        return false;
+    }
+    auto start = std::chrono::steady_clock::now();
+    bool decoded = Lz4Codec::Decompress(buffer, extent.length, data, PAGE_SIZE);
+    decompress_ns_ += ElapsedNanos(start);
+    pages_read_++;
+    if (!decoded) {
+        std::cerr << "Corrupt compressed page " << page_id << " in " << db_file_ << std::endl;
+        std::memset(data, 0, PAGE_SIZE);
+    }
+    return decoded;
+}
+
+bool CompressedStorageManager::WritePage(page_id_t page_id, const char* data) {
+    // Only a page that saves at least one unit is kept compressed.
+    thread_local char buffer[PAGE_SIZE];
+    auto start = std::chrono::steady_clock::now();
+    size_t length = Lz4Codec::Compress(data, PAGE_SIZE, buffer, PAGE_SIZE - EXTENT_UNIT);
+    compress_ns_ += ElapsedNanos(start);
+    const char* bytes = buffer;
+    if (length == 0) {
+        length = PAGE_SIZE;
+        bytes = data;
+    }
+
+    size_t units = UnitsFor(length);
+    uint64_t unit;
+    {
+        std::lock_guard<std::mutex> guard(latch_);
+        if (page_id >= extents_.size()) {
+            return false;
+        }
+        unit = AllocateUnits(units);
+    }
+
+    bool written = WriteAt(unit, bytes, length);
+    std::lock_guard<std::mutex> guard(latch_);
+    if (!written) {
+        FreeUnits(unit, units);
+        return false;
+    }
+    Extent& extent = extents_[page_id];
+    if (extent.length > 0) {
+        replaced_.push_back(extent);
+    }
+    extent = Extent{unit, static_cast<uint32_t>(length)};
+    pages_written_++;
+    stored_bytes_ += length;
+    return true;
+}
+
+page_id_t CompressedStorageManager::AllocatePage() {
+    // The file only grows when a page is written.
+    std::lock_guard<std::mutex> guard(latch_);
+    page_id_t page_id = next_page_id_.fetch_add(1);
+    extents_.resize(static_cast<size_t>(page_id) + 1);
+    return page_id;
+}
+
+bool CompressedStorageManager::Sync() {
+    std::lock_guard<std::mutex> sync_guard(sync_latch_);
+    std::string map;
+    std::vector<Extent> replaced;
+    Extent map_extent;
+    {
+        std::lock_guard<std::mutex> guard(latch_);
+        map.resize(extents_.size() * sizeof(uint64_t));
+        for (size_t i = 0; i < extents_.size(); ++i) {
+            uint64_t entry = (extents_[i].unit << LENGTH_BITS) | extents_[i].length;
+            std::memcpy(map.data() + i * sizeof(entry), &entry, sizeof(entry));
+        }
+        replaced.swap(replaced_);
+        map_extent = Extent{AllocateUnits(UnitsFor(map.size())), static_cast<uint32_t>(map.size())};
+    }
+
+    HeaderSlot slot{HEADER_MAGIC, generation_ + 1, map.size() / sizeof(uint64_t), map_extent.unit,
+                    map_extent.length, Checksum(map.data(), map.size()), 0};
+    slot.checksum = Checksum(reinterpret_cast<const char*>(&slot), offsetof(HeaderSlot, checksum));
+    char header[EXTENT_UNIT] = {};
+    std::memcpy(header, &slot, sizeof(slot));
+
+    // The map and the pages it points to must be on disk before the header
+    // that switches to them.
+    bool synced = WriteAt(map_extent.unit, map.data(), map.size()) && StorageManager::Sync() &&
+                  WriteAt(slot.generation % HEADER_UNITS, header, sizeof(header)) && StorageManager::Sync();
+
+    std::lock_guard<std::mutex> guard(latch_);
+    if (!synced) {
+        FreeUnits(map_extent.unit, UnitsFor(map_extent.length));
+        replaced_.insert(replaced_.end(), replaced.begin(), replaced.end());
+        return false;
+    }
+    for (const auto& extent : replaced) {
+        FreeUnits(extent.unit, UnitsFor(extent.length));
+    }
+    FreeUnits(map_extent_.unit, UnitsFor(map_extent_.length));
+    map_extent_ = map_extent;
+    generation_ = slot.generation;
+    return true;
+}
+
+StorageStats CompressedStorageManager::GetStats() const {
+    StorageStats stats;
+    stats.pages_read = pages_read_.load();
+    stats.pages_written = pages_written_.load();
+    stats.stored_bytes = stored_bytes_.load();
+    stats.compress_ns = compress_ns_.load();
+    stats.decompress_ns = decompress_ns_.load();
+    return stats;
+}
+
+bool CompressedStorageManager::Load() {
+    struct stat file_stat;
+    if (::fstat(fd_, &file_stat) != 0) {
+        return false;
+    }
+    next_page_id_ = 0;
+    if (file_stat.st_size == 0) {
+        return true;
+    }
+
+    // A file that was never synced has pages but no header yet, and reads
+    // as empty.
+    HeaderSlot current{};
+    bool blank = true;
+    for (uint64_t unit = 0; unit < HEADER_UNITS; ++unit) {
+        HeaderSlot slot{};
+        ReadAt(unit, reinterpret_cast<char*>(&slot), sizeof(slot));
+        blank = blank && slot.magic == 0;
+        if (slot.magic == HEADER_MAGIC &&
+            slot.checksum == Checksum(reinterpret_cast<const char*>(&slot), offsetof(HeaderSlot, checksum)) &&
+            slot.generation > current.generation) {
+            current = slot;
+        }
+    }
+    if (current.magic != HEADER_MAGIC) {
+        return blank;
+    }
+
+    std::string map(current.map_bytes, '\0');
+    if (!ReadAt(current.map_unit, map.data(), map.size()) || Checksum(map.data(), map.size()) != current.map_checksum) {
+        return false;
+    }
+    extents_.resize(current.page_count);
+    std::vector<std::pair<uint64_t, uint64_t>> used{{0, HEADER_UNITS}};
+    for (size_t i = 0; i < extents_.size(); ++i) {
+        uint64_t entry;
+        std::memcpy(&entry, map.data() + i * sizeof(entry), sizeof(entry));
+        extents_[i] = Extent{entry >> LENGTH_BITS, static_cast<uint32_t>(entry & ((1u << LENGTH_BITS) - 1))};
+        if (extents_[i].length > 0) {
+            used.emplace_back(extents_[i].unit, UnitsFor(extents_[i].length));
+        }
+    }
+    map_extent_ = Extent{current.map_unit, static_cast<uint32_t>(current.map_bytes)};
+    used.emplace_back(map_extent_.unit, UnitsFor(map_extent_.length));
+    generation_ = current.generation;
+    next_page_id_ = static_cast<page_id_t>(current.page_count);
+
+    // Whatever no extent of the current map covers is free, including
+    // anything written after the last Sync.
+    std::sort(used.begin(), used.end());
+    end_unit_ = 0;
+    for (const auto& [unit, units] : used) {
+        if (unit > end_unit_) {
+            FreeUnits(end_unit_, unit - end_unit_);
+        }
+        end_unit_ = std::max(end_unit_, unit + units);
+    }
+    return true;
+}
+
+bool CompressedStorageManager::ReadAt(uint64_t unit, char* data, size_t length) {
+    off_t offset = static_cast<off_t>(unit * EXTENT_UNIT);
+    size_t read_bytes = 0;
+    while (read_bytes < length) {
+        ssize_t n = ::pread(fd_, data + read_bytes, length - read_bytes, offset + read_bytes);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        read_bytes += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool CompressedStorageManager::WriteAt(uint64_t unit, const char* data, size_t length) {
+    off_t offset = static_cast<off_t>(unit * EXTENT_UNIT);
+    size_t written = 0;
+    while (written < length) {
+        ssize_t n = ::pwrite(fd_, data + written, length - written, offset + written);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        written += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+uint64_t CompressedStorageManager::AllocateUnits(size_t units) {
+    if (units == 0) {
+        return 0;
+    }
+    for (size_t run = units; run <= PAGE_UNITS; ++run) {
+        if (free_runs_[run].empty()) {
+            continue;
+        }
+        uint64_t unit = free_runs_[run].back();
+        free_runs_[run].pop_back();
+        if (run > units) {
+            free_runs_[run - units].push_back(unit + units);
+        }
+        return unit;
+    }
+    uint64_t unit = end_unit_;
+    end_unit_ += units;
+    return unit;
+}
+
+void CompressedStorageManager::FreeUnits(uint64_t unit, size_t units) {
+    while (units > 0) {
+        size_t run = std::min(units, PAGE_UNITS);
+        free_runs_[run].push_back(unit);
+        unit += run;
+        units -= run;
+    }
+}
+
+uint64_t CompressedStorageManager::Checksum(const char* data, size_t size) {
+    // FNV-1a
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ static_cast<unsigned char>(data[i])) * 1099511628211ULL;
+    }
+    return hash;
+}
\ No newline at end of file
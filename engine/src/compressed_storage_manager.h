@@ -0,0 +1,72 @@
+#pragma once
+#include "storage_manager.h"
+#include <vector>
+
+// Keeps each page compressed with Lz4Codec in an extent of whole EXTENT_UNIT
+// blocks anywhere in the file, found through a page map. Pages that would
+// not save a unit are stored as is. Writes never go to an extent the last
+// synced map points to: Sync writes the map to a new extent and switches to
+// it through one of two header slots at the start of the file, so after a
+// crash the file reads as of the last Sync.
+class CompressedStorageManager : public StorageManager {
+public:
+    static constexpr size_t EXTENT_UNIT = 512;
+    static constexpr size_t PAGE_UNITS = PAGE_SIZE / EXTENT_UNIT;
+
+    explicit CompressedStorageManager(const std::string& db_file);
+    ~CompressedStorageManager() override = default;
+
+    bool ReadPage(page_id_t page_id, char* data) override;
+    bool WritePage(page_id_t page_id, const char* data) override;
+    page_id_t AllocatePage() override;
+    bool Sync() override;
+    StorageStats GetStats() const override;
+    bool StoresPagesInPlace() const override { return false; }
+
+private:
+    static constexpr uint64_t HEADER_MAGIC = 0x314D504453425A4CULL;
+    static constexpr size_t HEADER_UNITS = 2;  // slot i is unit i
+
+    struct HeaderSlot {
+        uint64_t magic;
+        uint64_t generation;  // the slot with the higher one is current
+        uint64_t page_count;
+        uint64_t map_unit;
+        uint64_t map_bytes;
+        uint64_t map_checksum;
+        uint64_t checksum;    // of the fields above
+    };
+
+    // Stored length in bytes: PAGE_SIZE for an uncompressed page, 0 for a
+    // page that was allocated but never written.
+    struct Extent {
+        uint64_t unit{0};
+        uint32_t length{0};
+    };
+
+    std::mutex latch_;       // guards everything below but the counters
+    std::mutex sync_latch_;  // one Sync at a time
+    std::vector<Extent> extents_;
+    std::vector<std::vector<uint64_t>> free_runs_;  // first units of free runs, by length in units
+    uint64_t end_unit_{HEADER_UNITS};
+    std::vector<Extent> replaced_;  // since the last Sync, so possibly in the synced map
+    Extent map_extent_;
+    uint64_t generation_{0};
+
+    std::atomic<uint64_t> pages_read_{0};
+    std::atomic<uint64_t> pages_written_{0};
+    std::atomic<uint64_t> stored_bytes_{0};
+    std::atomic<uint64_t> compress_ns_{0};
+    std::atomic<uint64_t> decompress_ns_{0};
+
+    bool Load();
+    bool ReadAt(uint64_t unit, char* data, size_t length);
+    bool WriteAt(uint64_t unit, const char* data, size_t length);
+    // Callers hold latch_. Free runs are kept in pieces of at most a page
+    // and are not merged again.
+    uint64_t AllocateUnits(size_t units);
+    void FreeUnits(uint64_t unit, size_t units);
+
+    static size_t UnitsFor(size_t bytes) { return (bytes + EXTENT_UNIT - 1) / EXTENT_UNIT; }
+    static uint64_t Checksum(const char* data, size_t size);
+};
\ No newline at end of file
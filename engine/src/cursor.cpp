@@ -0,0 +1,83 @@
+#include "cursor.h"
+#include "secondary_index.h"
+
+Cursor::Cursor(BTreeIterator iterator, CompiledPredicate predicate, std::vector<int> columns, std::mutex* latch)
+    : iterator_(std::move(iterator)), predicate_(std::move(predicate)), columns_(std::move(columns)),
+      latch_(latch) {}
+
+Cursor::Cursor(BTreeIterator iterator, BTree* table, CompiledPredicate predicate, std::vector<int> columns,
+               std::mutex* latch)
+    : iterator_(std::move(iterator)), table_(table), predicate_(std::move(predicate)),
+      columns_(std::move(columns)), latch_(latch) {}
+
+Cursor::Cursor(std::unique_ptr<ExternalSort> sort, std::vector<int> columns)
+    : sort_(std::move(sort)), columns_(std::move(columns)) {}
+
+void Cursor::SetLimit(size_t offset, size_t limit) {
+    offset_ = offset;
+    limit_ = limit;
+}
+
+bool Cursor::Next(Record& record) {
+    for (; offset_ > 0; --offset_) {
+        if (!NextRow(record)) {
+            return false;
+        }
+    }
+    if (limit_ == 0 || !NextRow(record)) {
+        return false;
+    }
+    limit_--;
+    return true;
+}
+
+bool Cursor::NextRow(Record& record) {
+    if (sort_) {
+        Record row;
+        if (!sort_->Next(row)) {
+            return false;
+        }
+        record = Project(std::move(row));
+        return true;
+    }
+
+    std::unique_lock<std::mutex> lock;
+    if (latch_) {
+        lock = std::unique_lock<std::mutex>(*latch_);
+    }
+
+    if (started_) {
+        iterator_.Next();
+    }
+    started_ = true;
+
+    while (!iterator_.IsEnd()) {
+        Record candidate;
+        if (table_) {
+            if (!table_->Search(SecondaryIndex::PrimaryKeyOf(iterator_.GetKey()), candidate)) {
+                iterator_.Next();
+                continue;
+            }
+        } else {
+            candidate = iterator_.GetRecord();
+        }
+        if (!predicate_.Evaluate(candidate)) {
+            iterator_.Next();
+            continue;
+        }
+        record = Project(std::move(candidate));
+        return true;
+    }
+    return false;
+}
+
+Record Cursor::Project(Record row) const {
+    if (columns_.empty()) {
+        return row;
+    }
+    Record record;
+    for (int column : columns_) {
+        record.AddValue(row.GetValue(column));
+    }
+    return record;
+}
\ No newline at end of file
@@ -0,0 +1,45 @@
+#pragma once
+#include "btree.h"
+#include "btree_iterator.h"
+#include "compiled_predicate.h"
+#include "external_sort.h"
+#include "record.h"
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Pull-based result set over a B+tree scan. Rows are produced one at a time,
+// so memory use does not depend on the size of the result. A cursor must not
+// outlive the Database that opened it. Rows are cut down to columns, in that
+// order, unless it is empty.
+class Cursor {
+public:
+    Cursor(BTreeIterator iterator, CompiledPredicate predicate, std::vector<int> columns = {},
+           std::mutex* latch = nullptr);
+    // Cursor over a secondary index scan; each entry is looked up in table.
+    Cursor(BTreeIterator iterator, BTree* table, CompiledPredicate predicate, std::vector<int> columns = {},
+           std::mutex* latch = nullptr);
+    // Cursor over the output of a finished sort, which it owns; it holds no
+    // more rows in memory than the sort was given budget for.
+    Cursor(std::unique_ptr<ExternalSort> sort, std::vector<int> columns = {});
+    ~Cursor() = default;
+
+    // Skips the first offset rows and stops after limit more.
+    void SetLimit(size_t offset, size_t limit);
+    bool Next(Record& record);
+
+private:
+    BTreeIterator iterator_;
+    BTree* table_{nullptr};
+    CompiledPredicate predicate_;
+    std::unique_ptr<ExternalSort> sort_;
+    std::vector<int> columns_;
+    std::mutex* latch_{nullptr};
+    bool started_{false};
+    size_t offset_{0};
+    size_t limit_{SIZE_MAX};
+
+    bool NextRow(Record& record);
+    Record Project(Record row) const;
+};
\ No newline at end of file
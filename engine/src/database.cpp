@@ -1,150 +1,1183 @@
 #include "database.h"
 #include <iostream>
+#include <fstream>
+#include <climits>
+#include <cstring>
+#include <algorithm>
+#include <iterator>
 
-Database::Database(const std::string& db_file) {
-    storage_manager_ = std::make_unique<StorageManager>(db_file);
-    buffer_pool_manager_ = std::make_unique<BufferPoolManager>(50, storage_manager_.get());
+Database::Database(const std::string& db_file, const DatabaseOptions& options) : options_(options) {
+    storage_manager_ = StorageManager::Open(db_file, options.storage_backend);
+    log_manager_ = std::make_unique<LogManager>(db_file + ".wal");
+    hot_pages_file_ = db_file + ".hot";
+    buffer_pool_manager_ = std::make_unique<BufferPoolManager>(options.buffer_pool_frames, storage_manager_.get(),
+                                                               options.replacer_type, log_manager_.get());
     parser_ = std::make_unique<SQLParser>();
+    plan_cache_ = std::make_unique<PlanCache>(options.plan_cache_size);
+    if (storage_manager_->GetFileDescriptor() < 0) {
+        return;
+    }
+    if (storage_manager_->GetPageCount() == 0) {
+        CatalogPage::Initialize(buffer_pool_manager_.get());
+    }
+
+    // A scan worker pins one page at a time. Keeping them to half of a shard
+    // leaves frames for the other readers even if all their pages collide.
+    size_t shard_frames = buffer_pool_manager_->GetPoolSize() / buffer_pool_manager_->GetShardCount();
+    size_t scan_threads = std::min(options.scan_threads, shard_frames / 2);
+    if (scan_threads > 1) {
+        scan_pool_ = std::make_unique<WorkerPool>(scan_threads);
+    }
+    // A file that does not open as a database is left alone: no statement
+    // runs against it, and closing it writes no checkpoint over its page 0.
+    open_ = Recover();
+    if (!open_) {
+        return;
+    }
+
+    if (options.warm_restart != WarmRestart::OFF) {
+        LoadHotPages();
+        warm_restart_pages_ = buffer_pool_manager_->WarmUp(hot_pages_);
+        if (options.warm_restart == WarmRestart::BLOCKING) {
+            buffer_pool_manager_->WaitForReads();
+        }
+        hot_pages_.clear();
+    }
+    if (options.hot_pages_save_seconds > 0) {
+        hot_pages_thread_ = std::thread(&Database::SaveHotPagesLoop, this);
+    }
+}
+
+Database::~Database() {
+    if (hot_pages_thread_.joinable()) {
+        {
+            std::lock_guard<std::mutex> guard(hot_pages_latch_);
+            stop_saving_ = true;
+        }
+        hot_pages_cv_.notify_all();
+        hot_pages_thread_.join();
+    }
+    if (open_) {
+        Checkpoint();
+    }
 }
 
 bool Database::ExecuteQuery(const std::string& sql) {
-    auto query = parser_->Parse(sql);
-    if (!query) {
-        std::cerr << "Failed to parse query: " << sql << std::endl;
+    std::vector<Value> literals;
+    auto plan = GetPlan(sql, &literals);
+    if (!plan) {
         return false;
     }
+    return ExecutePlan(plan, literals);
+}
+
+std::unique_ptr<Cursor> Database::Query(const std::string& sql) {
+    std::vector<Value> literals;
+    auto plan = GetPlan(sql, &literals);
+    if (!plan) {
+        return nullptr;
+    }
+    return QueryPlan(plan, literals);
+}
+
+std::unique_ptr<PreparedStatement> Database::Prepare(const std::string& sql) {
+    auto plan = GetPlan(sql, nullptr);
+    if (!plan) {
+        return nullptr;
+    }
+    return std::make_unique<PreparedStatement>(this, std::move(plan));
+}
 
-    last_results_.clear();
+bool Database::Checkpoint() {
+    if (!open_) {
+        std::cerr << "Database is not open" << std::endl;
+        return false;
+    }
 
-    switch (query->type) {
-        case QueryType::SELECT:
-            return ExecuteSelect(*query);
-        case QueryType::INSERT:
-            return ExecuteInsert(*query);
-        case QueryType::CREATE_TABLE:
-            return ExecuteCreateTable(*query);
-        default:
-            std::cerr << "Unsupported query type" << std::endl;
+    // Page 0 switches to the new catalog only once the catalog and every
+    // page it refers to are on disk. The catalog holds the free list, so it
+    // is written again if its chain had to take pages off the list.
+    CatalogPage::Chain chain;
+    if (!CatalogPage::GetSpareChain(buffer_pool_manager_.get(), chain)) {
+        std::cerr << "Checkpoint failed to read the catalog page" << std::endl;
+        return false;
+    }
+    // Saved before the catalog is written, so the pages that takes do not
+    // crowd out the working set.
+    SaveHotPages();
+    lsn_t catalog_lsn = log_manager_->GetAppendedLSN();
+    std::vector<page_id_t> free_pages;
+    std::string catalog;
+    uint32_t page_count;
+    do {
+        page_count = chain.page_count;
+        free_pages = buffer_pool_manager_->GetFreePages();
+        catalog = SerializeCatalog(free_pages);
+        if (!OverflowChain::Rewrite(buffer_pool_manager_.get(), catalog, chain.first_page, chain.page_count)) {
+            std::cerr << "Checkpoint failed to write the catalog" << std::endl;
             return false;
+        }
+    } while (chain.page_count != page_count);
+
+    if (!buffer_pool_manager_->FlushAllPages() || !storage_manager_->Sync()) {
+        std::cerr << "Checkpoint failed to write back dirty pages" << std::endl;
+        return false;
+    }
+    if (!CatalogPage::Switch(buffer_pool_manager_.get(), chain, catalog.size(), catalog_lsn) ||
+        !buffer_pool_manager_->FlushPage(CatalogPage::PAGE_ID) || !storage_manager_->Sync()) {
+        std::cerr << "Checkpoint failed to write the catalog" << std::endl;
+        return false;
     }
+    buffer_pool_manager_->ReleaseDeletedPages(free_pages);
+    return log_manager_->Checkpoint();
 }
 
-bool Database::ExecuteSelect(const Query& query) {
-    auto table_it = tables_.find(query.table_name);
+bool Database::GetRowCount(const std::string& table_name, uint64_t& row_count) {
+    std::lock_guard<std::mutex> guard(latch_);
+    auto table_it = tables_.find(table_name);
     if (table_it == tables_.end()) {
-        std::cerr << "Table not found: " << query.table_name << std::endl;
+        std::cerr << "Table not found: " << table_name << std::endl;
         return false;
     }
+    row_count = table_it->second->row_count;
+    return true;
+}
 
-    Table& table = *table_it->second;
-    
-    if (query.conditions.empty()) {
-        auto all_records = table.index->RangeScan(INT_MIN, INT_MAX);
-        for (const auto& record : all_records) {
-            bool matches = true;
-            for (const auto& condition : query.conditions) {
-                if (!EvaluateCondition(record, condition, table)) {
-                    matches = false;
-                    break;
-                }
+DatabaseStats Database::GetStats() const {
+    DatabaseStats stats;
+    stats.storage = storage_manager_->GetStats();
+    stats.buffer_pool_hits = buffer_pool_manager_->GetHitCount();
+    stats.buffer_pool_misses = buffer_pool_manager_->GetMissCount();
+    stats.warm_restart_pages = warm_restart_pages_;
+    stats.plan_cache_hits = plan_cache_->GetHitCount();
+    stats.plan_cache_misses = plan_cache_->GetMissCount();
+    return stats;
+}
+
+// Ad-hoc statements have their literals lifted into parameters, so every
+// SELECT or INSERT of the same shape shares one cached plan.
+std::shared_ptr<const Plan> Database::GetPlan(const std::string& sql, std::vector<Value>* literals) {
+    if (!open_) {
+        std::cerr << "Database is not open" << std::endl;
+        return nullptr;
+    }
+    std::string normalized = parser_->Normalize(sql, literals);
+
+    std::lock_guard<std::mutex> guard(latch_);
+    auto plan = plan_cache_->Get(normalized);
+    if (plan) {
+        return plan;
+    }
+
+    auto query = parser_->Parse(normalized);
+    if (!query) {
+        std::cerr << "Failed to parse query: " << sql << std::endl;
+        return nullptr;
+    }
+
+    plan = BuildPlan(std::move(query));
+    if (plan && plan->table) {
+        plan_cache_->Put(normalized, plan);
+    }
+    return plan;
+}
+
+std::shared_ptr<const Plan> Database::BuildPlan(std::unique_ptr<::Query> query) {
+    auto plan = std::make_shared<Plan>();
+    if (query->type == QueryType::SELECT || query->type == QueryType::INSERT ||
+        query->type == QueryType::DELETE) {
+        auto table_it = tables_.find(std::string(query->table_name));
+        if (table_it == tables_.end()) {
+            std::cerr << "Table not found: " << query->table_name << std::endl;
+            return nullptr;
+        }
+        plan->table = table_it->second.get();
+    }
+    if (!query->join_table.empty()) {
+        auto join_it = tables_.find(std::string(query->join_table));
+        if (join_it == tables_.end()) {
+            std::cerr << "Table not found: " << query->join_table << std::endl;
+            return nullptr;
+        }
+        plan->join_table = join_it->second.get();
+
+        std::vector<std::string_view> references(query->columns.begin(), query->columns.end());
+        references.insert(references.end(), query->join_columns.begin(), query->join_columns.end());
+        references.insert(references.end(), query->group_by.begin(), query->group_by.end());
+        references.insert(references.end(), query->order_by.begin(), query->order_by.end());
+        for (const auto& condition : query->conditions) {
+            references.push_back(condition.column);
+        }
+        for (std::string_view column : references) {
+            if (column.find('.') == std::string_view::npos && GetColumnIndex(column, *plan->table) >= 0 &&
+                GetColumnIndex(column, *plan->join_table) >= 0) {
+                std::cerr << "Ambiguous column: " << column << std::endl;
+                return nullptr;
             }
-            if (matches) {
-                last_results_.push_back(record);
+        }
+
+        int width = static_cast<int>(plan->table->columns.size());
+        int left = ResolveColumn(query->join_columns[0], *plan);
+        int right = ResolveColumn(query->join_columns[1], *plan);
+        if (left >= width) {
+            std::swap(left, right);
+        }
+        if (left < 0 || left >= width || right < width) {
+            std::cerr << "JOIN must compare a column of each table" << std::endl;
+            return nullptr;
+        }
+        plan->join_column = left;
+        plan->join_table_column = right - width;
+    }
+
+    bool aggregating = !query->group_by.empty();
+    for (size_t i = 0; i < query->columns.size() && query->type == QueryType::SELECT; ++i) {
+        std::string_view column = query->columns[i];
+        AggregateFunction function = query->functions[i];
+        aggregating = aggregating || function != AggregateFunction::NONE;
+        int column_index = column == "*" ? -1 : ResolveColumn(column, *plan);
+        if (column_index < 0 && column != "*") {
+            std::cerr << "Column not found: " << column << std::endl;
+            return nullptr;
+        }
+        plan->projection.push_back(column_index);
+    }
+
+    if (aggregating) {
+        if (query->columns.empty()) {
+            std::cerr << "SELECT * cannot be aggregated" << std::endl;
+            return nullptr;
+        }
+        for (const auto& column : query->group_by) {
+            int column_index = ResolveColumn(column, *plan);
+            if (column_index < 0) {
+                std::cerr << "Column not found: " << column << std::endl;
+                return nullptr;
             }
+            plan->group_by.push_back(column_index);
         }
-    } else {
-        for (const auto& condition : query.conditions) {
-            if (condition.column == "id" && condition.op == "=") {
-                int key = std::get<int>(condition.value);
-                Record record;
-                if (table.index->Search(key, record)) {
-                    bool matches = true;
-                    for (const auto& cond : query.conditions) {
-                        if (!EvaluateCondition(record, cond, table)) {
-                            matches = false;
-                            break;
-                        }
-                    }
-                    if (matches) {
-                        last_results_.push_back(record);
-                    }
+        for (size_t i = 0; i < query->columns.size(); ++i) {
+            if (query->functions[i] == AggregateFunction::NONE &&
+                std::find(plan->group_by.begin(), plan->group_by.end(), plan->projection[i]) == plan->group_by.end()) {
+                std::cerr << "Column must appear in GROUP BY: " << query->columns[i] << std::endl;
+                return nullptr;
+            }
+        }
+        plan->aggregates.assign(query->functions.begin(), query->functions.end());
+    }
+
+    // Rows are sorted on table columns before they are projected, except for
+    // aggregates, which sort their output on the select list entries.
+    for (size_t i = 0; i < query->order_by.size(); ++i) {
+        std::string_view column = query->order_by[i];
+        AggregateFunction function = query->order_functions[i];
+        int column_index = column == "*" ? -1 : ResolveColumn(column, *plan);
+        int key = -1;
+        if (plan->aggregates.empty()) {
+            key = function == AggregateFunction::NONE ? column_index : -1;
+        } else if (column_index >= 0 || column == "*") {
+            for (size_t item = 0; item < plan->aggregates.size() && key < 0; ++item) {
+                if (plan->aggregates[item] == function && plan->projection[item] == column_index) {
+                    key = static_cast<int>(item);
                 }
+            }
+        }
+        if (key < 0) {
+            std::cerr << "Cannot order by " << column << std::endl;
+            return nullptr;
+        }
+        plan->order_by.push_back(SortKey{key, query->order_descending[i]});
+    }
+
+    // Ranges on the primary key are folded into the bounds of the scan and
+    // need no further check; everything else is a residual filter. Only a
+    // plain conjunction can be narrowed this way.
+    bool conjunctive = query->conditions.empty() || query->conditions.back().group == 0;
+    for (size_t i = 0; i < query->conditions.size(); ++i) {
+        const Condition& condition = query->conditions[i];
+        int column_index = ResolveColumn(condition.column, *plan);
+        CompareOp op = CompareOp::EQ;
+        ToCompareOp(condition.op, op);
+        plan->condition_columns.push_back(column_index);
+        plan->condition_ops.push_back(op);
+        if (conjunctive && column_index == 0 && IsRange(op)) {
+            plan->key_conditions.push_back(static_cast<int>(i));
+        } else if (conjunctive && plan->join_table && column_index == static_cast<int>(plan->table->columns.size()) &&
+                   IsRange(op)) {
+            plan->join_key_conditions.push_back(static_cast<int>(i));
+        } else {
+            plan->residual_conditions.push_back(static_cast<int>(i));
+        }
+    }
+    plan->conjunctive = conjunctive;
+
+    // Without key bounds, drive the scan from an index on a condition column,
+    // preferring equality over a range.
+    for (size_t i = 0; i < query->conditions.size() && conjunctive && plan->key_conditions.empty() && !plan->join_table;
+         ++i) {
+        CompareOp op = plan->condition_ops[i];
+        if (!IsRange(op)) {
+            continue;
+        }
+        for (auto& index : plan->table->indexes) {
+            if (index->GetColumn() != plan->condition_columns[i]) {
+                continue;
+            }
+            if (!plan->index || (op == CompareOp::EQ && plan->condition_ops[plan->index_condition] != CompareOp::EQ)) {
+                plan->index = index.get();
+                plan->index_condition = static_cast<int>(i);
+            }
+            break;
+        }
+    }
+
+    plan->query = std::move(query);
+    return plan;
+}
+
+bool Database::ExecutePlan(const std::shared_ptr<const Plan>& plan, const std::vector<Value>& parameters) {
+    if (parameters.size() != plan->query->placeholders.size()) {
+        std::cerr << "Expected " << plan->query->placeholders.size() << " parameters" << std::endl;
+        return false;
+    }
+
+    bool result;
+    lsn_t commit_lsn = INVALID_LSN;
+    {
+        std::lock_guard<std::mutex> guard(latch_);
+        last_results_.clear();
+
+        switch (plan->query->type) {
+            case QueryType::SELECT:
+                result = ExecuteSelect(plan, parameters);
+                break;
+            case QueryType::INSERT:
+                result = ExecuteInsert(*plan, parameters, commit_lsn);
+                break;
+            case QueryType::DELETE:
+                result = ExecuteDelete(plan, parameters, commit_lsn);
                 break;
+            case QueryType::CREATE_TABLE:
+                result = ExecuteCreateTable(*plan->query, commit_lsn);
+                break;
+            case QueryType::CREATE_INDEX:
+                result = ExecuteCreateIndex(*plan->query);
+                break;
+            default:
+                std::cerr << "Unsupported query type" << std::endl;
+                return false;
+        }
+    }
+
+    // Commit outside the latch so that concurrent writers share one log sync.
+    if (commit_lsn != INVALID_LSN && !log_manager_->Flush(commit_lsn)) {
+        std::cerr << "Failed to commit to the write-ahead log" << std::endl;
+        return false;
+    }
+    if (commit_lsn != INVALID_LSN && log_manager_->GetLogSize() > options_.checkpoint_log_bytes) {
+        std::lock_guard<std::mutex> guard(latch_);
+        Checkpoint();
+    }
+    return result;
+}
+
+std::unique_ptr<Cursor> Database::QueryPlan(const std::shared_ptr<const Plan>& plan,
+                                            const std::vector<Value>& parameters) {
+    if (plan->query->type != QueryType::SELECT) {
+        std::cerr << "Only SELECT statements can be opened as a cursor" << std::endl;
+        return nullptr;
+    }
+    if (!plan->aggregates.empty() || plan->join_table) {
+        std::cerr << "Aggregate and join queries cannot be opened as a cursor" << std::endl;
+        return nullptr;
+    }
+    if (parameters.size() != plan->query->placeholders.size()) {
+        std::cerr << "Expected " << plan->query->placeholders.size() << " parameters" << std::endl;
+        return nullptr;
+    }
+
+    size_t offset;
+    size_t limit;
+    if (!GetLimit(*plan, parameters, offset, limit)) {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> guard(latch_);
+    if (!NeedsSort(*plan)) {
+        auto cursor = OpenCursor(plan, parameters, &latch_, plan->projection);
+        cursor->SetLimit(offset, limit);
+        return cursor;
+    }
+
+    // The sort consumes its input here; the cursor then reads the sorted
+    // runs, which belong to it alone, without the latch.
+    size_t wanted = limit > SIZE_MAX - offset ? SIZE_MAX : offset + limit;
+    auto sort = std::make_unique<ExternalSort>(plan->order_by, wanted, buffer_pool_manager_.get(),
+                                               options_.sort_memory_bytes);
+    ForEachRow(plan, parameters, [&sort](Record& row) { sort->Add(std::move(row)); });
+    sort->Finish();
+    auto cursor = std::make_unique<Cursor>(std::move(sort), plan->projection);
+    cursor->SetLimit(offset, SIZE_MAX);
+    return cursor;
+}
+
+std::unique_ptr<Cursor> Database::OpenCursor(const std::shared_ptr<const Plan>& plan,
+                                             const std::vector<Value>& parameters, std::mutex* latch,
+                                             std::vector<int> columns) {
+    const auto& conditions = plan->query->conditions;
+    std::vector<Value> values = BindConditionValues(*plan, parameters);
+
+    btree_key_t start_key;
+    btree_key_t end_key;
+    GetKeyRange(*plan, plan->key_conditions, values, start_key, end_key);
+
+    CompiledPredicate predicate;
+    int group = 0;
+    for (int i : plan->residual_conditions) {
+        if (conditions[i].group != group) {
+            predicate.EndGroup();
+            group = conditions[i].group;
+        }
+        predicate.AddTerm(plan->condition_columns[i], plan->condition_ops[i], values[i]);
+    }
+
+    if (plan->key_conditions.empty() && plan->index) {
+        int i = plan->index_condition;
+        BTreeIterator iterator = plan->index->Scan(plan->condition_ops[i], values[i]);
+        return std::make_unique<Cursor>(std::move(iterator), plan->table->index.get(), std::move(predicate),
+                                        std::move(columns), latch);
+    }
+    return std::make_unique<Cursor>(plan->table->index->Scan(start_key, end_key), std::move(predicate),
+                                    std::move(columns), latch);
+}
+
+std::vector<Value> Database::BindConditionValues(const Plan& plan, const std::vector<Value>& parameters) {
+    std::vector<Value> values;
+    values.reserve(plan.query->conditions.size());
+    for (const auto& condition : plan.query->conditions) {
+        values.push_back(condition.value);
+    }
+    for (size_t i = 0; i < parameters.size(); ++i) {
+        int condition = plan.query->placeholders[i].condition;
+        if (condition >= 0) {
+            values[condition] = parameters[i];
+        }
+    }
+    return values;
+}
+
+// LIMIT and OFFSET are literals or parameters, and must be non-negative
+// integers. Without a LIMIT, limit is SIZE_MAX.
+bool Database::GetLimit(const Plan& plan, const std::vector<Value>& parameters, size_t& offset, size_t& limit) {
+    const ::Query& query = *plan.query;
+    Value values[2] = {query.limit, query.offset};
+    for (size_t i = 0; i < parameters.size(); ++i) {
+        if (query.placeholders[i].limit >= 0) {
+            values[query.placeholders[i].limit] = parameters[i];
+        }
+    }
+    for (const auto& value : values) {
+        if (!std::holds_alternative<int>(value) || std::get<int>(value) < 0) {
+            std::cerr << "LIMIT and OFFSET must be non-negative integers" << std::endl;
+            return false;
+        }
+    }
+    limit = query.has_limit ? static_cast<size_t>(std::get<int>(values[0])) : SIZE_MAX;
+    offset = static_cast<size_t>(std::get<int>(values[1]));
+    return true;
+}
+
+// Table scans return rows in key order, and keys are unique, so an ORDER BY
+// led by the ascending key needs no sort unless an index drives the scan.
+bool Database::NeedsSort(const Plan& plan) {
+    if (plan.order_by.empty()) {
+        return false;
+    }
+    bool key_order = plan.aggregates.empty() && !plan.join_table && !(plan.key_conditions.empty() && plan.index);
+    return !key_order || plan.order_by[0].column != 0 || plan.order_by[0].descending;
+}
+
+// The residual conditions of a conjunctive plan as batch filters, taking
+// their values. Returns false if one names an unknown column and so can
+// never hold.
+bool Database::GetScanFilters(const Plan& plan, std::vector<Value>& values, std::vector<BatchFilter>& filters) {
+    for (int i : plan.residual_conditions) {
+        if (plan.condition_columns[i] < 0) {
+            return false;
+        }
+        filters.push_back(BatchFilter{plan.condition_columns[i], plan.condition_ops[i], std::move(values[i])});
+    }
+    return true;
+}
+
+// Intersects the key conditions into [start_key, end_key]. Keys are integers
+// and a comparison with any other type matches nothing, so the range is exact
+// and may come out empty.
+void Database::GetKeyRange(const Plan& plan, const std::vector<int>& key_conditions, const std::vector<Value>& values,
+                           btree_key_t& start_key, btree_key_t& end_key) {
+    start_key = INT_MIN;
+    end_key = INT_MAX;
+    for (int i : key_conditions) {
+        if (!std::holds_alternative<int>(values[i])) {
+            start_key = 1;
+            end_key = 0;
+            return;
+        }
+
+        btree_key_t value = std::get<int>(values[i]);
+        CompareOp op = plan.condition_ops[i];
+        if (op == CompareOp::EQ || op == CompareOp::GE) {
+            start_key = std::max(start_key, value);
+        } else if (op == CompareOp::GT) {
+            start_key = std::max(start_key, value + 1);
+        }
+        if (op == CompareOp::EQ || op == CompareOp::LE) {
+            end_key = std::min(end_key, value);
+        } else if (op == CompareOp::LT) {
+            end_key = std::min(end_key, value - 1);
+        }
+    }
+}
+
+// Table scans filtered by a conjunction run vectorized, split into morsels
+// across the scan workers when there are any. Index scans fetch rows one at a
+// time anyway, and disjunctions are evaluated per row, so both go through a
+// cursor.
+bool Database::ExecuteSelect(const std::shared_ptr<const Plan>& plan, const std::vector<Value>& parameters) {
+    size_t offset;
+    size_t limit;
+    if (!GetLimit(*plan, parameters, offset, limit)) {
+        return false;
+    }
+    size_t wanted = limit > SIZE_MAX - offset ? SIZE_MAX : offset + limit;
+    if (NeedsSort(*plan) || (wanted != SIZE_MAX && (!plan->aggregates.empty() || plan->join_table))) {
+        return ExecuteSortedSelect(plan, parameters, offset, wanted);
+    }
+
+    if (!plan->aggregates.empty()) {
+        return ExecuteAggregate(plan, parameters);
+    }
+    if (plan->join_table) {
+        return ExecuteJoin(*plan, parameters, [&](Record& row) {
+            if (plan->projection.empty()) {
+                last_results_.push_back(std::move(row));
+                return;
+            }
+            Record projected;
+            for (int column : plan->projection) {
+                projected.AddValue(row.GetValue(column));
+            }
+            last_results_.push_back(std::move(projected));
+        });
+    }
+    if (!plan->conjunctive || (plan->key_conditions.empty() && plan->index)) {
+        return ExecuteCursorSelect(plan, parameters, offset, limit);
+    }
+
+    std::vector<Value> values = BindConditionValues(*plan, parameters);
+    btree_key_t start_key;
+    btree_key_t end_key;
+    GetKeyRange(*plan, plan->key_conditions, values, start_key, end_key);
+    std::vector<BatchFilter> filters;
+    if (!GetScanFilters(*plan, values, filters)) {
+        return true;
+    }
+
+    size_t column_count = plan->table->columns.size();
+    std::vector<int> projection = plan->projection;
+    if (projection.empty()) {
+        for (size_t column = 0; column < column_count; ++column) {
+            projection.push_back(static_cast<int>(column));
+        }
+    }
+    std::vector<bool> columns(column_count, false);
+    for (int column : projection) {
+        columns[column] = true;
+    }
+
+    auto collect = [&projection](const ColumnBatch& batch, std::vector<Record>& results) {
+        const uint16_t* selection = batch.GetSelection();
+        for (size_t i = 0; i < batch.GetSelectedCount(); ++i) {
+            results.push_back(batch.GetRow(selection[i], projection));
+        }
+    };
+
+    // A LIMIT stops the scan as soon as it has enough rows, which a serial
+    // scan in key order can do and morsels scanned in parallel cannot.
+    BTree* tree = plan->table->index.get();
+    if (scan_pool_ && wanted == SIZE_MAX) {
+        ParallelScan scan(tree, start_key, end_key, filters, columns,
+                          scan_pool_->GetThreadCount() * MORSELS_PER_WORKER);
+        if (scan.GetMorselCount() > 1) {
+            std::vector<std::vector<Record>> morsel_results(scan.GetMorselCount());
+            scan.Run(*scan_pool_, [&](size_t, size_t morsel, const ColumnBatch& batch) {
+                collect(batch, morsel_results[morsel]);
+            });
+            for (auto& results : morsel_results) {
+                std::move(results.begin(), results.end(), std::back_inserter(last_results_));
+            }
+            return true;
+        }
+    }
+
+    VectorizedScan scan(tree->Scan(start_key, end_key), std::move(filters), std::move(columns));
+    ColumnBatch batch(column_count);
+    while (last_results_.size() < wanted && scan.NextBatch(batch)) {
+        collect(batch, last_results_);
+    }
+    if (last_results_.size() > wanted) {
+        last_results_.resize(wanted);
+    }
+    last_results_.erase(last_results_.begin(), last_results_.begin() + std::min(offset, last_results_.size()));
+    return true;
+}
+
+bool Database::ExecuteCursorSelect(const std::shared_ptr<const Plan>& plan, const std::vector<Value>& parameters,
+                                   size_t offset, size_t limit) {
+    auto cursor = OpenCursor(plan, parameters, nullptr, plan->projection);
+    if (!cursor) {
+        return false;
+    }
+    cursor->SetLimit(offset, limit);
+
+    Record record;
+    while (cursor->Next(record)) {
+        last_results_.push_back(std::move(record));
+    }
+    return true;
+}
+
+// Rows that have to be sorted, or cut short by a LIMIT without a scan that
+// can stop early, go through an ExternalSort, which holds no more rows than
+// the limit or the memory budget allows. Aggregates sort their output rows.
+bool Database::ExecuteSortedSelect(const std::shared_ptr<const Plan>& plan, const std::vector<Value>& parameters,
+                                   size_t offset, size_t wanted) {
+    auto sort = std::make_unique<ExternalSort>(plan->order_by, wanted, buffer_pool_manager_.get(),
+                                               options_.sort_memory_bytes);
+    std::vector<int> projection = plan->projection;
+    if (!plan->aggregates.empty()) {
+        if (!ExecuteAggregate(plan, parameters)) {
+            return false;
+        }
+        for (auto& row : last_results_) {
+            sort->Add(std::move(row));
+        }
+        last_results_.clear();
+        projection.clear();
+    } else if (!ForEachRow(plan, parameters, [&sort](Record& row) { sort->Add(std::move(row)); })) {
+        return false;
+    }
+    sort->Finish();
+
+    Cursor cursor(std::move(sort), std::move(projection));
+    cursor.SetLimit(offset, SIZE_MAX);
+    Record record;
+    while (cursor.Next(record)) {
+        last_results_.push_back(std::move(record));
+    }
+    return true;
+}
+
+// Calls emit with every whole row of a plan, in no particular order.
+bool Database::ForEachRow(const std::shared_ptr<const Plan>& plan, const std::vector<Value>& parameters,
+                          const std::function<void(Record&)>& emit) {
+    if (plan->join_table) {
+        return ExecuteJoin(*plan, parameters, emit);
+    }
+    if (!plan->conjunctive || (plan->key_conditions.empty() && plan->index)) {
+        auto cursor = OpenCursor(plan, parameters, nullptr, {});
+        Record record;
+        while (cursor->Next(record)) {
+            emit(record);
+        }
+        return true;
+    }
+
+    std::vector<Value> values = BindConditionValues(*plan, parameters);
+    btree_key_t start_key;
+    btree_key_t end_key;
+    GetKeyRange(*plan, plan->key_conditions, values, start_key, end_key);
+    std::vector<BatchFilter> filters;
+    if (!GetScanFilters(*plan, values, filters)) {
+        return true;
+    }
+    ScanRows(plan->table->index.get(), start_key, end_key, std::move(filters), plan->table->columns.size(),
+             [&emit](std::vector<Record>& rows) {
+                 for (auto& row : rows) {
+                     emit(row);
+                 }
+             });
+    return true;
+}
+
+// Aggregates run over the same scans as ExecuteSelect. Each scan worker
+// aggregates into a table of its own, merged once the scan is done, so the
+// workers never share a group. Counting the rows of a key range needs no
+// records at all: it is read off the key counts of the leaves.
+bool Database::ExecuteAggregate(const std::shared_ptr<const Plan>& plan, const std::vector<Value>& parameters) {
+    const auto& aggregates = plan->aggregates;
+    std::vector<Value> values = BindConditionValues(*plan, parameters);
+    btree_key_t start_key;
+    btree_key_t end_key;
+    GetKeyRange(*plan, plan->key_conditions, values, start_key, end_key);
+    BTree* tree = plan->table->index.get();
+
+    bool counting = !plan->join_table && plan->group_by.empty() && plan->conjunctive &&
+                    plan->residual_conditions.empty() &&
+                    std::all_of(aggregates.begin(), aggregates.end(),
+                                [](AggregateFunction function) { return function == AggregateFunction::COUNT; });
+    if (counting) {
+        int count = 0;
+        for (BTreeIterator iterator = tree->Scan(start_key, end_key); !iterator.IsEnd();) {
+            int run = iterator.GetRunLength();
+            count += run;
+            iterator.Advance(run);
+        }
+        last_results_.emplace_back(std::vector<Value>(aggregates.size(), count));
+        return true;
+    }
+
+    // The aggregate emits the group columns first, then one value per
+    // aggregate; output maps each select list entry to its place there.
+    std::vector<AggregateInput> inputs;
+    std::vector<size_t> output;
+    for (size_t i = 0; i < aggregates.size(); ++i) {
+        int column = plan->projection[i];
+        if (aggregates[i] == AggregateFunction::NONE) {
+            auto it = std::find(plan->group_by.begin(), plan->group_by.end(), column);
+            output.push_back(static_cast<size_t>(it - plan->group_by.begin()));
+        } else {
+            output.push_back(plan->group_by.size() + inputs.size());
+            inputs.push_back(AggregateInput{aggregates[i], column});
+        }
+    }
+
+    size_t budget = options_.aggregate_memory_bytes;
+    HashAggregate aggregate(plan->group_by, inputs, buffer_pool_manager_.get(), budget);
+    if (plan->join_table) {
+        ExecuteJoin(*plan, parameters, [&aggregate](Record& row) { aggregate.Add(row); });
+    } else if (!plan->conjunctive || (plan->key_conditions.empty() && plan->index)) {
+        auto cursor = OpenCursor(plan, parameters, nullptr, {});
+        Record record;
+        while (cursor->Next(record)) {
+            aggregate.Add(record);
+        }
+    } else {
+        std::vector<BatchFilter> filters;
+        bool empty = !GetScanFilters(*plan, values, filters);
+
+        size_t column_count = plan->table->columns.size();
+        std::vector<bool> columns(column_count, false);
+        for (int column : plan->group_by) {
+            columns[column] = true;
+        }
+        for (const auto& input : inputs) {
+            if (input.column >= 0) {
+                columns[input.column] = true;
+            }
+        }
+
+        std::unique_ptr<ParallelScan> parallel;
+        if (scan_pool_ && !empty) {
+            parallel = std::make_unique<ParallelScan>(tree, start_key, end_key, filters, columns,
+                                                      scan_pool_->GetThreadCount() * MORSELS_PER_WORKER);
+        }
+        if (parallel && parallel->GetMorselCount() > 1) {
+            size_t thread_count = scan_pool_->GetThreadCount();
+            std::vector<std::unique_ptr<HashAggregate>> partials;
+            for (size_t i = 0; i < thread_count; ++i) {
+                partials.push_back(std::make_unique<HashAggregate>(plan->group_by, inputs, buffer_pool_manager_.get(),
+                                                                   budget / thread_count));
+            }
+            parallel->Run(*scan_pool_, [&](size_t worker, size_t, const ColumnBatch& batch) {
+                partials[worker]->AddBatch(batch);
+            });
+            for (auto& partial : partials) {
+                aggregate.Merge(*partial);
+            }
+        } else if (!empty) {
+            VectorizedScan scan(tree->Scan(start_key, end_key), std::move(filters), std::move(columns));
+            ColumnBatch batch(column_count);
+            while (scan.NextBatch(batch)) {
+                aggregate.AddBatch(batch);
+            }
+        }
+    }
+
+    for (const auto& row : aggregate.Finish()) {
+        Record record;
+        for (size_t position : output) {
+            record.AddValue(row.GetValue(position));
+        }
+        last_results_.push_back(std::move(record));
+    }
+    return true;
+}
+
+// The table drives the join. When the ON column of the other table is its
+// primary key, each batch of the table's rows is sorted by join value and
+// looked up with BTree::Search, so that successive probes walk the tree in
+// key order and find its pages still cached; when it is the table's own key,
+// the roles swap. Otherwise the rows of join_table are hashed and the table's
+// rows probe them. The conditions of a conjunction filter each table's scan;
+// a disjunction is checked on the joined rows.
+bool Database::ExecuteJoin(const Plan& plan, const std::vector<Value>& parameters,
+                           const std::function<void(Record&)>& emit) {
+    std::vector<Value> values = BindConditionValues(plan, parameters);
+    BTree* trees[2] = {plan.table->index.get(), plan.join_table->index.get()};
+    size_t widths[2] = {plan.table->columns.size(), plan.join_table->columns.size()};
+    int join_columns[2] = {plan.join_column, plan.join_table_column};
+    btree_key_t start_keys[2];
+    btree_key_t end_keys[2];
+    GetKeyRange(plan, plan.key_conditions, values, start_keys[0], end_keys[0]);
+    GetKeyRange(plan, plan.join_key_conditions, values, start_keys[1], end_keys[1]);
+
+    std::vector<BatchFilter> filters[2];
+    CompiledPredicate predicate;
+    int group = 0;
+    for (int i : plan.residual_conditions) {
+        int column = plan.condition_columns[i];
+        if (!plan.conjunctive) {
+            if (plan.query->conditions[i].group != group) {
+                predicate.EndGroup();
+                group = plan.query->conditions[i].group;
+            }
+            predicate.AddTerm(column, plan.condition_ops[i], values[i]);
+            continue;
+        }
+        if (column < 0) {
+            return true;
+        }
+        size_t side = static_cast<size_t>(column) < widths[0] ? 0 : 1;
+        filters[side].push_back(BatchFilter{column - static_cast<int>(side * widths[0]), plan.condition_ops[i],
+                                            std::move(values[i])});
+    }
+
+    auto combine = [&](const Record& left, const Record& right) {
+        std::vector<Value> row = left.GetValues();
+        row.resize(widths[0]);
+        row.insert(row.end(), right.GetValues().begin(), right.GetValues().end());
+        Record record(row);
+        if (predicate.IsEmpty() || predicate.Evaluate(record)) {
+            emit(record);
+        }
+    };
+
+    int inner = join_columns[1] == 0 ? 1 : join_columns[0] == 0 ? 0 : -1;
+    if (inner < 0) {
+        std::vector<Record> build;
+        ScanRows(trees[1], start_keys[1], end_keys[1], std::move(filters[1]), widths[1], [&](std::vector<Record>& rows) {
+            std::move(rows.begin(), rows.end(), std::back_inserter(build));
+        });
+        HashJoin join(join_columns[1], join_columns[0]);
+        join.Build(std::move(build));
+        ScanRows(trees[0], start_keys[0], end_keys[0], std::move(filters[0]), widths[0], [&](std::vector<Record>& rows) {
+            join.Probe(rows, combine);
+        });
+        return true;
+    }
+
+    int outer = 1 - inner;
+    CompiledPredicate inner_filter;
+    for (const auto& filter : filters[inner]) {
+        inner_filter.AddTerm(filter.column, filter.op, filter.constant);
+    }
+    ScanRows(trees[outer], start_keys[outer], end_keys[outer], std::move(filters[outer]), widths[outer],
+             [&](std::vector<Record>& rows) {
+                 std::vector<std::pair<btree_key_t, size_t>> probes;
+                 for (size_t i = 0; i < rows.size(); ++i) {
+                     Value value = rows[i].GetValue(join_columns[outer]);
+                     const int* key = std::get_if<int>(&value);
+                     if (key && *key >= start_keys[inner] && *key <= end_keys[inner]) {
+                         probes.emplace_back(*key, i);
+                     }
+                 }
+                 std::sort(probes.begin(), probes.end());
+
+                 Record match;
+                 bool found = false;
+                 for (size_t p = 0; p < probes.size(); ++p) {
+                     if (p == 0 || probes[p].first != probes[p - 1].first) {
+                         found = trees[inner]->Search(probes[p].first, match) &&
+                                 (inner_filter.IsEmpty() || inner_filter.Evaluate(match));
+                     }
+                     if (found) {
+                         const Record& row = rows[probes[p].second];
+                         inner == 1 ? combine(row, match) : combine(match, row);
+                     }
+                 }
+             });
+    return true;
+}
+
+void Database::ScanRows(BTree* tree, btree_key_t start_key, btree_key_t end_key, std::vector<BatchFilter> filters,
+                        size_t column_count, const std::function<void(std::vector<Record>&)>& consume) {
+    VectorizedScan scan(tree->Scan(start_key, end_key), std::move(filters), std::vector<bool>(column_count, true));
+    ColumnBatch batch(column_count);
+    std::vector<Record> rows;
+    while (scan.NextBatch(batch)) {
+        rows.clear();
+        const uint16_t* selection = batch.GetSelection();
+        for (size_t i = 0; i < batch.GetSelectedCount(); ++i) {
+            rows.push_back(batch.GetRow(selection[i]));
+        }
+        if (!rows.empty()) {
+            consume(rows);
+        }
+    }
+}
+
+bool Database::ExecuteInsert(const Plan& plan, const std::vector<Value>& parameters, lsn_t& commit_lsn) {
+    Table& table = *plan.table;
+    const ::Query& query = *plan.query;
+
+    std::vector<std::vector<Value>> rows;
+    rows.reserve(query.rows.size());
+    for (const auto& row : query.rows) {
+        rows.emplace_back(row.begin(), row.end());
+    }
+    for (size_t i = 0; i < parameters.size(); ++i) {
+        const Placeholder& placeholder = query.placeholders[i];
+        rows[placeholder.row][placeholder.column] = parameters[i];
+    }
+
+    for (const auto& row : rows) {
+        if (row.size() != table.columns.size()) {
+            std::cerr << "Value count doesn't match column count" << std::endl;
+            return false;
+        }
+        if (!std::holds_alternative<int>(row[0])) {
+            std::cerr << "Primary key must be an integer" << std::endl;
+            return false;
+        }
+    }
+    if (rows.empty()) {
+        std::cerr << "INSERT without values" << std::endl;
+        return false;
+    }
+
+    // Rows are logged and inserted in key order so that a batch fills each
+    // leaf it reaches with a single descent and page LSNs only move forward.
+    std::vector<BTreeEntry> entries;
+    entries.reserve(rows.size());
+    for (const auto& row : rows) {
+        entries.push_back(BTreeEntry{std::get<int>(row[0]), Record(row), INVALID_LSN});
+    }
+    std::sort(entries.begin(), entries.end(),
+              [](const BTreeEntry& a, const BTreeEntry& b) { return a.key < b.key; });
+
+    // Nothing is logged for a statement that would be rejected in part.
+    for (size_t i = 0; i < entries.size(); ++i) {
+        if (i > 0 && entries[i].key == entries[i - 1].key) {
+            std::cerr << "Duplicate primary key: " << entries[i].key << std::endl;
+            return false;
+        }
+        if (!table.index->CanStore(entries[i].record)) {
+            std::cerr << "Row does not fit table " << table.name << std::endl;
+            return false;
+        }
+    }
+    if (table.index->ContainsAny(entries)) {
+        std::cerr << "Duplicate primary key in table " << table.name << std::endl;
+        return false;
+    }
+
+    // One log record carries the whole statement, so that recovery replays
+    // all of its rows or none of them; each row still gets its own LSN.
+    std::string payload;
+    for (const auto& entry : entries) {
+        size_t offset = payload.size();
+        payload.resize(offset + entry.record.GetSize());
+        entry.record.Serialize(payload.data() + offset);
+    }
+    commit_lsn = LogOperation(LogRecordType::INSERT, table.name, static_cast<int>(entries.size()), payload,
+                              entries.size());
+    lsn_t lsn = commit_lsn - entries.size();
+    for (auto& entry : entries) {
+        entry.lsn = ++lsn;
+    }
+
+    // Only a failed page write leaves rows out; the indexes and the row count
+    // still follow the rows that went in. Index entries are applied in log
+    // order so that page LSNs only move forward.
+    std::vector<bool> inserted;
+    size_t inserted_count = table.index->InsertBatch(entries, &inserted);
+    table.row_count += inserted_count;
+    for (const auto& index : table.indexes) {
+        for (size_t i = 0; i < entries.size(); ++i) {
+            if (inserted[i]) {
+                index->Insert(entries[i].record, entries[i].key, entries[i].lsn);
             }
         }
     }
+    return inserted_count == entries.size();
+}
+
+bool Database::ExecuteDelete(const std::shared_ptr<const Plan>& plan, const std::vector<Value>& parameters,
+                             lsn_t& commit_lsn) {
+    Table& table = *plan->table;
+    std::vector<Record> rows;
+    {
+        auto cursor = OpenCursor(plan, parameters, nullptr, {});
+        Record record;
+        while (cursor->Next(record)) {
+            rows.push_back(std::move(record));
+        }
+    }
 
+    // The log record carries the deleted row so that recovery can remove its
+    // index entries too.
+    for (const auto& row : rows) {
+        int key = std::get<int>(row.GetValue(0));
+        std::string payload(row.GetSize(), '\0');
+        row.Serialize(payload.data());
+        commit_lsn = LogOperation(LogRecordType::DELETE, table.name, key, payload);
+        table.index->Delete(key, commit_lsn);
+        for (const auto& index : table.indexes) {
+            index->Delete(row, key, commit_lsn);
+        }
+    }
+    table.row_count -= rows.size();
     return true;
 }
 
-bool Database::ExecuteInsert(const Query& query) {
-    auto table_it = tables_.find(query.table_name);
+bool Database::BulkLoad(const std::string& table_name, const std::function<bool(Record&)>& next,
+                        double fill_factor) {
+    if (!open_) {
+        std::cerr << "Database is not open" << std::endl;
+        return false;
+    }
+    std::lock_guard<std::mutex> guard(latch_);
+    auto table_it = tables_.find(table_name);
     if (table_it == tables_.end()) {
-        std::cerr << "Table not found: " << query.table_name << std::endl;
+        std::cerr << "Table not found: " << table_name << std::endl;
         return false;
     }
 
     Table& table = *table_it->second;
-    
-    if (query.values.size() != table.columns.size()) {
-        std::cerr << "Value count doesn't match column count" << std::endl;
+    bool valid = true;
+    uint64_t row_count = 0;
+    auto stream = [&](btree_key_t& key, Record& record) {
+        if (!next(record)) {
+            return false;
+        }
+        const auto& values = record.GetValues();
+        if (values.size() != table.columns.size() || !std::holds_alternative<int>(values[0])) {
+            valid = false;
+            return false;
+        }
+        key = std::get<int>(values[0]);
+        row_count++;
+        return true;
+    };
+
+    if (!table.index->BulkLoad(stream, fill_factor)) {
+        std::cerr << "Bulk load into " << table_name << " failed" << std::endl;
         return false;
     }
-
-    Record record(query.values);
-    
-    int key = std::get<int>(query.values[0]);
-    
-    return table.index->Insert(key, record);
+    if (!valid) {
+        // Nothing loaded is logged, so the partial tree is simply dropped.
+        table.index->Truncate();
+        std::cerr << "Bulk load into " << table_name << " stopped at an invalid row" << std::endl;
+        return false;
+    }
+    table.row_count = row_count;
+    for (const auto& index : table.indexes) {
+        if (!PopulateIndex(table, *index)) {
+            return false;
+        }
+    }
+    return Checkpoint();
 }
 
-bool Database::ExecuteCreateTable(const Query& query) {
-    if (tables_.find(query.table_name) != tables_.end()) {
+bool Database::ExecuteCreateTable(const ::Query& query, lsn_t& commit_lsn) {
+    std::string table_name(query.table_name);
+    if (tables_.find(table_name) != tables_.end()) {
         std::cerr << "Table already exists: " << query.table_name << std::endl;
         return false;
     }
 
+    LeafLayout layout = LeafLayout::ROW;
+    if (query.storage == "columnar") {
+        layout = LeafLayout::PAX;
+    } else if (!query.storage.empty() && query.storage != "row") {
+        std::cerr << "Unknown storage: " << query.storage << std::endl;
+        return false;
+    }
+
     auto table = std::make_unique<Table>();
-    table->name = query.table_name;
-    table->columns = query.table_columns;
-    table->index = std::make_unique<BTree>(buffer_pool_manager_.get());
+    table->name = table_name;
+    for (const auto& definition : query.table_columns) {
+        table->columns.push_back(Column{std::string(definition.name), std::string(definition.type)});
+    }
+    table->index = std::make_unique<BTree>(buffer_pool_manager_.get(), layout, GetRowFormat(table->columns));
+
+    Record definition;
+    EncodeTable(*table, definition);
+    std::string payload(definition.GetSize(), '\0');
+    definition.Serialize(payload.data());
+    commit_lsn = LogOperation(LogRecordType::CREATE_TABLE, table->name, 0, payload);
+    table->index->InitializeRoot(commit_lsn);
 
-    tables_[query.table_name] = std::move(table);
+    tables_[table_name] = std::move(table);
     
     std::cout << "Table created: " << query.table_name << std::endl;
     return true;
 }
 
-bool Database::EvaluateCondition(const Record& record, const Condition& condition, const Table& table) {
-    int column_index = GetColumnIndex(condition.column, table);
-    if (column_index == -1) {
+// Index creation is not logged: the index is built from the table and the
+// checkpoint that follows records it in the catalog.
+bool Database::ExecuteCreateIndex(const ::Query& query) {
+    auto table_it = tables_.find(std::string(query.table_name));
+    if (table_it == tables_.end()) {
+        std::cerr << "Table not found: " << query.table_name << std::endl;
         return false;
     }
 
-    Value record_value = GetRecordValue(record, column_index);
-    
-    if (condition.op == "=") {
-        return record_value == condition.value;
-    } else if (condition.op == ">") {
-        if (std::holds_alternative<int>(record_value) && std::holds_alternative<int>(condition.value)) {
-            return std::get<int>(record_value) > std::get<int>(condition.value);
-        } else if (std::holds_alternative<double>(record_value) && std::holds_alternative<double>(condition.value)) {
-            return std::get<double>(record_value) > std::get<double>(condition.value);
+    Table& table = *table_it->second;
+    for (const auto& existing : table.indexes) {
+        if (existing->GetName() == query.index_name) {
+            std::cerr << "Index already exists: " << query.index_name << std::endl;
+            return false;
         }
+    }
+    int column = GetColumnIndex(query.columns[0], table);
+    if (column < 0) {
+        std::cerr << "Column not found: " << query.columns[0] << std::endl;
         return false;
-    } else if (condition.op == "<") {
-        if (std::holds_alternative<int>(record_value) && std::holds_alternative<int>(condition.value)) {
-            return std::get<int>(record_value) < std::get<int>(condition.value);
-        } else if (std::holds_alternative<double>(record_value) && std::holds_alternative<double>(condition.value)) {
-            return std::get<double>(record_value) < std::get<double>(condition.value);
-        }
+    }
+
+    auto index = std::make_unique<SecondaryIndex>(std::string(query.index_name), column, buffer_pool_manager_.get());
+    if (!PopulateIndex(table, *index)) {
+        std::cerr << "Failed to build index " << query.index_name << std::endl;
         return false;
     }
-    
-    return false;
+    table.indexes.push_back(std::move(index));
+
+    // Cached plans were built without the new access path.
+    plan_cache_->Clear();
+    if (!Checkpoint()) {
+        return false;
+    }
+
+    std::cout << "Index created: " << query.index_name << std::endl;
+    return true;
+}
+
+bool Database::PopulateIndex(Table& table, SecondaryIndex& index) {
+    for (auto it = table.index->Scan(INT_MIN, INT_MAX); !it.IsEnd(); it.Next()) {
+        if (!index.Insert(it.GetRecord(), static_cast<int>(it.GetKey()))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Database::IsRange(CompareOp op) {
+    return op != CompareOp::NE;
 }
 
-int Database::GetColumnIndex(const std::string& column_name, const Table& table) {
+int Database::GetColumnIndex(std::string_view column_name, const Table& table) {
     for (size_t i = 0; i < table.columns.size(); ++i) {
         if (table.columns[i].name == column_name) {
             return static_cast<int>(i);
@@ -153,6 +1186,247 @@ int Database::GetColumnIndex(const std::string& column_name, const Table& table)
     return -1;
 }
 
-Value Database::GetRecordValue(const Record& record, int column_index) {
-    return record.GetValue(column_index);
+// Columns may be qualified with their table name. BuildPlan rejects an
+// unqualified name found in both tables of a join.
+int Database::ResolveColumn(std::string_view column_name, const Plan& plan) {
+    std::string_view qualifier;
+    size_t dot = column_name.find('.');
+    if (dot != std::string_view::npos) {
+        qualifier = column_name.substr(0, dot);
+        column_name = column_name.substr(dot + 1);
+    }
+
+    if (qualifier.empty() || qualifier == plan.table->name) {
+        int column = GetColumnIndex(column_name, *plan.table);
+        if (column >= 0) {
+            return column;
+        }
+    }
+    if (plan.join_table && (qualifier.empty() || qualifier == plan.join_table->name)) {
+        int column = GetColumnIndex(column_name, *plan.join_table);
+        if (column >= 0) {
+            return static_cast<int>(plan.table->columns.size()) + column;
+        }
+    }
+    return -1;
+}
+
+bool Database::Recover() {
+    // The catalog and the pages on disk reflect every log record up to
+    // catalog_lsn, so only the records after it are replayed. Row counts
+    // come from the catalog, so a change counts whether redo makes it or
+    // finds its leaf written back after the checkpoint.
+    std::string catalog;
+    lsn_t catalog_lsn = INVALID_LSN;
+    if (!CatalogPage::Read(buffer_pool_manager_.get(), catalog, catalog_lsn)) {
+        return false;
+    }
+    if (!catalog.empty()) {
+        LoadCatalog(catalog);
+    }
+
+    std::vector<LogRecord> log_records = log_manager_->ReadLogRecords();
+    log_manager_->AdvanceLSN(catalog_lsn);
+    // The free list is brought up to date first, so that redo never takes a
+    // page that a later record shows was in use. Page images go back before
+    // any logical record is replayed: those older than an image of their page
+    // are in it, and the page LSN it carries makes redo skip them.
+    for (const auto& log_record : log_records) {
+        if (log_record.lsn <= catalog_lsn) {
+            continue;
+        }
+        buffer_pool_manager_->RedoFreeList(log_record);
+        if (log_record.type == LogRecordType::PAGE_IMAGES && !buffer_pool_manager_->RedoPageImages(log_record)) {
+            std::cerr << "Failed to restore logged pages" << std::endl;
+            return false;
+        }
+    }
+    for (const auto& log_record : log_records) {
+        if (log_record.lsn <= catalog_lsn) {
+            continue;
+        }
+        switch (log_record.type) {
+            case LogRecordType::CREATE_TABLE: {
+                size_t offset = 0;
+                size_t index = 0;
+                Record definition = Record::Deserialize(log_record.payload.data(), offset);
+                auto table = DecodeTable(definition, index);
+                table->index->InitializeRoot(log_record.lsn);
+                tables_[table->name] = std::move(table);
+                break;
+            }
+            case LogRecordType::INSERT:
+            case LogRecordType::DELETE: {
+                auto table_it = tables_.find(log_record.table_name);
+                if (table_it == tables_.end()) {
+                    break;
+                }
+                Table& table = *table_it->second;
+                if (log_record.type == LogRecordType::INSERT) {
+                    size_t offset = 0;
+                    lsn_t lsn = log_record.lsn - log_record.key;
+                    for (int i = 0; i < log_record.key; ++i) {
+                        Record record = Record::Deserialize(log_record.payload.data(), offset);
+                        int key = std::get<int>(record.GetValue(0));
+                        if (table.index->Insert(key, record, ++lsn) || table.index->IsApplied(key, lsn)) {
+                            table.row_count++;
+                        }
+                        for (const auto& index : table.indexes) {
+                            index->Insert(record, key, lsn);
+                        }
+                    }
+                } else {
+                    if (table.index->Delete(log_record.key, log_record.lsn) ||
+                        table.index->IsApplied(log_record.key, log_record.lsn)) {
+                        table.row_count--;
+                    }
+                    if (!log_record.payload.empty()) {
+                        size_t offset = 0;
+                        Record record = Record::Deserialize(log_record.payload.data(), offset);
+                        for (const auto& index : table.indexes) {
+                            index->Delete(record, log_record.key, log_record.lsn);
+                        }
+                    }
+                }
+                break;
+            }
+            default:
+                break;
+        }
+    }
+    return true;
+}
+
+lsn_t Database::LogOperation(LogRecordType type, const std::string& table_name, int key, const std::string& payload,
+                             size_t lsn_count) {
+    LogRecord log_record;
+    log_record.type = type;
+    log_record.table_name = table_name;
+    log_record.key = key;
+    log_record.payload = payload;
+    return log_manager_->AppendLogRecord(log_record, lsn_count);
+}
+
+std::string Database::SerializeCatalog(const std::vector<page_id_t>& free_pages) const {
+    Record catalog;
+    catalog.AddValue(static_cast<int>(tables_.size()));
+    for (const auto& entry : tables_) {
+        EncodeTable(*entry.second, catalog);
+    }
+
+    catalog.AddValue(
+        std::string(reinterpret_cast<const char*>(free_pages.data()), free_pages.size() * sizeof(page_id_t)));
+
+    std::string data(catalog.GetSize(), '\0');
+    catalog.Serialize(data.data());
+    return data;
+}
+
+void Database::LoadCatalog(const std::string& catalog) {
+    size_t offset = 0;
+    Record record = Record::Deserialize(catalog.data(), offset);
+
+    size_t index = 0;
+    int table_count = std::get<int>(record.GetValue(index++));
+    for (int i = 0; i < table_count; ++i) {
+        auto table = DecodeTable(record, index);
+        tables_[table->name] = std::move(table);
+    }
+
+    std::string free_list = std::get<std::string>(record.GetValue(index++));
+    std::vector<page_id_t> free_pages(free_list.size() / sizeof(page_id_t));
+    if (!free_pages.empty()) {
+        std::memcpy(free_pages.data(), free_list.data(), free_pages.size() * sizeof(page_id_t));
+    }
+    buffer_pool_manager_->SetFreePages(free_pages);
+}
+
+// The list is only a hint for the next warm restart, so it is not synced.
+// It is written to a temporary file and renamed over the last one, so that
+// a crash leaves one of them whole.
+bool Database::SaveHotPages() {
+    std::vector<page_id_t> hot_pages = buffer_pool_manager_->GetHotPages();
+    std::lock_guard<std::mutex> guard(hot_pages_latch_);
+    std::string temp_file = hot_pages_file_ + ".tmp";
+    std::ofstream out(temp_file, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(hot_pages.data()),
+              static_cast<std::streamsize>(hot_pages.size() * sizeof(page_id_t)));
+    out.close();
+    if (!out || std::rename(temp_file.c_str(), hot_pages_file_.c_str()) != 0) {
+        std::remove(temp_file.c_str());
+        std::cerr << "Failed to save the hot pages to " << hot_pages_file_ << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void Database::LoadHotPages() {
+    std::ifstream in(hot_pages_file_, std::ios::binary);
+    std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    hot_pages_.resize(data.size() / sizeof(page_id_t));
+    if (!hot_pages_.empty()) {
+        std::memcpy(hot_pages_.data(), data.data(), hot_pages_.size() * sizeof(page_id_t));
+    }
+}
+
+void Database::SaveHotPagesLoop() {
+    std::unique_lock<std::mutex> lock(hot_pages_latch_);
+    auto interval = std::chrono::seconds(options_.hot_pages_save_seconds);
+    while (!hot_pages_cv_.wait_for(lock, interval, [this] { return stop_saving_; })) {
+        lock.unlock();
+        SaveHotPages();
+        lock.lock();
+    }
+}
+
+void Database::EncodeTable(const Table& table, Record& record) {
+    record.AddValue(table.name);
+    record.AddValue(static_cast<int>(table.index->GetRootPageId()));
+    record.AddValue(static_cast<int>(table.index->GetLeafLayout()));
+    record.AddValue(static_cast<int>(table.columns.size()));
+    for (const auto& column : table.columns) {
+        record.AddValue(column.name);
+        record.AddValue(column.type);
+    }
+    record.AddValue(static_cast<int>(table.indexes.size()));
+    for (const auto& index : table.indexes) {
+        record.AddValue(index->GetName());
+        record.AddValue(index->GetColumn());
+        record.AddValue(static_cast<int>(index->GetTree()->GetRootPageId()));
+    }
+    record.AddValue(static_cast<double>(table.row_count));  // exact far beyond the int key space
+}
+
+RowFormat Database::GetRowFormat(const std::vector<Column>& columns) {
+    std::vector<ColumnType> types;
+    for (const auto& column : columns) {
+        types.push_back(RowFormat::TypeOf(column.type));
+    }
+    return RowFormat(std::move(types));
+}
+
+std::unique_ptr<Table> Database::DecodeTable(const Record& record, size_t& index) {
+    auto table = std::make_unique<Table>();
+    table->name = std::get<std::string>(record.GetValue(index++));
+    auto root_page_id = static_cast<page_id_t>(std::get<int>(record.GetValue(index++)));
+    auto layout = static_cast<LeafLayout>(std::get<int>(record.GetValue(index++)));
+    int column_count = std::get<int>(record.GetValue(index++));
+    for (int i = 0; i < column_count; ++i) {
+        Column column;
+        column.name = std::get<std::string>(record.GetValue(index++));
+        column.type = std::get<std::string>(record.GetValue(index++));
+        table->columns.push_back(column);
+    }
+    table->index =
+        std::make_unique<BTree>(buffer_pool_manager_.get(), root_page_id, layout, GetRowFormat(table->columns));
+    int index_count = std::get<int>(record.GetValue(index++));
+    for (int i = 0; i < index_count; ++i) {
+        std::string name = std::get<std::string>(record.GetValue(index++));
+        int column = std::get<int>(record.GetValue(index++));
+        auto index_root = static_cast<page_id_t>(std::get<int>(record.GetValue(index++)));
+        table->indexes.push_back(
+            std::make_unique<SecondaryIndex>(name, column, buffer_pool_manager_.get(), index_root));
+    }
+    table->row_count = static_cast<uint64_t>(std::get<double>(record.GetValue(index++)));
+    return table;
 }
\ No newline at end of file
@@ -1,37 +1,166 @@
 #pragma once
 #include "storage_manager.h"
 #include "buffer_pool_manager.h"
+#include "log_manager.h"
 #include "btree.h"
+#include "secondary_index.h"
+#include "cursor.h"
+#include "vectorized_scan.h"
+#include "parallel_scan.h"
+#include "hash_aggregate.h"
+#include "hash_join.h"
 #include "sql_parser.h"
+#include "prepared_statement.h"
+#include "plan_cache.h"
+#include "catalog_page.h"
 #include <unordered_map>
 #include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <thread>
 
 struct Table {
     std::string name;
     std::vector<Column> columns;
     std::unique_ptr<BTree> index;
+    std::vector<std::unique_ptr<SecondaryIndex>> indexes;
+    uint64_t row_count{0};
+};
+
+// How an opened database refills the buffer pool with the pages that were
+// hot when they were last saved: not at all, before the constructor returns,
+// or with reads that queries overtake.
+enum class WarmRestart {
+    OFF,
+    BLOCKING,
+    BACKGROUND
+};
+
+struct DatabaseOptions {
+    size_t buffer_pool_frames{50};
+    WarmRestart warm_restart{WarmRestart::BACKGROUND};
+    ReplacerType replacer_type{ReplacerType::LRU_K};
+    StorageBackend storage_backend{StorageBackend::PREAD};
+    size_t checkpoint_log_bytes{16 * 1024 * 1024};
+    size_t hot_pages_save_seconds{60};  // besides every checkpoint; 0 saves them only then
+    size_t plan_cache_size{128};
+    size_t scan_threads{std::thread::hardware_concurrency()};
+    size_t aggregate_memory_bytes{16 * 1024 * 1024};  // groups held in memory before spilling
+    size_t sort_memory_bytes{16 * 1024 * 1024};       // rows sorted in memory before spilling runs
+};
+
+struct DatabaseStats {
+    StorageStats storage;
+    uint64_t buffer_pool_hits{0};
+    uint64_t buffer_pool_misses{0};
+    size_t warm_restart_pages{0};  // prefetched when the database was opened
+    uint64_t plan_cache_hits{0};
+    uint64_t plan_cache_misses{0};
 };
 
 class Database {
 public:
-    explicit Database(const std::string& db_file);
-    ~Database() = default;
+    explicit Database(const std::string& db_file, const DatabaseOptions& options = DatabaseOptions());
+    ~Database();
+
+    // False if the file could not be opened as a database, in which case
+    // every statement fails.
+    bool IsOpen() const { return open_; }
 
     bool ExecuteQuery(const std::string& sql);
-    std::vector<Record> GetLastResults() const { return last_results_; }
+    const std::vector<Record>& GetLastResults() const { return last_results_; }
+
+    // Opens a streaming cursor over the result of a SELECT. Returns nullptr if
+    // the statement cannot be parsed or is not a SELECT.
+    std::unique_ptr<Cursor> Query(const std::string& sql);
+
+    // Parses and resolves a statement once for repeated execution with '?'
+    // parameters. Returns nullptr if the statement is invalid.
+    std::unique_ptr<PreparedStatement> Prepare(const std::string& sql);
+
+    // Loads rows in strictly increasing key order into an empty table. Rows
+    // are not logged individually; the checkpoint that follows makes the load
+    // durable.
+    bool BulkLoad(const std::string& table_name, const std::function<bool(Record&)>& next,
+                  double fill_factor = DEFAULT_FILL_FACTOR);
+
+    // Writes back every dirty page and then the catalog, which reopening
+    // reads from page 0 of the file before replaying the log after it.
+    bool Checkpoint();
+
+    DatabaseStats GetStats() const;
+    bool GetRowCount(const std::string& table_name, uint64_t& row_count);
 
 private:
+    friend class PreparedStatement;
+
+    DatabaseOptions options_;
+    std::mutex latch_;
     std::unique_ptr<StorageManager> storage_manager_;
+    std::unique_ptr<LogManager> log_manager_;
     std::unique_ptr<BufferPoolManager> buffer_pool_manager_;
     std::unique_ptr<SQLParser> parser_;
+    std::unique_ptr<PlanCache> plan_cache_;
+    std::unique_ptr<WorkerPool> scan_pool_;
     std::unordered_map<std::string, std::unique_ptr<Table>> tables_;
     std::vector<Record> last_results_;
+    std::vector<page_id_t> hot_pages_;  // saved by an earlier run, for the warm restart
+    size_t warm_restart_pages_{0};
+    bool open_{false};
+
+    // The hot pages are saved to their own file, next to the log, both at
+    // checkpoints and on a timer, since checkpoints may be far apart.
+    std::string hot_pages_file_;
+    std::mutex hot_pages_latch_;
+    std::condition_variable hot_pages_cv_;
+    bool stop_saving_{false};
+    std::thread hot_pages_thread_;
+
+    std::shared_ptr<const Plan> GetPlan(const std::string& sql, std::vector<Value>* literals);
+    std::shared_ptr<const Plan> BuildPlan(std::unique_ptr<::Query> query);
+    bool ExecutePlan(const std::shared_ptr<const Plan>& plan, const std::vector<Value>& parameters);
+    std::unique_ptr<Cursor> QueryPlan(const std::shared_ptr<const Plan>& plan, const std::vector<Value>& parameters);
+
+    std::unique_ptr<Cursor> OpenCursor(const std::shared_ptr<const Plan>& plan, const std::vector<Value>& parameters,
+                                       std::mutex* latch, std::vector<int> columns);
+    std::vector<Value> BindConditionValues(const Plan& plan, const std::vector<Value>& parameters);
+    bool GetLimit(const Plan& plan, const std::vector<Value>& parameters, size_t& offset, size_t& limit);
+    static bool NeedsSort(const Plan& plan);
+    static bool GetScanFilters(const Plan& plan, std::vector<Value>& values, std::vector<BatchFilter>& filters);
+    void GetKeyRange(const Plan& plan, const std::vector<int>& key_conditions, const std::vector<Value>& values,
+                     btree_key_t& start_key, btree_key_t& end_key);
+    bool ExecuteSelect(const std::shared_ptr<const Plan>& plan, const std::vector<Value>& parameters);
+    bool ExecuteCursorSelect(const std::shared_ptr<const Plan>& plan, const std::vector<Value>& parameters,
+                             size_t offset, size_t limit);
+    bool ExecuteSortedSelect(const std::shared_ptr<const Plan>& plan, const std::vector<Value>& parameters,
+                             size_t offset, size_t wanted);
+    bool ForEachRow(const std::shared_ptr<const Plan>& plan, const std::vector<Value>& parameters,
+                    const std::function<void(Record&)>& emit);
+    bool ExecuteAggregate(const std::shared_ptr<const Plan>& plan, const std::vector<Value>& parameters);
+    bool ExecuteJoin(const Plan& plan, const std::vector<Value>& parameters, const std::function<void(Record&)>& emit);
+    void ScanRows(BTree* tree, btree_key_t start_key, btree_key_t end_key, std::vector<BatchFilter> filters,
+                  size_t column_count, const std::function<void(std::vector<Record>&)>& consume);
+    bool ExecuteInsert(const Plan& plan, const std::vector<Value>& parameters, lsn_t& commit_lsn);
+    bool ExecuteDelete(const std::shared_ptr<const Plan>& plan, const std::vector<Value>& parameters,
+                       lsn_t& commit_lsn);
+    bool ExecuteCreateTable(const ::Query& query, lsn_t& commit_lsn);
+    bool ExecuteCreateIndex(const ::Query& query);
+    bool PopulateIndex(Table& table, SecondaryIndex& index);
 
-    bool ExecuteSelect(const Query& query);
-    bool ExecuteInsert(const Query& query);
-    bool ExecuteCreateTable(const Query& query);
+    bool Recover();
+    lsn_t LogOperation(LogRecordType type, const std::string& table_name, int key, const std::string& payload,
+                       size_t lsn_count = 1);
+    std::string SerializeCatalog(const std::vector<page_id_t>& free_pages) const;
+    void LoadCatalog(const std::string& catalog);
+    bool SaveHotPages();
+    void LoadHotPages();
+    void SaveHotPagesLoop();
+    static void EncodeTable(const Table& table, Record& record);
+    std::unique_ptr<Table> DecodeTable(const Record& record, size_t& index);
+    static RowFormat GetRowFormat(const std::vector<Column>& columns);
     
-    bool EvaluateCondition(const Record& record, const Condition& condition, const Table& table);
-    int GetColumnIndex(const std::string& column_name, const Table& table);
-    Value GetRecordValue(const Record& record, int column_index);
+    static bool IsRange(CompareOp op);
+    int GetColumnIndex(std::string_view column_name, const Table& table);
+    int ResolveColumn(std::string_view column_name, const Plan& plan);
 };
\ No newline at end of file
@@ -0,0 +1,305 @@
+#include "external_sort.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+
+ExternalSort::ExternalSort(std::vector<SortKey> keys, size_t limit, BufferPoolManager* buffer_pool_manager,
+                           size_t memory_budget)
+    : keys_(std::move(keys)), limit_(limit), buffer_pool_manager_(buffer_pool_manager),
+      memory_budget_(memory_budget), heap_(limit != SIZE_MAX && !keys_.empty()) {}
+
+ExternalSort::~ExternalSort() {
+    for (auto& run : runs_) {
+        FreePages(run);
+    }
+}
+
+void ExternalSort::Add(Record record) {
+    // Without keys any limit_ rows will do, so the rest are not kept.
+    if (added_ == limit_) {
+        return;
+    }
+    if (keys_.empty()) {
+        ++added_;
+    }
+
+    size_t size = EstimateSize(record);
+    if (!heap_) {
+        rows_.push_back(std::move(record));
+        memory_used_ += size;
+        if (memory_used_ > memory_budget_) {
+            SortRows();
+            WriteRun(rows_);
+        }
+        return;
+    }
+
+    auto less = [this](const Record& a, const Record& b) { return Less(a, b); };
+    if (rows_.size() == limit_) {
+        if (!Less(record, rows_.front())) {
+            return;
+        }
+        std::pop_heap(rows_.begin(), rows_.end(), less);
+        memory_used_ -= EstimateSize(rows_.back());
+        rows_.back() = std::move(record);
+    } else {
+        rows_.push_back(std::move(record));
+    }
+    std::push_heap(rows_.begin(), rows_.end(), less);
+    memory_used_ += size;
+
+    // A heap larger than the budget becomes the first run, and the rest of
+    // the input is sorted in runs as without a limit.
+    if (memory_used_ > memory_budget_) {
+        std::sort_heap(rows_.begin(), rows_.end(), less);
+        heap_ = false;
+        WriteRun(rows_);
+    }
+}
+
+void ExternalSort::Finish() {
+    if (heap_) {
+        std::sort_heap(rows_.begin(), rows_.end(), [this](const Record& a, const Record& b) { return Less(a, b); });
+    } else {
+        SortRows();
+    }
+    if (!rows_.empty()) {
+        Run run;
+        run.rows = std::move(rows_);
+        runs_.push_back(std::move(run));
+        rows_.clear();
+    }
+
+    // Reading a run holds a page of it in memory, so the budget bounds how
+    // many runs are merged at once. A pass merges neighbouring runs only and
+    // keeps the merged runs in input order, so equal rows keep theirs.
+    size_t fan_in = std::max<size_t>(2, memory_budget_ / (2 * PAGE_SIZE));
+    while (runs_.size() > fan_in && !failed_) {
+        std::vector<Run> merged_runs;
+        for (size_t first = 0; first < runs_.size(); first += fan_in) {
+            size_t last = std::min(first + fan_in, runs_.size());
+            if (last - first == 1 || failed_) {
+                std::move(runs_.begin() + first, runs_.begin() + last, std::back_inserter(merged_runs));
+                continue;
+            }
+
+            StartMerge(first, last);
+            Run merged;
+            std::string page(RUN_HEADER_SIZE, '\0');
+            Record record;
+            for (size_t count = 0; count < limit_ && MergeNext(record) && !failed_; ++count) {
+                failed_ = !AppendRow(merged, page, record);
+            }
+            failed_ = failed_ || !FlushPage(merged, page);
+
+            for (size_t i = first; i < last; ++i) {
+                FreePages(runs_[i]);
+            }
+            merged_runs.push_back(std::move(merged));
+        }
+        runs_ = std::move(merged_runs);
+    }
+    if (failed_) {
+        std::cerr << "Sort failed to write a merged run" << std::endl;
+        return;
+    }
+    StartMerge(0, runs_.size());
+}
+
+bool ExternalSort::Next(Record& record) {
+    if (failed_ || returned_ >= limit_ || !MergeNext(record)) {
+        return false;
+    }
+    returned_++;
+    return true;
+}
+
+bool ExternalSort::Less(const Record& a, const Record& b) const {
+    static const Value ZERO = 0;
+    const auto& a_values = a.GetValues();
+    const auto& b_values = b.GetValues();
+    for (const auto& key : keys_) {
+        size_t column = static_cast<size_t>(key.column);
+        const Value& x = column < a_values.size() ? a_values[column] : ZERO;
+        const Value& y = column < b_values.size() ? b_values[column] : ZERO;
+        if (x < y) {
+            return !key.descending;
+        }
+        if (y < x) {
+            return key.descending;
+        }
+    }
+    return false;
+}
+
+size_t ExternalSort::EstimateSize(const Record& record) {
+    return sizeof(Record) + sizeof(Value) * record.GetValues().size() + record.GetSize();
+}
+
+void ExternalSort::SortRows() {
+    std::stable_sort(rows_.begin(), rows_.end(), [this](const Record& a, const Record& b) { return Less(a, b); });
+    if (rows_.size() > limit_) {
+        rows_.resize(limit_);
+    }
+}
+
+// A run that cannot be written for lack of a free frame stays in memory.
+bool ExternalSort::WriteRun(std::vector<Record>& rows) {
+    Run run;
+    std::string page(RUN_HEADER_SIZE, '\0');
+    bool written = true;
+    for (size_t i = 0; i < rows.size() && written; ++i) {
+        written = AppendRow(run, page, rows[i]);
+    }
+    written = written && FlushPage(run, page);
+    if (!written) {
+        FreePages(run);
+        run = Run();
+        run.rows = std::move(rows);
+    }
+
+    runs_.push_back(std::move(run));
+    rows.clear();
+    memory_used_ = 0;
+    return written;
+}
+
+// Rows are stored as a length followed by the serialized record, and may
+// continue from one page of the run onto the next.
+bool ExternalSort::AppendRow(Run& run, std::string& page, const Record& record) {
+    auto size = static_cast<uint32_t>(record.GetSize());
+    std::string bytes(sizeof(size) + size, '\0');
+    std::memcpy(bytes.data(), &size, sizeof(size));
+    record.Serialize(bytes.data() + sizeof(size));
+
+    for (size_t written = 0; written < bytes.size();) {
+        size_t count = std::min(bytes.size() - written, PAGE_SIZE - page.size());
+        page.append(bytes, written, count);
+        written += count;
+        if (page.size() == PAGE_SIZE && !FlushPage(run, page)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Pages start, after the LSN every page layout begins with, with the number
+// of bytes in use.
+bool ExternalSort::FlushPage(Run& run, std::string& page) {
+    if (page.size() == RUN_HEADER_SIZE) {
+        return true;
+    }
+
+    page_id_t page_id;
+    Page* frame = buffer_pool_manager_->NewPage(&page_id, true);
+    if (!frame) {
+        return false;
+    }
+    auto used = static_cast<uint32_t>(page.size());
+    std::memcpy(page.data() + sizeof(lsn_t), &used, sizeof(used));
+    std::memcpy(frame->GetData(), page.data(), page.size());
+    buffer_pool_manager_->UnpinPage(page_id, true);
+
+    run.pages.push_back(page_id);
+    page.resize(RUN_HEADER_SIZE);
+    return true;
+}
+
+// Each page is dropped from the buffer pool as soon as it has been read.
+bool ExternalSort::ReadBytes(Run& run, char* data, size_t size) {
+    while (size > 0) {
+        if (run.position == run.page.size()) {
+            if (run.next_page == run.pages.size()) {
+                return false;
+            }
+            page_id_t page_id = run.pages[run.next_page];
+            Page* page = buffer_pool_manager_->FetchPage(page_id);
+            if (!page) {
+                std::cerr << "Sort failed to read back page " << page_id << std::endl;
+                failed_ = true;
+                return false;
+            }
+            uint32_t used;
+            std::memcpy(&used, page->GetData() + sizeof(lsn_t), sizeof(used));
+            run.page.assign(page->GetData() + RUN_HEADER_SIZE, used - RUN_HEADER_SIZE);
+            run.position = 0;
+            buffer_pool_manager_->UnpinPage(page_id, false);
+            buffer_pool_manager_->DeletePage(page_id, true);
+            run.pages[run.next_page++] = INVALID_PAGE_ID;
+            continue;
+        }
+
+        size_t count = std::min(size, run.page.size() - run.position);
+        std::memcpy(data, run.page.data() + run.position, count);
+        run.position += count;
+        data += count;
+        size -= count;
+    }
+    return true;
+}
+
+bool ExternalSort::ReadRow(Run& run, Record& record) {
+    if (run.position < run.page.size() || run.next_page < run.pages.size()) {
+        uint32_t size;
+        if (!ReadBytes(run, reinterpret_cast<char*>(&size), sizeof(size))) {
+            return false;
+        }
+        std::string bytes(size, '\0');
+        if (!ReadBytes(run, bytes.data(), size)) {
+            return false;
+        }
+        size_t offset = 0;
+        record = Record::Deserialize(bytes.data(), offset);
+        return true;
+    }
+    if (run.next_row < run.rows.size()) {
+        record = std::move(run.rows[run.next_row++]);
+        return true;
+    }
+    return false;
+}
+
+void ExternalSort::FreePages(Run& run) {
+    for (page_id_t page_id : run.pages) {
+        if (page_id != INVALID_PAGE_ID) {
+            buffer_pool_manager_->DeletePage(page_id, true);
+        }
+    }
+    run.pages.clear();
+    run.next_page = 0;
+}
+
+// The merge heap orders runs by their current row, and equal rows by run, so
+// that earlier runs, holding earlier input, come first.
+void ExternalSort::StartMerge(size_t first, size_t last) {
+    heads_.assign(last, Record());
+    merge_.clear();
+    for (size_t run = first; run < last; ++run) {
+        if (ReadRow(runs_[run], heads_[run])) {
+            merge_.push_back(run);
+        }
+    }
+    std::make_heap(merge_.begin(), merge_.end(), [this](size_t a, size_t b) { return RunAfter(a, b); });
+}
+
+bool ExternalSort::RunAfter(size_t a, size_t b) const {
+    return Less(heads_[b], heads_[a]) || (!Less(heads_[a], heads_[b]) && a > b);
+}
+
+bool ExternalSort::MergeNext(Record& record) {
+    if (merge_.empty()) {
+        return false;
+    }
+
+    auto after = [this](size_t a, size_t b) { return RunAfter(a, b); };
+    std::pop_heap(merge_.begin(), merge_.end(), after);
+    size_t run = merge_.back();
+    record = std::move(heads_[run]);
+    if (ReadRow(runs_[run], heads_[run])) {
+        std::push_heap(merge_.begin(), merge_.end(), after);
+    } else {
+        merge_.pop_back();
+    }
+    return true;
+}
\ No newline at end of file
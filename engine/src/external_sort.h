@@ -0,0 +1,82 @@
+#pragma once
+#include "buffer_pool_manager.h"
+#include "record.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct SortKey {
+    int column;
+    bool descending;
+};
+
+// Sorts rows on a list of columns, comparing values as the variant does, and
+// returns at most limit of them. Rows are sorted in memory up to the budget;
+// past it each sorted buffer is written out as a run of buffer-pool pages and
+// the runs are merged as the rows are read back, in several passes if there
+// are more runs than the budget has room to read from at once. With a limit,
+// the first limit rows are kept in a bounded heap and nothing spills unless
+// the heap itself outgrows the budget; without keys the first limit rows are
+// kept as they come. Rows that compare equal come out in the order they were
+// added, except from the heap.
+class ExternalSort {
+public:
+    static constexpr size_t RUN_HEADER_SIZE = sizeof(lsn_t) + sizeof(uint32_t);
+
+    ExternalSort(std::vector<SortKey> keys, size_t limit, BufferPoolManager* buffer_pool_manager,
+                 size_t memory_budget);
+    ~ExternalSort();
+
+    ExternalSort(const ExternalSort&) = delete;
+    ExternalSort& operator=(const ExternalSort&) = delete;
+
+    void Add(Record record);
+    // Ends the input. Rows are read with Next from then on.
+    void Finish();
+    bool Next(Record& record);
+
+    size_t GetRunCount() const { return runs_.size(); }
+
+private:
+    // A sorted run: pages holding length-prefixed serialized rows, read
+    // back one page at a time, or rows still in memory.
+    struct Run {
+        std::vector<page_id_t> pages;
+        std::vector<Record> rows;
+        size_t next_page{0};
+        size_t next_row{0};
+        std::string page;  // unread bytes of the page being read
+        size_t position{0};
+    };
+
+    std::vector<SortKey> keys_;
+    size_t limit_;
+    BufferPoolManager* buffer_pool_manager_;
+    size_t memory_budget_;
+    size_t memory_used_{0};
+    bool heap_;  // rows_ is a max-heap of the first limit_ rows
+    bool failed_{false};
+    size_t added_{0};  // rows kept when there are no keys
+
+    std::vector<Record> rows_;
+    std::vector<Run> runs_;
+    std::vector<Record> heads_;  // current row of each run being merged
+    std::vector<size_t> merge_;  // heap of runs by their current row
+    size_t returned_{0};
+
+    bool Less(const Record& a, const Record& b) const;
+    static size_t EstimateSize(const Record& record);
+    void SortRows();
+    bool WriteRun(std::vector<Record>& rows);
+
+    bool AppendRow(Run& run, std::string& page, const Record& record);
+    bool FlushPage(Run& run, std::string& page);
+    bool ReadBytes(Run& run, char* data, size_t size);
+    bool ReadRow(Run& run, Record& record);
+    void FreePages(Run& run);
+
+    // Merges the runs from first up to last.
+    void StartMerge(size_t first, size_t last);
+    bool RunAfter(size_t a, size_t b) const;
+    bool MergeNext(Record& record);
+};
\ No newline at end of file
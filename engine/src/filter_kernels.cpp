@@ -0,0 +1,183 @@
+#include "filter_kernels.h"
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define SIMPLEDB_HAVE_AVX2
+#include <immintrin.h>
+#endif
+
+static bool avx2_enabled = FilterKernels::IsAvx2Supported();
+
+template <CompareOp OP, typename T>
+static size_t FilterScalar(const ColumnVector& column, ValueTag tag, const T& constant, bool dense, size_t count,
+                           uint16_t* selection) {
+    auto matches = [&](size_t row) {
+        if (column.tags[row] != static_cast<uint8_t>(tag)) {
+            return false;
+        }
+        if constexpr (std::is_same_v<T, int32_t>) {
+            return Compare<OP>(column.ints[row], constant);
+        } else if constexpr (std::is_same_v<T, double>) {
+            return Compare<OP>(column.doubles[row], constant);
+        } else {
+            return Compare<OP>(column.StringAt(row), constant);
+        }
+    };
+
+    size_t selected = 0;
+    if (dense) {
+        for (size_t row = 0; row < count; ++row) {
+            selection[selected] = static_cast<uint16_t>(row);
+            selected += matches(row);
+        }
+    } else {
+        for (size_t i = 0; i < count; ++i) {
+            uint16_t row = selection[i];
+            selection[selected] = row;
+            selected += matches(row);
+        }
+    }
+    return selected;
+}
+
+#ifdef SIMPLEDB_HAVE_AVX2
+__attribute__((target("avx2"))) static inline size_t AppendMatches(unsigned mask, size_t row, uint16_t* selection,
+                                                                    size_t selected) {
+    while (mask) {
+        selection[selected++] = static_cast<uint16_t>(row + __builtin_ctz(mask));
+        mask &= mask - 1;
+    }
+    return selected;
+}
+
+template <CompareOp OP>
+__attribute__((target("avx2"))) static size_t FilterIntAvx2(const ColumnVector& column, int32_t constant,
+                                                            size_t count, uint16_t* selection) {
+    const __m256i constants = _mm256_set1_epi32(constant);
+    const __m256i int_tag = _mm256_set1_epi32(static_cast<int>(ValueTag::INT));
+    const __m256i ones = _mm256_set1_epi32(-1);
+
+    size_t selected = 0;
+    size_t row = 0;
+    for (; row + 8 <= count; row += 8) {
+        __m256i values = _mm256_load_si256(reinterpret_cast<const __m256i*>(column.ints.data() + row));
+        __m128i tag_bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(column.tags.data() + row));
+        __m256i is_int = _mm256_cmpeq_epi32(_mm256_cvtepu8_epi32(tag_bytes), int_tag);
+
+        __m256i hits;
+        if constexpr (OP == CompareOp::EQ) {
+            hits = _mm256_cmpeq_epi32(values, constants);
+        } else if constexpr (OP == CompareOp::NE) {
+            hits = _mm256_xor_si256(_mm256_cmpeq_epi32(values, constants), ones);
+        } else if constexpr (OP == CompareOp::LT) {
+            hits = _mm256_cmpgt_epi32(constants, values);
+        } else if constexpr (OP == CompareOp::LE) {
+            hits = _mm256_xor_si256(_mm256_cmpgt_epi32(values, constants), ones);
+        } else if constexpr (OP == CompareOp::GT) {
+            hits = _mm256_cmpgt_epi32(values, constants);
+        } else {
+            hits = _mm256_xor_si256(_mm256_cmpgt_epi32(constants, values), ones);
+        }
+        hits = _mm256_and_si256(hits, is_int);
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(hits)));
+        selected = AppendMatches(mask, row, selection, selected);
+    }
+
+    for (; row < count; ++row) {
+        selection[selected] = static_cast<uint16_t>(row);
+        selected += column.tags[row] == static_cast<uint8_t>(ValueTag::INT) && Compare<OP>(column.ints[row], constant);
+    }
+    return selected;
+}
+
+template <CompareOp OP>
+__attribute__((target("avx2"))) static size_t FilterDoubleAvx2(const ColumnVector& column, double constant,
+                                                               size_t count, uint16_t* selection) {
+    constexpr int PREDICATE = OP == CompareOp::EQ   ? _CMP_EQ_OQ
+                              : OP == CompareOp::NE ? _CMP_NEQ_UQ
+                              : OP == CompareOp::LT ? _CMP_LT_OQ
+                              : OP == CompareOp::LE ? _CMP_LE_OQ
+                              : OP == CompareOp::GT ? _CMP_GT_OQ
+                                                    : _CMP_GE_OQ;
+    const __m256d constants = _mm256_set1_pd(constant);
+    const __m256i double_tag = _mm256_set1_epi64x(static_cast<int>(ValueTag::DOUBLE));
+
+    size_t selected = 0;
+    size_t row = 0;
+    for (; row + 4 <= count; row += 4) {
+        __m256d values = _mm256_load_pd(column.doubles.data() + row);
+        int32_t tag_word;
+        std::memcpy(&tag_word, column.tags.data() + row, sizeof(tag_word));
+        __m256i tags = _mm256_cvtepu8_epi64(_mm_cvtsi32_si128(tag_word));
+        __m256d is_double = _mm256_castsi256_pd(_mm256_cmpeq_epi64(tags, double_tag));
+
+        __m256d hits = _mm256_and_pd(_mm256_cmp_pd(values, constants, PREDICATE), is_double);
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_pd(hits));
+        selected = AppendMatches(mask, row, selection, selected);
+    }
+
+    for (; row < count; ++row) {
+        selection[selected] = static_cast<uint16_t>(row);
+        selected += column.tags[row] == static_cast<uint8_t>(ValueTag::DOUBLE) &&
+                    Compare<OP>(column.doubles[row], constant);
+    }
+    return selected;
+}
+#endif
+
+template <CompareOp OP>
+static size_t FilterOp(const ColumnVector& column, const Value& constant, bool dense, size_t count,
+                       uint16_t* selection) {
+    if (std::holds_alternative<int>(constant)) {
+        int32_t value = std::get<int>(constant);
+#ifdef SIMPLEDB_HAVE_AVX2
+        if (dense && avx2_enabled) {
+            return FilterIntAvx2<OP>(column, value, count, selection);
+        }
+#endif
+        return FilterScalar<OP>(column, ValueTag::INT, value, dense, count, selection);
+    } else if (std::holds_alternative<double>(constant)) {
+        double value = std::get<double>(constant);
+#ifdef SIMPLEDB_HAVE_AVX2
+        if (dense && avx2_enabled) {
+            return FilterDoubleAvx2<OP>(column, value, count, selection);
+        }
+#endif
+        return FilterScalar<OP>(column, ValueTag::DOUBLE, value, dense, count, selection);
+    }
+
+    std::string_view value = std::get<std::string>(constant);
+    return FilterScalar<OP>(column, ValueTag::STRING, value, dense, count, selection);
+}
+
+size_t FilterKernels::Filter(const ColumnVector& column, CompareOp op, const Value& constant, bool dense,
+                             size_t count, uint16_t* selection) {
+    switch (op) {
+        case CompareOp::EQ:
+            return FilterOp<CompareOp::EQ>(column, constant, dense, count, selection);
+        case CompareOp::NE:
+            return FilterOp<CompareOp::NE>(column, constant, dense, count, selection);
+        case CompareOp::LT:
+            return FilterOp<CompareOp::LT>(column, constant, dense, count, selection);
+        case CompareOp::LE:
+            return FilterOp<CompareOp::LE>(column, constant, dense, count, selection);
+        case CompareOp::GT:
+            return FilterOp<CompareOp::GT>(column, constant, dense, count, selection);
+        case CompareOp::GE:
+        default:
+            return FilterOp<CompareOp::GE>(column, constant, dense, count, selection);
+    }
+}
+
+bool FilterKernels::IsAvx2Supported() {
+#ifdef SIMPLEDB_HAVE_AVX2
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+void FilterKernels::SetAvx2Enabled(bool enabled) {
+    avx2_enabled = enabled && IsAvx2Supported();
+}
\ No newline at end of file
@@ -0,0 +1,21 @@
+#pragma once
+#include "column_batch.h"
+#include "compare_op.h"
+#include <cstdint>
+
+// Predicate kernels over a ColumnVector producing selection vectors. Integer
+// and double comparisons use AVX2 when the CPU supports it and scalar loops
+// otherwise. As in CompiledPredicate, a value of another type than the
+// constant never matches.
+class FilterKernels {
+public:
+    // Narrows selection to the rows where "column op constant" holds and
+    // returns its new size. With dense set, the input selection is every row
+    // in [0, count) and is not read.
+    static size_t Filter(const ColumnVector& column, CompareOp op, const Value& constant, bool dense,
+                         size_t count, uint16_t* selection);
+
+    static bool IsAvx2Supported();
+    // Lets benchmarks compare against the scalar kernels.
+    static void SetAvx2Enabled(bool enabled);
+};
\ No newline at end of file
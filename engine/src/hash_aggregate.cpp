@@ -0,0 +1,372 @@
+#include "hash_aggregate.h"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <functional>
+#include <string>
+
+HashAggregate::HashAggregate(std::vector<int> group_columns, std::vector<AggregateInput> inputs,
+                             BufferPoolManager* buffer_pool_manager, size_t memory_budget)
+    : group_columns_(std::move(group_columns)), inputs_(std::move(inputs)),
+      buffer_pool_manager_(buffer_pool_manager), memory_budget_(memory_budget),
+      key_(group_columns_.size()), values_(inputs_.size()) {}
+
+HashAggregate::~HashAggregate() {
+    for (const auto& pages : partitions_) {
+        for (page_id_t page_id : pages) {
+            buffer_pool_manager_->DeletePage(page_id, true);
+        }
+    }
+}
+
+void HashAggregate::Add(const Record& record) {
+    for (size_t i = 0; i < group_columns_.size(); ++i) {
+        key_[i] = record.GetValue(group_columns_[i]);
+    }
+    for (size_t i = 0; i < inputs_.size(); ++i) {
+        values_[i] = inputs_[i].column < 0 ? Value(0) : record.GetValue(inputs_[i].column);
+    }
+    AddRow();
+}
+
+void HashAggregate::AddBatch(const ColumnBatch& batch) {
+    const uint16_t* selection = batch.GetSelection();
+    for (size_t s = 0; s < batch.GetSelectedCount(); ++s) {
+        size_t row = selection[s];
+        for (size_t i = 0; i < group_columns_.size(); ++i) {
+            key_[i] = batch.GetColumn(group_columns_[i]).ValueAt(row);
+        }
+        // Sums and counts are taken straight from the column arrays; only
+        // MIN and MAX need the value itself.
+        Group& group = FindOrInsert(key_, HashKey(key_));
+        for (size_t i = 0; i < inputs_.size(); ++i) {
+            const AggregateInput& input = inputs_[i];
+            State& state = group.states[i];
+            if (input.column < 0) {
+                state.count++;
+                continue;
+            }
+            const ColumnVector& column = batch.GetColumn(input.column);
+            if (input.function == AggregateFunction::MIN || input.function == AggregateFunction::MAX) {
+                Accumulate(input, state, column.ValueAt(row));
+                continue;
+            }
+            state.count++;
+            if (column.tags[row] == static_cast<uint8_t>(ValueTag::INT)) {
+                state.int_sum += column.ints[row];
+                state.sum += column.ints[row];
+            } else if (column.tags[row] == static_cast<uint8_t>(ValueTag::DOUBLE)) {
+                state.sum += column.doubles[row];
+                state.exact = false;
+            }
+        }
+        if (memory_used_ > memory_budget_) {
+            Spill();
+        }
+    }
+}
+
+void HashAggregate::Merge(HashAggregate& other) {
+    if (!other.partitions_.empty()) {
+        partitions_.resize(SPILL_PARTITIONS);
+        for (size_t p = 0; p < SPILL_PARTITIONS; ++p) {
+            auto& pages = other.partitions_[p];
+            partitions_[p].insert(partitions_[p].end(), pages.begin(), pages.end());
+        }
+        other.partitions_.clear();
+    }
+
+    for (auto& group : other.groups_) {
+        Group& mine = FindOrInsert(group.key, group.hash);
+        for (size_t i = 0; i < inputs_.size(); ++i) {
+            Combine(inputs_[i], mine.states[i], group.states[i]);
+        }
+        if (memory_used_ > memory_budget_) {
+            Spill();
+        }
+    }
+    other.Clear();
+}
+
+std::vector<Record> HashAggregate::Finish() {
+    std::vector<Group> groups;
+    if (partitions_.empty()) {
+        groups = std::move(groups_);
+    } else {
+        // Groups that stay in memory after the last spill are combined with
+        // their partition, which may hold earlier spills of the same keys.
+        Spill();
+        std::vector<std::vector<Group>> kept(SPILL_PARTITIONS);
+        for (auto& group : groups_) {
+            kept[group.hash >> 60].push_back(std::move(group));
+        }
+        Clear();
+        for (size_t partition = 0; partition < SPILL_PARTITIONS; ++partition) {
+            LoadPartition(partitions_[partition]);
+            for (auto& group : kept[partition]) {
+                Group& loaded = FindOrInsert(group.key, group.hash);
+                for (size_t i = 0; i < inputs_.size(); ++i) {
+                    Combine(inputs_[i], loaded.states[i], group.states[i]);
+                }
+            }
+            std::move(groups_.begin(), groups_.end(), std::back_inserter(groups));
+            Clear();
+        }
+        partitions_.clear();
+    }
+    Clear();
+
+    if (group_columns_.empty() && groups.empty()) {
+        groups.push_back(Group{0, {}, std::vector<State>(inputs_.size())});
+    }
+    std::sort(groups.begin(), groups.end(), [](const Group& a, const Group& b) { return a.key < b.key; });
+
+    std::vector<Record> rows;
+    rows.reserve(groups.size());
+    for (const auto& group : groups) {
+        Record row(group.key);
+        for (size_t i = 0; i < inputs_.size(); ++i) {
+            row.AddValue(Result(inputs_[i], group.states[i]));
+        }
+        rows.push_back(std::move(row));
+    }
+    return rows;
+}
+
+void HashAggregate::AddRow() {
+    Group& group = FindOrInsert(key_, HashKey(key_));
+    for (size_t i = 0; i < inputs_.size(); ++i) {
+        Accumulate(inputs_[i], group.states[i], values_[i]);
+    }
+    if (memory_used_ > memory_budget_) {
+        Spill();
+    }
+}
+
+// Linear probing over a power-of-two slot array kept at most half full.
+HashAggregate::Group& HashAggregate::FindOrInsert(std::vector<Value>& key, uint64_t hash) {
+    if (slots_.empty()) {
+        Rehash(64);
+    }
+
+    size_t mask = slots_.size() - 1;
+    for (size_t slot = hash & mask;; slot = (slot + 1) & mask) {
+        uint32_t entry = slots_[slot];
+        if (entry == 0) {
+            groups_.push_back(Group{hash, key, std::vector<State>(inputs_.size())});
+            slots_[slot] = static_cast<uint32_t>(groups_.size());
+            memory_used_ += sizeof(Group) + sizeof(uint32_t) * 2 + sizeof(Value) * key.size() +
+                            sizeof(State) * inputs_.size();
+            for (const auto& value : key) {
+                if (const auto* text = std::get_if<std::string>(&value)) {
+                    memory_used_ += text->size();
+                }
+            }
+            if (groups_.size() * 2 > slots_.size()) {
+                Rehash(slots_.size() * 2);
+            }
+            return groups_.back();
+        }
+        Group& group = groups_[entry - 1];
+        if (group.hash == hash && group.key == key) {
+            return group;
+        }
+    }
+}
+
+void HashAggregate::Accumulate(const AggregateInput& input, State& state, const Value& value) const {
+    state.count++;
+    if (const int* number = std::get_if<int>(&value)) {
+        state.int_sum += *number;
+        state.sum += *number;
+    } else if (const double* real = std::get_if<double>(&value)) {
+        state.sum += *real;
+        state.exact = false;
+    }
+
+    if ((input.function == AggregateFunction::MIN && (state.count == 1 || value < state.extreme)) ||
+        (input.function == AggregateFunction::MAX && (state.count == 1 || state.extreme < value))) {
+        state.extreme = value;
+    }
+}
+
+void HashAggregate::Combine(const AggregateInput& input, State& state, const State& other) const {
+    if (other.count == 0) {
+        return;
+    }
+    if ((input.function == AggregateFunction::MIN && (state.count == 0 || other.extreme < state.extreme)) ||
+        (input.function == AggregateFunction::MAX && (state.count == 0 || state.extreme < other.extreme))) {
+        state.extreme = other.extreme;
+    }
+    state.count += other.count;
+    state.sum += other.sum;
+    state.int_sum += other.int_sum;
+    state.exact = state.exact && other.exact;
+}
+
+Value HashAggregate::Result(const AggregateInput& input, const State& state) const {
+    switch (input.function) {
+        case AggregateFunction::COUNT:
+            return static_cast<int>(state.count);
+        case AggregateFunction::SUM:
+            if (state.exact && state.int_sum >= INT_MIN && state.int_sum <= INT_MAX) {
+                return static_cast<int>(state.int_sum);
+            }
+            return state.exact ? static_cast<double>(state.int_sum) : state.sum;
+        case AggregateFunction::AVG:
+            if (state.count == 0) {
+                return 0.0;
+            }
+            return (state.exact ? static_cast<double>(state.int_sum) : state.sum) / state.count;
+        case AggregateFunction::MIN:
+        case AggregateFunction::MAX:
+            return state.count == 0 ? Value(0) : state.extreme;
+        default:
+            return 0;
+    }
+}
+
+void HashAggregate::Rehash(size_t slot_count) {
+    slots_.assign(slot_count, 0);
+    size_t mask = slot_count - 1;
+    for (size_t i = 0; i < groups_.size(); ++i) {
+        size_t slot = groups_[i].hash & mask;
+        while (slots_[slot] != 0) {
+            slot = (slot + 1) & mask;
+        }
+        slots_[slot] = static_cast<uint32_t>(i + 1);
+    }
+}
+
+void HashAggregate::Clear() {
+    groups_.clear();
+    slots_.clear();
+    memory_used_ = 0;
+}
+
+// Groups are written as records of their key values followed by five values
+// per aggregate state, packed into pages that start, after the LSN every page
+// layout begins with, with their used length.
+// Partitions use the top bits of the hash, the slots the bottom ones. A group
+// too large for a page, or one that finds no free frame, stays in memory.
+void HashAggregate::Spill() {
+    partitions_.resize(SPILL_PARTITIONS);
+    std::vector<std::string> buffers(SPILL_PARTITIONS, std::string(SPILL_HEADER_SIZE, '\0'));
+    std::vector<std::vector<size_t>> pending(SPILL_PARTITIONS);
+    std::vector<bool> spilled(groups_.size(), false);
+
+    auto flush = [&](size_t partition) {
+        std::string& buffer = buffers[partition];
+        page_id_t page_id;
+        Page* page = buffer_pool_manager_->NewPage(&page_id, true);
+        if (!page) {
+            return false;
+        }
+        auto used = static_cast<uint32_t>(buffer.size());
+        std::memcpy(buffer.data() + sizeof(lsn_t), &used, sizeof(used));
+        std::memcpy(page->GetData(), buffer.data(), buffer.size());
+        buffer_pool_manager_->UnpinPage(page_id, true);
+
+        partitions_[partition].push_back(page_id);
+        for (size_t index : pending[partition]) {
+            spilled[index] = true;
+        }
+        pending[partition].clear();
+        buffer.resize(SPILL_HEADER_SIZE);
+        return true;
+    };
+
+    bool spilling = true;
+    for (size_t i = 0; i < groups_.size() && spilling; ++i) {
+        const Group& group = groups_[i];
+        Record record(group.key);
+        for (const auto& state : group.states) {
+            record.AddValue(static_cast<double>(state.count));
+            record.AddValue(state.sum);
+            record.AddValue(static_cast<double>(state.int_sum));
+            record.AddValue(state.exact ? 1 : 0);
+            record.AddValue(state.extreme);
+        }
+
+        size_t size = record.GetSize();
+        if (SPILL_HEADER_SIZE + size > PAGE_SIZE) {
+            continue;
+        }
+        size_t partition = group.hash >> 60;
+        if (buffers[partition].size() + size > PAGE_SIZE && !flush(partition)) {
+            spilling = false;
+            break;
+        }
+        std::string& buffer = buffers[partition];
+        size_t offset = buffer.size();
+        buffer.resize(offset + size);
+        record.Serialize(buffer.data() + offset);
+        pending[partition].push_back(i);
+    }
+    for (size_t partition = 0; partition < SPILL_PARTITIONS && spilling; ++partition) {
+        if (!pending[partition].empty()) {
+            flush(partition);
+        }
+    }
+
+    std::vector<Group> kept;
+    for (size_t i = 0; i < groups_.size(); ++i) {
+        if (!spilled[i]) {
+            kept.push_back(std::move(groups_[i]));
+        }
+    }
+    Clear();
+    for (auto& group : kept) {
+        Group& slot = FindOrInsert(group.key, group.hash);
+        slot.states = std::move(group.states);
+    }
+}
+
+void HashAggregate::LoadPartition(const std::vector<page_id_t>& pages) {
+    size_t key_size = group_columns_.size();
+    std::vector<Value> key(key_size);
+    State state;
+
+    for (page_id_t page_id : pages) {
+        Page* page = buffer_pool_manager_->FetchPage(page_id);
+        if (!page) {
+            continue;
+        }
+        const char* data = page->GetData();
+        uint32_t used;
+        std::memcpy(&used, data + sizeof(lsn_t), sizeof(used));
+
+        size_t offset = SPILL_HEADER_SIZE;
+        while (offset < used) {
+            Record record = Record::Deserialize(data, offset);
+            const auto& values = record.GetValues();
+            std::copy(values.begin(), values.begin() + key_size, key.begin());
+            Group& group = FindOrInsert(key, HashKey(key));
+            for (size_t i = 0; i < inputs_.size(); ++i) {
+                size_t base = key_size + i * 5;
+                state.count = static_cast<int64_t>(std::get<double>(values[base]));
+                state.sum = std::get<double>(values[base + 1]);
+                state.int_sum = static_cast<int64_t>(std::get<double>(values[base + 2]));
+                state.exact = std::get<int>(values[base + 3]) != 0;
+                state.extreme = values[base + 4];
+                Combine(inputs_[i], group.states[i], state);
+            }
+        }
+        buffer_pool_manager_->UnpinPage(page_id, false);
+        buffer_pool_manager_->DeletePage(page_id, true);
+    }
+}
+
+uint64_t HashAggregate::HashKey(const std::vector<Value>& key) {
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (const auto& value : key) {
+        size_t part = std::visit([](const auto& v) { return std::hash<std::decay_t<decltype(v)>>()(v); }, value);
+        hash = (hash ^ (part + value.index())) * 0x100000001b3ull;
+    }
+    // Final mix so that both the low bits (slots) and the high bits
+    // (partitions) depend on every key value.
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdull;
+    hash ^= hash >> 33;
+    return hash;
+}
\ No newline at end of file
@@ -0,0 +1,84 @@
+#pragma once
+#include "buffer_pool_manager.h"
+#include "column_batch.h"
+#include "record.h"
+#include "sql_parser.h"
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+struct AggregateInput {
+    AggregateFunction function;
+    int column;  // -1 for COUNT(*)
+};
+
+// GROUP BY over an open-addressing hash table of groups. Once the groups
+// held in memory exceed the budget they are written out to temporary pages,
+// hash-partitioned, and each partition is aggregated on its own in Finish.
+// Tables built on separate threads are combined with Merge.
+//
+// There are no NULLs: an aggregate of no rows, or of a column a row does not
+// have, reads as 0. Values of different types order by type, as the variant
+// does, so MIN and MAX of a mixed column never compare an int with a string.
+class HashAggregate {
+public:
+    static constexpr size_t SPILL_PARTITIONS = 16;
+    static constexpr size_t SPILL_HEADER_SIZE = sizeof(lsn_t) + sizeof(uint32_t);
+
+    HashAggregate(std::vector<int> group_columns, std::vector<AggregateInput> inputs,
+                  BufferPoolManager* buffer_pool_manager, size_t memory_budget);
+    ~HashAggregate();
+
+    HashAggregate(const HashAggregate&) = delete;
+    HashAggregate& operator=(const HashAggregate&) = delete;
+
+    void Add(const Record& record);
+    // Adds the selected rows of a batch.
+    void AddBatch(const ColumnBatch& batch);
+    // Moves every group of other, in memory or spilled, into this table.
+    void Merge(HashAggregate& other);
+
+    // One row per group, ordered by group key: the group column values
+    // followed by the aggregates. Without group columns there is always
+    // exactly one row.
+    std::vector<Record> Finish();
+
+private:
+    struct State {
+        int64_t count{0};
+        double sum{0};
+        int64_t int_sum{0};
+        bool exact{true};  // every value summed was an int
+        Value extreme;     // MIN or MAX so far
+    };
+
+    struct Group {
+        uint64_t hash;
+        std::vector<Value> key;
+        std::vector<State> states;
+    };
+
+    std::vector<int> group_columns_;
+    std::vector<AggregateInput> inputs_;
+    BufferPoolManager* buffer_pool_manager_;
+    size_t memory_budget_;
+    size_t memory_used_{0};
+
+    std::vector<Group> groups_;
+    std::vector<uint32_t> slots_;  // index into groups_ plus one, 0 when free
+    std::vector<Value> key_;       // scratch key of the row being added
+    std::vector<Value> values_;    // scratch aggregate inputs of the row being added
+    std::vector<std::vector<page_id_t>> partitions_;
+
+    void AddRow();
+    Group& FindOrInsert(std::vector<Value>& key, uint64_t hash);
+    void Accumulate(const AggregateInput& input, State& state, const Value& value) const;
+    void Combine(const AggregateInput& input, State& state, const State& other) const;
+    Value Result(const AggregateInput& input, const State& state) const;
+    void Rehash(size_t slot_count);
+    void Clear();
+
+    void Spill();
+    void LoadPartition(const std::vector<page_id_t>& pages);
+    static uint64_t HashKey(const std::vector<Value>& key);
+};
\ No newline at end of file
@@ -0,0 +1,100 @@
+#include "hash_join.h"
+#include <functional>
+#include <string>
+
+HashJoin::HashJoin(int build_column, int probe_column) : build_column_(build_column), probe_column_(probe_column) {}
+
+void HashJoin::Build(std::vector<Record> rows) {
+    while ((rows.size() >> radix_bits_) > PARTITION_ROWS) {
+        radix_bits_++;
+    }
+
+    std::vector<uint64_t> hashes;
+    hashes.reserve(rows.size());
+    for (const auto& row : rows) {
+        hashes.push_back(HashValue(row.GetValue(build_column_)));
+    }
+    std::vector<size_t> starts;
+    std::vector<uint32_t> order = Cluster(hashes, starts);
+
+    rows_.clear();
+    hashes_.clear();
+    rows_.reserve(rows.size());
+    hashes_.reserve(rows.size());
+    for (uint32_t i : order) {
+        rows_.push_back(std::move(rows[i]));
+        hashes_.push_back(hashes[i]);
+    }
+
+    // Each partition chains its rows through buckets picked by the hash bits
+    // above the partition bits, at no more than one row per two buckets.
+    next_.assign(rows_.size(), 0);
+    heads_.clear();
+    partitions_.clear();
+    for (size_t p = 0; p < GetPartitionCount(); ++p) {
+        size_t count = starts[p + 1] - starts[p];
+        uint64_t buckets = 1;
+        while (buckets < count * 2) {
+            buckets <<= 1;
+        }
+        Partition partition{heads_.size(), buckets - 1};
+        heads_.resize(heads_.size() + buckets, 0);
+        for (size_t row = starts[p]; row < starts[p + 1]; ++row) {
+            uint32_t& head = heads_[partition.heads + ((hashes_[row] >> radix_bits_) & partition.mask)];
+            next_[row] = head;
+            head = static_cast<uint32_t>(row + 1);
+        }
+        partitions_.push_back(partition);
+    }
+}
+
+void HashJoin::Probe(const std::vector<Record>& rows,
+                     const std::function<void(const Record& probe, const Record& build)>& match) const {
+    if (rows_.empty()) {
+        return;
+    }
+
+    std::vector<uint64_t> hashes;
+    hashes.reserve(rows.size());
+    for (const auto& row : rows) {
+        hashes.push_back(HashValue(row.GetValue(probe_column_)));
+    }
+    std::vector<size_t> starts;
+    std::vector<uint32_t> order = Cluster(hashes, starts);
+
+    for (uint32_t i : order) {
+        const Partition& partition = partitions_[hashes[i] & (GetPartitionCount() - 1)];
+        Value value = rows[i].GetValue(probe_column_);
+        uint32_t entry = heads_[partition.heads + ((hashes[i] >> radix_bits_) & partition.mask)];
+        for (; entry != 0; entry = next_[entry - 1]) {
+            const Record& row = rows_[entry - 1];
+            if (hashes_[entry - 1] == hashes[i] && row.GetValue(build_column_) == value) {
+                match(rows[i], row);
+            }
+        }
+    }
+}
+
+uint64_t HashJoin::HashValue(const Value& value) {
+    uint64_t hash = std::visit([](const auto& v) { return std::hash<std::decay_t<decltype(v)>>()(v); }, value);
+    hash = (hash + value.index()) * 0x9e3779b97f4a7c15ull;
+    return hash ^ (hash >> 29);
+}
+
+std::vector<uint32_t> HashJoin::Cluster(const std::vector<uint64_t>& hashes, std::vector<size_t>& starts) const {
+    size_t mask = GetPartitionCount() - 1;
+    starts.assign(GetPartitionCount() + 1, 0);
+    for (uint64_t hash : hashes) {
+        starts[(hash & mask) + 1]++;
+    }
+    for (size_t p = 0; p < GetPartitionCount(); ++p) {
+        starts[p + 1] += starts[p];
+    }
+
+    std::vector<size_t> positions(starts.begin(), starts.end() - 1);
+    std::vector<uint32_t> order(hashes.size());
+    for (size_t i = 0; i < hashes.size(); ++i) {
+        order[positions[hashes[i] & mask]++] = static_cast<uint32_t>(i);
+    }
+    return order;
+}
\ No newline at end of file
@@ -0,0 +1,46 @@
+#pragma once
+#include "record.h"
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Equi-join of build rows against probe rows on one column of each. A small
+// build goes into a single chained hash table. A larger one is first radix
+// partitioned on the low bits of the hash, with a table per partition small
+// enough to stay in cache; each probe batch is partitioned the same way and
+// joined one partition at a time.
+class HashJoin {
+public:
+    static constexpr size_t PARTITION_ROWS = 2048;  // build rows per partition, at most
+
+    HashJoin(int build_column, int probe_column);
+    ~HashJoin() = default;
+
+    void Build(std::vector<Record> rows);
+    // Calls match(probe row, build row) for each matching pair. Pairs come
+    // out grouped by partition, not in probe order.
+    void Probe(const std::vector<Record>& rows,
+               const std::function<void(const Record& probe, const Record& build)>& match) const;
+
+    size_t GetPartitionCount() const { return size_t(1) << radix_bits_; }
+
+private:
+    struct Partition {
+        size_t heads;   // first bucket of the partition in heads_
+        uint64_t mask;  // bucket count minus one
+    };
+
+    int build_column_;
+    int probe_column_;
+    int radix_bits_{0};
+    std::vector<Record> rows_;      // build rows, clustered by partition
+    std::vector<uint64_t> hashes_;  // hash of each row's join value
+    std::vector<uint32_t> heads_;   // first row of each bucket plus one, 0 when empty
+    std::vector<uint32_t> next_;    // next row in the same bucket plus one
+    std::vector<Partition> partitions_;
+
+    static uint64_t HashValue(const Value& value);
+    // Counting sort of hashes by partition; returns the order and fills the
+    // start of each partition in it.
+    std::vector<uint32_t> Cluster(const std::vector<uint64_t>& hashes, std::vector<size_t>& starts) const;
+};
\ No newline at end of file
@@ -0,0 +1,220 @@
+#include "io_uring_async_io.h"
+
+#ifdef SIMPLEDB_HAVE_IO_URING
+
+#include <algorithm>
+#include <cstring>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+static int IoUringSetup(unsigned entries, io_uring_params* params) {
+    return static_cast<int>(::syscall(__NR_io_uring_setup, entries, params));
+}
+
+static int IoUringEnter(int ring_fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+    return static_cast<int>(::syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete, flags, nullptr, 0));
+}
+
+IoUringAsyncIO::IoUringAsyncIO(int file_fd) : file_fd_(file_fd) {
+    if (SetupRing()) {
+        completion_thread_ = std::thread(&IoUringAsyncIO::CompletionLoop, this);
+    }
+}
+
+IoUringAsyncIO::~IoUringAsyncIO() {
+    if (ring_fd_ < 0) {
+        return;
+    }
+
+    Submit();
+    {
+        std::unique_lock<std::mutex> lock(inflight_latch_);
+        inflight_cv_.wait(lock, [this] { return inflight_ == 0; });
+        stop_ = true;
+    }
+
+    // Wake the completion thread out of io_uring_enter with a no-op.
+    {
+        std::lock_guard<std::mutex> guard(submit_latch_);
+        io_uring_sqe* sqe = NextSqe();
+        if (sqe) {
+            sqe->opcode = IORING_OP_NOP;
+            sqe->user_data = 0;
+            SubmitLocked();
+        }
+    }
+    completion_thread_.join();
+    TeardownRing();
+}
+
+void IoUringAsyncIO::ReadPage(page_id_t page_id, char* data, Callback callback) {
+    {
+        std::unique_lock<std::mutex> lock(inflight_latch_);
+        if (inflight_ >= QUEUE_DEPTH) {
+            lock.unlock();
+            Submit();
+            lock.lock();
+            inflight_cv_.wait(lock, [this] { return inflight_ < QUEUE_DEPTH; });
+        }
+        inflight_++;
+    }
+
+    std::lock_guard<std::mutex> guard(submit_latch_);
+    io_uring_sqe* sqe = NextSqe();
+    while (!sqe) {
+        SubmitLocked();
+        sqe = NextSqe();
+    }
+
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = file_fd_;
+    sqe->addr = reinterpret_cast<uint64_t>(data);
+    sqe->len = PAGE_SIZE;
+    sqe->off = static_cast<uint64_t>(page_id) * PAGE_SIZE;
+    sqe->user_data = reinterpret_cast<uint64_t>(new Request{std::move(callback)});
+}
+
+void IoUringAsyncIO::Submit() {
+    std::lock_guard<std::mutex> guard(submit_latch_);
+    SubmitLocked();
+}
+
+bool IoUringAsyncIO::SetupRing() {
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    ring_fd_ = IoUringSetup(QUEUE_DEPTH, &params);
+    if (ring_fd_ < 0) {
+        ring_fd_ = -1;
+        return false;
+    }
+
+    sq_entries_ = params.sq_entries;
+    sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap) {
+        sq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+        cq_ring_size_ = sq_ring_size_;
+    }
+
+    sq_ring_ = ::mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      ring_fd_, IORING_OFF_SQ_RING);
+    if (sq_ring_ == MAP_FAILED) {
+        sq_ring_ = nullptr;
+        TeardownRing();
+        return false;
+    }
+
+    cq_ring_ = single_mmap ? sq_ring_
+                           : ::mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                    ring_fd_, IORING_OFF_CQ_RING);
+    if (cq_ring_ == MAP_FAILED) {
+        cq_ring_ = nullptr;
+        TeardownRing();
+        return false;
+    }
+
+    sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+    void* sqes = ::mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                        ring_fd_, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+        TeardownRing();
+        return false;
+    }
+    sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+    char* sq = static_cast<char*>(sq_ring_);
+    sq_head_ = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+    sq_tail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    sq_mask_ = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    sq_array_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+
+    char* cq = static_cast<char*>(cq_ring_);
+    cq_head_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    cq_tail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    cq_mask_ = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+    return true;
+}
+
+void IoUringAsyncIO::TeardownRing() {
+    if (sqes_) {
+        ::munmap(sqes_, sqes_size_);
+    }
+    if (cq_ring_ && cq_ring_ != sq_ring_) {
+        ::munmap(cq_ring_, cq_ring_size_);
+    }
+    if (sq_ring_) {
+        ::munmap(sq_ring_, sq_ring_size_);
+    }
+    if (ring_fd_ >= 0) {
+        ::close(ring_fd_);
+    }
+    sqes_ = nullptr;
+    cq_ring_ = nullptr;
+    sq_ring_ = nullptr;
+    ring_fd_ = -1;
+}
+
+io_uring_sqe* IoUringAsyncIO::NextSqe() {
+    unsigned head = __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+    unsigned tail = *sq_tail_;
+    if (tail - head >= sq_entries_) {
+        return nullptr;
+    }
+
+    unsigned index = tail & *sq_mask_;
+    io_uring_sqe* sqe = &sqes_[index];
+    std::memset(sqe, 0, sizeof(*sqe));
+    sq_array_[index] = index;
+    __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+    to_submit_++;
+    return sqe;
+}
+
+void IoUringAsyncIO::SubmitLocked() {
+    while (to_submit_ > 0) {
+        int submitted = IoUringEnter(ring_fd_, to_submit_, 0, 0);
+        if (submitted <= 0) {
+            break;
+        }
+        to_submit_ -= static_cast<unsigned>(submitted);
+    }
+}
+
+void IoUringAsyncIO::CompletionLoop() {
+    while (true) {
+        {
+            std::lock_guard<std::mutex> guard(inflight_latch_);
+            if (stop_ && inflight_ == 0) {
+                return;
+            }
+        }
+
+        IoUringEnter(ring_fd_, 0, 1, IORING_ENTER_GETEVENTS);
+
+        unsigned head = *cq_head_;
+        unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+        while (head != tail) {
+            io_uring_cqe* cqe = &cqes_[head & *cq_mask_];
+            auto* request = reinterpret_cast<Request*>(cqe->user_data);
+            int result = cqe->res;
+            head++;
+            __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+
+            if (!request) {
+                continue;
+            }
+            request->callback(result == static_cast<int>(PAGE_SIZE));
+            delete request;
+
+            std::lock_guard<std::mutex> guard(inflight_latch_);
+            inflight_--;
+            inflight_cv_.notify_all();
+        }
+    }
+}
+
+#endif
\ No newline at end of file
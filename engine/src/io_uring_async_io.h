@@ -0,0 +1,70 @@
+#pragma once
+#include "async_io.h"
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define SIMPLEDB_HAVE_IO_URING 1
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+// Minimal io_uring driver on top of the raw syscalls: one submission queue
+// shared by all callers and a completion thread that reaps CQEs and runs the
+// callbacks.
+class IoUringAsyncIO : public AsyncIO {
+public:
+    static constexpr unsigned QUEUE_DEPTH = 64;
+
+    explicit IoUringAsyncIO(int file_fd);
+    ~IoUringAsyncIO() override;
+
+    bool IsInitialized() const { return ring_fd_ >= 0; }
+
+    void ReadPage(page_id_t page_id, char* data, Callback callback) override;
+    void Submit() override;
+
+private:
+    struct Request {
+        Callback callback;
+    };
+
+    int file_fd_;
+    int ring_fd_{-1};
+
+    void* sq_ring_{nullptr};
+    size_t sq_ring_size_{0};
+    unsigned* sq_head_{nullptr};
+    unsigned* sq_tail_{nullptr};
+    unsigned* sq_mask_{nullptr};
+    unsigned* sq_array_{nullptr};
+    unsigned sq_entries_{0};
+    io_uring_sqe* sqes_{nullptr};
+    size_t sqes_size_{0};
+
+    void* cq_ring_{nullptr};
+    size_t cq_ring_size_{0};
+    unsigned* cq_head_{nullptr};
+    unsigned* cq_tail_{nullptr};
+    unsigned* cq_mask_{nullptr};
+    io_uring_cqe* cqes_{nullptr};
+
+    std::mutex submit_latch_;
+    unsigned to_submit_{0};
+
+    std::mutex inflight_latch_;
+    std::condition_variable inflight_cv_;
+    size_t inflight_{0};
+    bool stop_{false};
+    std::thread completion_thread_;
+
+    bool SetupRing();
+    void TeardownRing();
+    io_uring_sqe* NextSqe();
+    void SubmitLocked();
+    void CompletionLoop();
+};
+
+#endif
\ No newline at end of file
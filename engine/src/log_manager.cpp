@@ -0,0 +1,301 @@
+#include "log_manager.h"
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+#include <iostream>
+#include <fcntl.h>
+#include <unistd.h>
+
+// [size][checksum][lsn][type][key][name length][name][payload length][payload]
+static constexpr size_t LOG_RECORD_HEADER_SIZE =
+    sizeof(uint32_t) + sizeof(uint32_t) + sizeof(lsn_t) + sizeof(uint8_t) + sizeof(int32_t) + sizeof(uint16_t);
+
+static uint32_t Checksum(const char* data, size_t size) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<uint8_t>(data[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static bool WriteFully(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t written = ::write(fd, data, size);
+        if (written < 0) {
+            return false;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+size_t LogRecord::GetSize() const {
+    return LOG_RECORD_HEADER_SIZE + table_name.size() + sizeof(uint32_t) + payload.size();
+}
+
+void LogRecord::Serialize(char* data) const {
+    uint32_t size = static_cast<uint32_t>(GetSize());
+    uint8_t type_byte = static_cast<uint8_t>(type);
+    int32_t key_value = key;
+    uint16_t name_length = static_cast<uint16_t>(table_name.size());
+    uint32_t payload_length = static_cast<uint32_t>(payload.size());
+
+    size_t offset = 2 * sizeof(uint32_t);
+    std::memcpy(data + offset, &lsn, sizeof(lsn));
+    offset += sizeof(lsn);
+    std::memcpy(data + offset, &type_byte, sizeof(type_byte));
+    offset += sizeof(type_byte);
+    std::memcpy(data + offset, &key_value, sizeof(key_value));
+    offset += sizeof(key_value);
+    std::memcpy(data + offset, &name_length, sizeof(name_length));
+    offset += sizeof(name_length);
+    std::memcpy(data + offset, table_name.data(), name_length);
+    offset += name_length;
+    std::memcpy(data + offset, &payload_length, sizeof(payload_length));
+    offset += sizeof(payload_length);
+    std::memcpy(data + offset, payload.data(), payload_length);
+
+    uint32_t checksum = Checksum(data + 2 * sizeof(uint32_t), size - 2 * sizeof(uint32_t));
+    std::memcpy(data, &size, sizeof(size));
+    std::memcpy(data + sizeof(size), &checksum, sizeof(checksum));
+}
+
+bool LogRecord::Deserialize(const char* data, size_t available, LogRecord& record, size_t& size) {
+    if (available < LOG_RECORD_HEADER_SIZE + sizeof(uint32_t)) {
+        return false;
+    }
+
+    uint32_t record_size;
+    uint32_t checksum;
+    std::memcpy(&record_size, data, sizeof(record_size));
+    std::memcpy(&checksum, data + sizeof(record_size), sizeof(checksum));
+    if (record_size < LOG_RECORD_HEADER_SIZE + sizeof(uint32_t) || record_size > available) {
+        return false;
+    }
+    if (Checksum(data + 2 * sizeof(uint32_t), record_size - 2 * sizeof(uint32_t)) != checksum) {
+        return false;
+    }
+
+    size_t offset = 2 * sizeof(uint32_t);
+    uint8_t type_byte;
+    int32_t key_value;
+    uint16_t name_length;
+    uint32_t payload_length;
+
+    std::memcpy(&record.lsn, data + offset, sizeof(record.lsn));
+    offset += sizeof(record.lsn);
+    std::memcpy(&type_byte, data + offset, sizeof(type_byte));
+    offset += sizeof(type_byte);
+    std::memcpy(&key_value, data + offset, sizeof(key_value));
+    offset += sizeof(key_value);
+    std::memcpy(&name_length, data + offset, sizeof(name_length));
+    offset += sizeof(name_length);
+    record.table_name.assign(data + offset, name_length);
+    offset += name_length;
+    std::memcpy(&payload_length, data + offset, sizeof(payload_length));
+    offset += sizeof(payload_length);
+    record.payload.assign(data + offset, payload_length);
+
+    record.type = static_cast<LogRecordType>(type_byte);
+    record.key = key_value;
+    size = record_size;
+    return true;
+}
+
+LogManager::LogManager(const std::string& log_file) : log_file_(log_file) {
+    fd_ = ::open(log_file_.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+    if (fd_ < 0) {
+        std::cerr << "Failed to open log file: " << log_file_ << std::endl;
+        io_error_ = true;
+    }
+    flush_thread_ = std::thread(&LogManager::FlushLoop, this);
+}
+
+LogManager::~LogManager() {
+    {
+        std::lock_guard<std::mutex> guard(latch_);
+        stop_ = true;
+    }
+    flush_cv_.notify_one();
+    flush_thread_.join();
+
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+}
+
+std::vector<LogRecord> LogManager::ReadLogRecords() {
+    std::lock_guard<std::mutex> guard(latch_);
+    std::vector<LogRecord> records;
+    if (fd_ < 0) {
+        return records;
+    }
+
+    off_t file_size = ::lseek(fd_, 0, SEEK_END);
+    std::vector<char> data(file_size > 0 ? static_cast<size_t>(file_size) : 0);
+    size_t read_bytes = 0;
+    while (read_bytes < data.size()) {
+        ssize_t n = ::pread(fd_, data.data() + read_bytes, data.size() - read_bytes, read_bytes);
+        if (n <= 0) {
+            break;
+        }
+        read_bytes += static_cast<size_t>(n);
+    }
+
+    size_t offset = 0;
+    while (offset < read_bytes) {
+        LogRecord record;
+        size_t size;
+        if (!LogRecord::Deserialize(data.data() + offset, read_bytes - offset, record, size)) {
+            break;
+        }
+        offset += size;
+        next_lsn_ = record.lsn + 1;
+        appended_lsn_ = record.lsn;
+        persistent_lsn_ = record.lsn;
+        records.push_back(std::move(record));
+    }
+
+    // Drop a torn tail left behind by a crash in the middle of a write.
+    if (offset < data.size() && ::ftruncate(fd_, offset) != 0) {
+        std::cerr << "Failed to truncate torn log tail" << std::endl;
+    }
+    log_size_ = offset;
+    return records;
+}
+
+lsn_t LogManager::AppendLogRecord(LogRecord& record, size_t lsn_count) {
+    std::lock_guard<std::mutex> guard(latch_);
+    next_lsn_ += lsn_count;
+    record.lsn = next_lsn_ - 1;
+
+    size_t offset = log_buffer_.size();
+    log_buffer_.resize(offset + record.GetSize());
+    record.Serialize(log_buffer_.data() + offset);
+
+    appended_lsn_ = record.lsn;
+    log_size_ += record.GetSize();
+    return record.lsn;
+}
+
+bool LogManager::Flush(lsn_t lsn) {
+    std::unique_lock<std::mutex> lock(latch_);
+    if (lsn > appended_lsn_) {
+        lsn = appended_lsn_;
+    }
+    if (lsn <= persistent_lsn_) {
+        return !io_error_;
+    }
+
+    flush_waiters_++;
+    flush_cv_.notify_one();
+    persist_cv_.wait(lock, [this, lsn] { return persistent_lsn_ >= lsn || io_error_; });
+    flush_waiters_--;
+    return persistent_lsn_ >= lsn;
+}
+
+bool LogManager::Checkpoint() {
+    std::unique_lock<std::mutex> lock(latch_);
+    persist_cv_.wait(lock, [this] { return !flushing_; });
+
+    // The caller has already written every dirty page and the catalog back,
+    // so the new log carries over only records not yet flushed.
+    LogRecord record;
+    record.type = LogRecordType::CHECKPOINT;
+    record.lsn = next_lsn_++;
+
+    std::vector<char> data(record.GetSize());
+    record.Serialize(data.data());
+    data.insert(data.end(), log_buffer_.begin(), log_buffer_.end());
+
+    std::string temp_file = log_file_ + ".tmp";
+    int temp_fd = ::open(temp_file.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (temp_fd < 0) {
+        return false;
+    }
+    bool written = WriteFully(temp_fd, data.data(), data.size()) && ::fdatasync(temp_fd) == 0;
+    ::close(temp_fd);
+    if (!written || std::rename(temp_file.c_str(), log_file_.c_str()) != 0) {
+        std::remove(temp_file.c_str());
+        return false;
+    }
+
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+    fd_ = ::open(log_file_.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+    io_error_ = fd_ < 0;
+
+    log_buffer_.clear();
+    appended_lsn_ = std::max(appended_lsn_, record.lsn);
+    persistent_lsn_ = appended_lsn_;
+    log_size_ = data.size();
+    sync_count_++;
+    persist_cv_.notify_all();
+    return !io_error_;
+}
+
+void LogManager::AdvanceLSN(lsn_t lsn) {
+    std::lock_guard<std::mutex> guard(latch_);
+    next_lsn_ = std::max(next_lsn_, lsn + 1);
+}
+
+lsn_t LogManager::GetAppendedLSN() {
+    std::lock_guard<std::mutex> guard(latch_);
+    return appended_lsn_;
+}
+
+lsn_t LogManager::GetPersistentLSN() {
+    std::lock_guard<std::mutex> guard(latch_);
+    return persistent_lsn_;
+}
+
+size_t LogManager::GetLogSize() {
+    std::lock_guard<std::mutex> guard(latch_);
+    return log_size_;
+}
+
+uint64_t LogManager::GetSyncCount() {
+    std::lock_guard<std::mutex> guard(latch_);
+    return sync_count_;
+}
+
+// Group commit: every committer that arrives while a sync is in flight is
+// appended to the next batch and made durable by a single fdatasync.
+void LogManager::FlushLoop() {
+    std::unique_lock<std::mutex> lock(latch_);
+    while (true) {
+        flush_cv_.wait(lock, [this] {
+            return stop_ || (flush_waiters_ > 0 && !log_buffer_.empty());
+        });
+        if (log_buffer_.empty()) {
+            if (stop_) {
+                break;
+            }
+            continue;
+        }
+
+        flush_buffer_.swap(log_buffer_);
+        lsn_t flush_lsn = appended_lsn_;
+        int fd = fd_;
+        flushing_ = true;
+        lock.unlock();
+
+        bool synced = fd >= 0 && WriteFully(fd, flush_buffer_.data(), flush_buffer_.size()) &&
+                      ::fdatasync(fd) == 0;
+
+        lock.lock();
+        flush_buffer_.clear();
+        flushing_ = false;
+        sync_count_++;
+        if (synced) {
+            persistent_lsn_ = flush_lsn;
+        } else {
+            std::cerr << "Failed to write log file: " << log_file_ << std::endl;
+            io_error_ = true;
+        }
+        persist_cv_.notify_all();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,81 @@
+#pragma once
+#include "page.h"
+#include <string>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+enum class LogRecordType : uint8_t {
+    INVALID = 0,
+    CREATE_TABLE,
+    INSERT,
+    DELETE,
+    CHECKPOINT,
+    ALLOCATE_PAGE,
+    FREE_PAGE,
+    PAGE_IMAGES
+};
+
+// Logical log record. INSERT carries the serialized rows of a statement in
+// key order, with their count in key, and CREATE_TABLE the table definition.
+// CHECKPOINT starts the log after a checkpoint; the catalog itself is in the
+// database file. ALLOCATE_PAGE and FREE_PAGE take the page in key off the
+// free list and put it back. PAGE_IMAGES carries key whole pages, each as its
+// page id followed by its data, for changes to several pages that must not
+// be redone from whichever of them happened to reach the disk.
+struct LogRecord {
+    lsn_t lsn{INVALID_LSN};
+    LogRecordType type{LogRecordType::INVALID};
+    std::string table_name;
+    int key{0};
+    std::string payload;
+
+    size_t GetSize() const;
+    void Serialize(char* data) const;
+    static bool Deserialize(const char* data, size_t available, LogRecord& record, size_t& size);
+};
+
+class LogManager {
+public:
+    explicit LogManager(const std::string& log_file);
+    ~LogManager();
+
+    std::vector<LogRecord> ReadLogRecords();
+    // A record takes lsn_count LSNs, one for each change it carries, and is
+    // numbered with the last of them.
+    lsn_t AppendLogRecord(LogRecord& record, size_t lsn_count = 1);
+    bool Flush(lsn_t lsn);
+    bool Checkpoint();
+
+    // Makes every record appended from now on take an LSN above lsn.
+    void AdvanceLSN(lsn_t lsn);
+
+    lsn_t GetAppendedLSN();
+    lsn_t GetPersistentLSN();
+    size_t GetLogSize();
+    uint64_t GetSyncCount();
+
+private:
+    std::string log_file_;
+    int fd_{-1};
+
+    std::mutex latch_;
+    std::condition_variable flush_cv_;
+    std::condition_variable persist_cv_;
+    std::vector<char> log_buffer_;
+    std::vector<char> flush_buffer_;
+
+    lsn_t next_lsn_{1};
+    lsn_t appended_lsn_{INVALID_LSN};
+    lsn_t persistent_lsn_{INVALID_LSN};
+    size_t log_size_{0};
+    size_t flush_waiters_{0};
+    uint64_t sync_count_{0};
+    bool flushing_{false};
+    bool io_error_{false};
+    bool stop_{false};
+    std::thread flush_thread_;
+
+    void FlushLoop();
+};
\ No newline at end of file
@@ -0,0 +1,75 @@
+#include "lru_k_replacer.h"
+
+LRUKReplacer::LRUKReplacer(size_t num_frames, size_t k)
+    : k_(k), nodes_(num_frames) {}
+
+void LRUKReplacer::Pin(frame_id_t frame_id) {
+    Unlink(frame_id);
+    nodes_[frame_id].access_count++;
+}
+
+void LRUKReplacer::Unpin(frame_id_t frame_id) {
+    if (nodes_[frame_id].linked) {
+        return;
+    }
+    PushBack(ListFor(nodes_[frame_id]), frame_id);
+}
+
+bool LRUKReplacer::Victim(frame_id_t* frame_id) {
+    List& list = history_.head != NIL ? history_ : cache_;
+    if (list.head == NIL) {
+        return false;
+    }
+
+    *frame_id = list.head;
+    Remove(list.head);
+    return true;
+}
+
+void LRUKReplacer::Remove(frame_id_t frame_id) {
+    Unlink(frame_id);
+    nodes_[frame_id].access_count = 0;
+}
+
+void LRUKReplacer::Resize(size_t num_frames) {
+    nodes_.resize(num_frames);
+}
+
+void LRUKReplacer::PushBack(List& list, frame_id_t frame_id) {
+    Node& node = nodes_[frame_id];
+    node.prev = list.tail;
+    node.next = NIL;
+    node.linked = true;
+
+    if (list.tail != NIL) {
+        nodes_[list.tail].next = frame_id;
+    } else {
+        list.head = frame_id;
+    }
+    list.tail = frame_id;
+    size_++;
+}
+
+void LRUKReplacer::Unlink(frame_id_t frame_id) {
+    Node& node = nodes_[frame_id];
+    if (!node.linked) {
+        return;
+    }
+
+    List& list = ListFor(node);
+    if (node.prev != NIL) {
+        nodes_[node.prev].next = node.next;
+    } else {
+        list.head = node.next;
+    }
+    if (node.next != NIL) {
+        nodes_[node.next].prev = node.prev;
+    } else {
+        list.tail = node.prev;
+    }
+
+    node.prev = NIL;
+    node.next = NIL;
+    node.linked = false;
+    size_--;
+}
\ No newline at end of file
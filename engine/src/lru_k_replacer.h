@@ -0,0 +1,47 @@
+#pragma once
+#include "replacer.h"
+#include <vector>
+
+// LRU-K approximation with O(1) operations. Frames referenced fewer than K
+// times have an infinite backward K-distance and sit on the history list;
+// they are evicted before any frame on the cache list. Within each list
+// frames are ordered by the time they last became evictable.
+class LRUKReplacer : public Replacer {
+public:
+    static constexpr size_t DEFAULT_K = 2;
+
+    explicit LRUKReplacer(size_t num_frames, size_t k = DEFAULT_K);
+    ~LRUKReplacer() override = default;
+
+    void Pin(frame_id_t frame_id) override;
+    void Unpin(frame_id_t frame_id) override;
+    bool Victim(frame_id_t* frame_id) override;
+    void Remove(frame_id_t frame_id) override;
+    size_t Size() const override { return size_; }
+    void Resize(size_t num_frames) override;
+
+private:
+    static constexpr frame_id_t NIL = static_cast<frame_id_t>(-1);
+
+    struct Node {
+        frame_id_t prev{NIL};
+        frame_id_t next{NIL};
+        size_t access_count{0};
+        bool linked{false};
+    };
+
+    struct List {
+        frame_id_t head{NIL};
+        frame_id_t tail{NIL};
+    };
+
+    size_t k_;
+    std::vector<Node> nodes_;
+    List history_;
+    List cache_;
+    size_t size_{0};
+
+    List& ListFor(const Node& node) { return node.access_count < k_ ? history_ : cache_; }
+    void PushBack(List& list, frame_id_t frame_id);
+    void Unlink(frame_id_t frame_id);
+};
\ No newline at end of file
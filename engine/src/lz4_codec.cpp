@@ -0,0 +1,163 @@
+#include "lz4_codec.h"
+#include <cstdint>
+#include <cstring>
+
+namespace {
+
+constexpr size_t MIN_MATCH = 4;
+constexpr size_t LAST_LITERALS = 5;   // a block ends in at least this many literals
+constexpr size_t MATCH_FIND_LIMIT = 12;  // no match starts this close to the end
+constexpr size_t MAX_OFFSET = 65535;
+constexpr int HASH_BITS = 12;
+constexpr int SKIP_TRIGGER = 6;  // misses before the search starts skipping ahead
+
+uint32_t Read32(const char* p) {
+    uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+uint32_t Hash(uint32_t sequence) {
+    return (sequence * 2654435761u) >> (32 - HASH_BITS);
+}
+
+// Writes the 255-byte continuation of a length whose token nibble is 15.
+size_t WriteLength(size_t length, char* dst) {
+    size_t n = 0;
+    for (; length >= 255; length -= 255) {
+        dst[n++] = static_cast<char>(255);
+    }
+    dst[n++] = static_cast<char>(length);
+    return n;
+}
+
+bool ReadLength(const unsigned char* src, size_t size, size_t& ip, size_t& length) {
+    unsigned char byte;
+    do {
+        if (ip >= size) {
+            return false;
+        }
+        byte = src[ip++];
+        length += byte;
+    } while (byte == 255);
+    return true;
+}
+
+}  // namespace
+
+size_t Lz4Codec::Compress(const char* src, size_t size, char* dst, size_t capacity) {
+    int32_t table[1 << HASH_BITS];
+    std::memset(table, -1, sizeof(table));
+
+    size_t ip = 0;
+    size_t anchor = 0;
+    size_t op = 0;
+
+    auto emit = [&](size_t literals, size_t offset, size_t match) {
+        // Worst case for the token, both length continuations and the offset.
+        size_t needed = 1 + literals / 255 + 1 + literals + 2 + (match > 0 ? match / 255 + 1 : 0);
+        if (op + needed > capacity) {
+            return false;
+        }
+        char* token = dst + op++;
+        *token = static_cast<char>((literals >= 15 ? 15 : literals) << 4);
+        if (literals >= 15) {
+            op += WriteLength(literals - 15, dst + op);
+        }
+        std::memcpy(dst + op, src + anchor, literals);
+        op += literals;
+        if (match == 0) {
+            return true;
+        }
+
+        dst[op++] = static_cast<char>(offset & 0xFF);
+        dst[op++] = static_cast<char>(offset >> 8);
+        size_t length = match - MIN_MATCH;
+        *token = static_cast<char>(*token | (length >= 15 ? 15 : length));
+        if (length >= 15) {
+            op += WriteLength(length - 15, dst + op);
+        }
+        return true;
+    };
+
+    if (size > MATCH_FIND_LIMIT) {
+        size_t match_limit = size - LAST_LITERALS;
+        size_t search_limit = size - MATCH_FIND_LIMIT;
+        size_t misses = 0;
+        while (ip < search_limit) {
+            uint32_t sequence = Read32(src + ip);
+            uint32_t hash = Hash(sequence);
+            size_t candidate = static_cast<size_t>(table[hash]);  // wraps around when the slot is empty
+            table[hash] = static_cast<int32_t>(ip);
+            if (candidate >= ip || ip - candidate > MAX_OFFSET || Read32(src + candidate) != sequence) {
+                ip += 1 + (misses++ >> SKIP_TRIGGER);
+                continue;
+            }
+            misses = 0;
+
+            size_t match = MIN_MATCH;
+            while (ip + match < match_limit && src[candidate + match] == src[ip + match]) {
+                match++;
+            }
+            if (!emit(ip - anchor, ip - candidate, match)) {
+                return 0;
+            }
+            ip += match;
+            anchor = ip;
+        }
+    }
+
+    if (!emit(size - anchor, 0, 0)) {
+        return 0;
+    }
+    return op;
+}
+
+bool Lz4Codec::Decompress(const char* src, size_t size, char* dst, size_t dst_size) {
+    const auto* in = reinterpret_cast<const unsigned char*>(src);
+    size_t ip = 0;
+    size_t op = 0;
+
+    while (ip < size) {
+        unsigned char token = in[ip++];
+        size_t literals = token >> 4;
+        if (literals == 15 && !ReadLength(in, size, ip, literals)) {
+            return false;
+        }
+        if (literals > size - ip || literals > dst_size - op) {
+            return false;
+        }
+        std::memcpy(dst + op, src + ip, literals);
+        ip += literals;
+        op += literals;
+        if (ip == size) {
+            break;
+        }
+
+        if (size - ip < 2) {
+            return false;
+        }
+        size_t offset = in[ip] | (static_cast<size_t>(in[ip + 1]) << 8);
+        ip += 2;
+        size_t match = token & 15;
+        if (match == 15 && !ReadLength(in, size, ip, match)) {
+            return false;
+        }
+        match += MIN_MATCH;
+        if (offset == 0 || offset > op || match > dst_size - op) {
+            return false;
+        }
+
+        // Matches may overlap the bytes they produce, as in a run of one byte.
+        const char* from = dst + op - offset;
+        if (offset >= match) {
+            std::memcpy(dst + op, from, match);
+        } else {
+            for (size_t i = 0; i < match; ++i) {
+                dst[op + i] = from[i];
+            }
+        }
+        op += match;
+    }
+    return op == dst_size;
+}
\ No newline at end of file
@@ -0,0 +1,16 @@
+#pragma once
+#include <cstddef>
+
+// Compressor for the LZ4 block format: sequences of a token, literals, a
+// two-byte match offset and a match length, with no frame around them. Fast
+// rather than tight, like LZ4 itself, and meant for page-sized blocks.
+class Lz4Codec {
+public:
+    // Compresses size bytes of src into dst. Returns the compressed size, or 0
+    // if it does not fit in capacity.
+    static size_t Compress(const char* src, size_t size, char* dst, size_t capacity);
+
+    // Decompresses a block into exactly dst_size bytes. Returns false if the
+    // block is malformed or does not decode to dst_size bytes.
+    static bool Decompress(const char* src, size_t size, char* dst, size_t dst_size);
+};
\ No newline at end of file
@@ -5,6 +5,9 @@ int main() {
     std::cout << "Simple Database Engine - Full Demo" << std::endl;
     
     Database db("demo.db");
+    if (!db.IsOpen()) {
+        return 1;
+    }
     
     std::cout << "\n=== Creating Table ===" << std::endl;
     db.ExecuteQuery("CREATE TABLE users (id INT, name VARCHAR, age INT)");
@@ -15,17 +18,29 @@ int main() {
     db.ExecuteQuery("INSERT INTO users VALUES (3, 'Charlie', 35)");
     
     std::cout << "\n=== Selecting All Records ===" << std::endl;
-    if (db.ExecuteQuery("SELECT * FROM users")) {
-        auto results = db.GetLastResults();
-        std::cout << "Found " << results.size() << " records:" << std::endl;
-        for (const auto& record : results) {
+    if (auto cursor = db.Query("SELECT * FROM users")) {
+        Record record;
+        size_t count = 0;
+        while (cursor->Next(record)) {
             std::cout << "  " << record.ToString() << std::endl;
+            count++;
         }
+        std::cout << "Found " << count << " records" << std::endl;
     }
     
     std::cout << "\n=== Selecting with WHERE Clause ===" << std::endl;
     if (db.ExecuteQuery("SELECT * FROM users WHERE id = 2")) {
-        auto results = db.GetLastResults();
+        const auto& results = db.GetLastResults();
+        std::cout << "Found " << results.size() << " records:" << std::endl;
+        for (const auto& record : results) {
+            std::cout << "  " << record.ToString() << std::endl;
+        }
+    }
+    
+    std::cout << "\n=== Selecting through a Secondary Index ===" << std::endl;
+    db.ExecuteQuery("CREATE INDEX users_age ON users(age)");
+    if (db.ExecuteQuery("SELECT * FROM users WHERE age > 28")) {
+        const auto& results = db.GetLastResults();
         std::cout << "Found " << results.size() << " records:" << std::endl;
         for (const auto& record : results) {
             std::cout << "  " << record.ToString() << std::endl;
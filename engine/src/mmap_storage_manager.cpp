@@ -0,0 +1,76 @@
+#include "mmap_storage_manager.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <sys/mman.h>
+#include <unistd.h>
+
+MmapStorageManager::MmapStorageManager(const std::string& db_file) : StorageManager(db_file) {
+    if (OpenFile(0) && next_page_id_ > 0) {
+        Remap(next_page_id_);
+    }
+}
+
+MmapStorageManager::~MmapStorageManager() {
+    if (map_) {
+        ::munmap(map_, map_pages_ * PAGE_SIZE);
+    }
+    TrimFile();
+}
+
+bool MmapStorageManager::ReadPage(page_id_t page_id, char* data) {
+    std::shared_lock<std::shared_mutex> guard(map_latch_);
+    if (page_id >= map_pages_ || page_id >= GetPageCount()) {
+        std::memset(data, 0, PAGE_SIZE);
+        return false;
+    }
+    std::memcpy(data, map_ + static_cast<size_t>(page_id) * PAGE_SIZE, PAGE_SIZE);
+    return true;
+}
+
+bool MmapStorageManager::WritePage(page_id_t page_id, const char* data) {
+    std::shared_lock<std::shared_mutex> guard(map_latch_);
+    if (page_id >= map_pages_ || page_id >= GetPageCount()) {
+        return false;
+    }
+    std::memcpy(map_ + static_cast<size_t>(page_id) * PAGE_SIZE, data, PAGE_SIZE);
+    return true;
+}
+
+page_id_t MmapStorageManager::AllocatePage() {
+    page_id_t page_id = StorageManager::AllocatePage();
+
+    std::unique_lock<std::shared_mutex> guard(map_latch_);
+    if (page_id >= map_pages_ && !Remap(page_id + 1)) {
+        std::cerr << "Failed to grow mapping of " << db_file_ << std::endl;
+    }
+    return page_id;
+}
+
+bool MmapStorageManager::Sync() {
+    std::shared_lock<std::shared_mutex> guard(map_latch_);
+    size_t mapped_bytes = std::min<size_t>(map_pages_, GetPageCount()) * PAGE_SIZE;
+    if (map_ && mapped_bytes > 0 && ::msync(map_, mapped_bytes, MS_SYNC) != 0) {
+        return false;
+    }
+    return StorageManager::Sync();
+}
+
+bool MmapStorageManager::Remap(size_t min_pages) {
+    // The mapping may run past the end of the file; only pages below
+    // next_page_id_ (which AllocatePage has already backed) are ever touched.
+    size_t new_pages = ((min_pages + MAP_GROWTH_PAGES - 1) / MAP_GROWTH_PAGES) * MAP_GROWTH_PAGES;
+
+    void* new_map = ::mmap(nullptr, new_pages * PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (new_map == MAP_FAILED) {
+        return false;
+    }
+
+    if (map_) {
+        ::munmap(map_, map_pages_ * PAGE_SIZE);
+    }
+    map_ = static_cast<char*>(new_map);
+    map_pages_ = new_pages;
+    return true;
+}
\ No newline at end of file
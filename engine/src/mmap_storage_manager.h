@@ -0,0 +1,26 @@
+#pragma once
+#include "storage_manager.h"
+#include <shared_mutex>
+
+// Serves reads straight out of a shared mapping of the database file. The
+// mapping is reserved in MAP_GROWTH_PAGES steps; writes go through the
+// mapping and reach the file on Sync().
+class MmapStorageManager : public StorageManager {
+public:
+    static constexpr size_t MAP_GROWTH_PAGES = 1024;
+
+    explicit MmapStorageManager(const std::string& db_file);
+    ~MmapStorageManager() override;
+
+    bool ReadPage(page_id_t page_id, char* data) override;
+    bool WritePage(page_id_t page_id, const char* data) override;
+    page_id_t AllocatePage() override;
+    bool Sync() override;
+
+private:
+    std::shared_mutex map_latch_;
+    char* map_{nullptr};
+    size_t map_pages_{0};
+
+    bool Remap(size_t min_pages);
+};
\ No newline at end of file
@@ -0,0 +1,173 @@
+#include "overflow_chain.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+static constexpr size_t NEXT_OFFSET = sizeof(lsn_t);
+static constexpr size_t COUNT_OFFSET = NEXT_OFFSET + sizeof(page_id_t);
+
+// Pages are filled front to back, so at most two are pinned at a time: the
+// previous page stays pinned until the next page id is linked into it.
+bool OverflowChain::Write(BufferPoolManager* buffer_pool_manager, std::string_view data, page_id_t& first_page,
+                          lsn_t lsn) {
+    first_page = INVALID_PAGE_ID;
+    page_id_t previous_page_id = INVALID_PAGE_ID;
+    Page* previous_page = nullptr;
+    size_t position = 0;
+
+    do {
+        page_id_t page_id;
+        Page* page = buffer_pool_manager->NewPage(&page_id);
+        if (!page) {
+            if (previous_page) {
+                buffer_pool_manager->UnpinPage(previous_page_id, true);
+            }
+            Free(buffer_pool_manager, first_page);
+            first_page = INVALID_PAGE_ID;
+            return false;
+        }
+
+        uint32_t count = static_cast<uint32_t>(std::min(CAPACITY, data.size() - position));
+        page_id_t next = INVALID_PAGE_ID;
+        page->SetLSN(lsn);
+        std::memcpy(page->GetData() + NEXT_OFFSET, &next, sizeof(next));
+        std::memcpy(page->GetData() + COUNT_OFFSET, &count, sizeof(count));
+        std::memcpy(page->GetData() + HEADER_SIZE, data.data() + position, count);
+        position += count;
+
+        if (previous_page) {
+            std::memcpy(previous_page->GetData() + NEXT_OFFSET, &page_id, sizeof(page_id));
+            buffer_pool_manager->UnpinPage(previous_page_id, true);
+        } else {
+            first_page = page_id;
+        }
+        previous_page_id = page_id;
+        previous_page = page;
+    } while (position < data.size());
+
+    buffer_pool_manager->UnpinPage(previous_page_id, true);
+    return true;
+}
+
+bool OverflowChain::Read(BufferPoolManager* buffer_pool_manager, page_id_t first_page, size_t length,
+                         std::string& data) {
+    data.reserve(data.size() + length);
+    page_id_t page_id = first_page;
+    while (length > 0 && page_id != INVALID_PAGE_ID) {
+        Page* page = buffer_pool_manager->FetchPage(page_id);
+        if (!page) {
+            break;
+        }
+        uint32_t count;
+        std::memcpy(&count, page->GetData() + COUNT_OFFSET, sizeof(count));
+        count = static_cast<uint32_t>(std::min<size_t>(count, length));
+        data.append(page->GetData() + HEADER_SIZE, count);
+        length -= count;
+
+        page_id_t next;
+        std::memcpy(&next, page->GetData() + NEXT_OFFSET, sizeof(next));
+        buffer_pool_manager->UnpinPage(page_id, false);
+        page_id = next;
+    }
+
+    if (length > 0) {
+        std::cerr << "Overflow chain at page " << first_page << " is " << length << " bytes short" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void OverflowChain::Free(BufferPoolManager* buffer_pool_manager, page_id_t first_page) {
+    page_id_t page_id = first_page;
+    while (page_id != INVALID_PAGE_ID) {
+        Page* page = buffer_pool_manager->FetchPage(page_id);
+        if (!page) {
+            return;
+        }
+        page_id_t next;
+        std::memcpy(&next, page->GetData() + NEXT_OFFSET, sizeof(next));
+        buffer_pool_manager->UnpinPage(page_id, false);
+        buffer_pool_manager->DeletePage(page_id);
+        page_id = next;
+    }
+}
+
+bool OverflowChain::Repair(BufferPoolManager* buffer_pool_manager, std::string_view data, page_id_t first_page,
+                           lsn_t lsn) {
+    page_id_t page_id = first_page;
+    size_t position = 0;
+    while (position < data.size() && page_id != INVALID_PAGE_ID) {
+        Page* page = buffer_pool_manager->FetchPage(page_id);
+        if (!page) {
+            std::cerr << "Overflow chain at page " << first_page << " cannot be repaired" << std::endl;
+            return false;
+        }
+        uint32_t count = static_cast<uint32_t>(std::min(CAPACITY, data.size() - position));
+        if (page->GetLSN() < lsn) {
+            page_id_t next = INVALID_PAGE_ID;
+            std::string_view rest = data.substr(position + count);
+            if (!rest.empty() && !Write(buffer_pool_manager, rest, next, lsn)) {
+                buffer_pool_manager->UnpinPage(page_id, false);
+                return false;
+            }
+            page->SetLSN(lsn);
+            std::memcpy(page->GetData() + NEXT_OFFSET, &next, sizeof(next));
+            std::memcpy(page->GetData() + COUNT_OFFSET, &count, sizeof(count));
+            std::memcpy(page->GetData() + HEADER_SIZE, data.data() + position, count);
+            buffer_pool_manager->UnpinPage(page_id, true);
+            return true;
+        }
+
+        position += count;
+        page_id_t next;
+        std::memcpy(&next, page->GetData() + NEXT_OFFSET, sizeof(next));
+        buffer_pool_manager->UnpinPage(page_id, false);
+        page_id = next;
+    }
+    return true;
+}
+
+bool OverflowChain::Rewrite(BufferPoolManager* buffer_pool_manager, std::string_view data, page_id_t& first_page,
+                            uint32_t& page_count) {
+    page_id_t previous_page_id = INVALID_PAGE_ID;
+    Page* previous_page = nullptr;
+    page_id_t page_id = first_page;
+    size_t position = 0;
+
+    for (uint32_t i = 0; i == 0 || position < data.size(); ++i) {
+        Page* page;
+        if (i < page_count) {
+            page = buffer_pool_manager->FetchPage(page_id);
+        } else {
+            page = buffer_pool_manager->NewPage(&page_id, true);
+            if (page) {
+                page_id_t next = INVALID_PAGE_ID;
+                std::memcpy(page->GetData() + NEXT_OFFSET, &next, sizeof(next));
+                if (previous_page) {
+                    std::memcpy(previous_page->GetData() + NEXT_OFFSET, &page_id, sizeof(page_id));
+                } else {
+                    first_page = page_id;
+                }
+                page_count++;
+            }
+        }
+        if (previous_page) {
+            buffer_pool_manager->UnpinPage(previous_page_id, true);
+        }
+        if (!page) {
+            return false;
+        }
+
+        uint32_t count = static_cast<uint32_t>(std::min(CAPACITY, data.size() - position));
+        std::memcpy(page->GetData() + COUNT_OFFSET, &count, sizeof(count));
+        std::memcpy(page->GetData() + HEADER_SIZE, data.data() + position, count);
+        position += count;
+
+        previous_page_id = page_id;
+        previous_page = page;
+        std::memcpy(&page_id, page->GetData() + NEXT_OFFSET, sizeof(page_id));
+    }
+
+    buffer_pool_manager->UnpinPage(previous_page_id, true);
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,35 @@
+#pragma once
+#include "buffer_pool_manager.h"
+#include "page.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Chains of overflow pages holding the rest of strings too long to keep in a
+// B+tree leaf. Each page holds the next page of the chain and a run of bytes:
+//   [lsn][next page][byte count][bytes]
+// Pages carry the LSN of the logged row they belong to, so the write-ahead
+// rule covers them and redo can tell whether they reached the disk.
+class OverflowChain {
+public:
+    static constexpr size_t HEADER_SIZE = sizeof(lsn_t) + sizeof(page_id_t) + sizeof(uint32_t);
+    static constexpr size_t CAPACITY = PAGE_SIZE - HEADER_SIZE;
+
+    // Writes data to a new chain and returns its first page in first_page.
+    static bool Write(BufferPoolManager* buffer_pool_manager, std::string_view data, page_id_t& first_page,
+                      lsn_t lsn = INVALID_LSN);
+    // Appends the length bytes of the chain starting at first_page to data.
+    static bool Read(BufferPoolManager* buffer_pool_manager, page_id_t first_page, size_t length, std::string& data);
+    static void Free(BufferPoolManager* buffer_pool_manager, page_id_t first_page);
+    // Redo of the chain at first_page that the record at lsn wrote with data,
+    // for a leaf that reached the disk ahead of it. The first page older than
+    // lsn is written again, and the pages after it, whose ids went with its
+    // lost next pointer, are replaced with new ones.
+    static bool Repair(BufferPoolManager* buffer_pool_manager, std::string_view data, page_id_t first_page,
+                       lsn_t lsn);
+    // Writes data over the page_count pages of the chain at first_page, which
+    // may be empty, and adds scratch pages at the end if they are not enough.
+    // Pages data does not reach stay in the chain for later rewrites.
+    static bool Rewrite(BufferPoolManager* buffer_pool_manager, std::string_view data, page_id_t& first_page,
+                        uint32_t& page_count);
+};
\ No newline at end of file
@@ -1,4 +1,6 @@
 #include "page.h"
 
-Page::Page(page_id_t page_id) : page_id_(page_id), data_(PAGE_SIZE, 0) {
+Page::Page(page_id_t page_id)
+    : page_id_(page_id), data_(static_cast<char*>(std::aligned_alloc(PAGE_SIZE, PAGE_SIZE)), &std::free) {
+    ResetMemory();
 }
\ No newline at end of file
@@ -1,24 +1,50 @@
 #pragma once
+#include <cstddef>
 #include <cstdint>
-#include <vector>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <shared_mutex>
 
 constexpr size_t PAGE_SIZE = 4096;  // 4KB pages
 using page_id_t = uint32_t;
+using lsn_t = uint64_t;
+
+constexpr page_id_t INVALID_PAGE_ID = static_cast<page_id_t>(-1);
+constexpr lsn_t INVALID_LSN = 0;
+constexpr size_t PAGE_LSN_OFFSET = 0;  // every page layout starts with its LSN
 
 class Page {
 public:
-    Page(page_id_t page_id);
+    explicit Page(page_id_t page_id = INVALID_PAGE_ID);
     ~Page() = default;
 
     page_id_t GetPageId() const { return page_id_; }
-    char* GetData() { return data_.data(); }
-    const char* GetData() const { return data_.data(); }
+    void SetPageId(page_id_t page_id) { page_id_ = page_id; }
+    void ResetMemory() { std::memset(data_.get(), 0, PAGE_SIZE); }
+
+    // Page memory is PAGE_SIZE-aligned so it can be handed to O_DIRECT I/O.
+    char* GetData() { return data_.get(); }
+    const char* GetData() const { return data_.get(); }
     
+    lsn_t GetLSN() const {
+        lsn_t lsn;
+        std::memcpy(&lsn, data_.get() + PAGE_LSN_OFFSET, sizeof(lsn));
+        return lsn;
+    }
+    void SetLSN(lsn_t lsn) { std::memcpy(data_.get() + PAGE_LSN_OFFSET, &lsn, sizeof(lsn)); }
+
     bool IsDirty() const { return is_dirty_; }
     void SetDirty(bool dirty) { is_dirty_ = dirty; }
 
+    void RLatch() { latch_.lock_shared(); }
+    void RUnlatch() { latch_.unlock_shared(); }
+    void WLatch() { latch_.lock(); }
+    void WUnlatch() { latch_.unlock(); }
+
 private:
     page_id_t page_id_;
-    std::vector<char> data_;
+    std::unique_ptr<char, decltype(&std::free)> data_;
     bool is_dirty_{false};
+    std::shared_mutex latch_;
 };
\ No newline at end of file
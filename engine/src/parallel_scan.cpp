@@ -0,0 +1,25 @@
+#include "parallel_scan.h"
+#include <memory>
+
+ParallelScan::ParallelScan(BTree* tree, btree_key_t start_key, btree_key_t end_key,
+                           std::vector<BatchFilter> filters, std::vector<bool> columns, size_t morsel_count)
+    : tree_(tree), end_key_(end_key), filters_(std::move(filters)), columns_(std::move(columns)) {
+    if (start_key <= end_key) {
+        starts_ = tree_->SplitRange(start_key, end_key, morsel_count);
+    }
+}
+
+void ParallelScan::Run(WorkerPool& pool, const Consumer& consume) {
+    // Batches are large, so each worker allocates one and reuses it.
+    std::vector<std::unique_ptr<ColumnBatch>> batches(pool.GetThreadCount());
+    pool.Run(starts_.size(), [&](size_t worker, size_t morsel) {
+        if (!batches[worker]) {
+            batches[worker] = std::make_unique<ColumnBatch>(columns_.size());
+        }
+        btree_key_t end_key = morsel + 1 < starts_.size() ? starts_[morsel + 1] - 1 : end_key_;
+        VectorizedScan scan(tree_->Scan(starts_[morsel], end_key), filters_, columns_);
+        while (scan.NextBatch(*batches[worker])) {
+            consume(worker, morsel, *batches[worker]);
+        }
+    });
+}
\ No newline at end of file
@@ -0,0 +1,35 @@
+#pragma once
+#include "btree.h"
+#include "vectorized_scan.h"
+#include "worker_pool.h"
+#include <functional>
+#include <vector>
+
+// Enough morsels per worker for stealing to even out skewed ranges.
+constexpr size_t MORSELS_PER_WORKER = 4;
+
+// Table scan split into morsels, ranges of whole subtrees cut at separator
+// keys, which the workers of a pool take and filter independently. Morsels
+// are numbered in key order, so results collected per morsel concatenate into
+// the same order as a serial scan whatever order the workers finish in.
+class ParallelScan {
+public:
+    using Consumer = std::function<void(size_t worker, size_t morsel, const ColumnBatch& batch)>;
+
+    ParallelScan(BTree* tree, btree_key_t start_key, btree_key_t end_key, std::vector<BatchFilter> filters,
+                 std::vector<bool> columns, size_t morsel_count);
+    ~ParallelScan() = default;
+
+    size_t GetMorselCount() const { return starts_.size(); }
+
+    // Calls consume for every batch of every morsel, from the worker threads.
+    // Batches of one morsel are passed in order and on one thread.
+    void Run(WorkerPool& pool, const Consumer& consume);
+
+private:
+    BTree* tree_;
+    btree_key_t end_key_;
+    std::vector<BatchFilter> filters_;
+    std::vector<bool> columns_;
+    std::vector<btree_key_t> starts_;
+};
\ No newline at end of file
@@ -0,0 +1,170 @@
+#include "pax_leaf.h"
+#include <cstring>
+
+static constexpr char ZERO_INT[sizeof(int)] = {};
+
+PaxLeaf::PaxLeaf(std::string_view body, int row_count) : body_(body), row_count_(row_count) {
+    if (row_count == 0) {
+        return;
+    }
+
+    int column_count = Minipage::ColumnCount(body_.data());
+    columns_.resize(column_count);
+    for (int column = 0; column < column_count; ++column) {
+        Minipage minipage = Minipage::At(body_.data(), column, row_count);
+        auto& cells = columns_[column];
+        cells.reserve(row_count + 1);
+        for (int row = 0; row < row_count; ++row) {
+            cells.push_back(Cell{minipage.TypeAt(row), minipage.BytesAt(row)});
+        }
+    }
+}
+
+void PaxLeaf::InsertRow(int index, const Record& record) {
+    const auto& values = record.GetValues();
+    Widen(values.size());
+
+    // Overflowed strings are stored as their encoded OverflowRef, type 3.
+    std::vector<uint8_t> types(values.size());
+    std::vector<size_t> sizes(values.size());
+    std::string& bytes = added_.emplace_back();
+    for (size_t i = 0; i < values.size(); ++i) {
+        const Value& value = values[i];
+        size_t start = bytes.size();
+        types[i] = static_cast<uint8_t>(value.index());
+        if (std::holds_alternative<int>(value)) {
+            int number = std::get<int>(value);
+            bytes.append(reinterpret_cast<const char*>(&number), sizeof(number));
+        } else if (std::holds_alternative<double>(value)) {
+            double number = std::get<double>(value);
+            bytes.append(reinterpret_cast<const char*>(&number), sizeof(number));
+        } else {
+            bytes.append(std::get<std::string>(value));
+        }
+        sizes[i] = bytes.size() - start;
+    }
+    for (const auto& overflow : record.GetOverflow()) {
+        const std::string& prefix = std::get<std::string>(values[overflow.index]);
+        std::string encoded(OverflowRef::HEADER_SIZE + prefix.size(), '\0');
+        OverflowRef{overflow.length, overflow.page, prefix}.Encode(encoded.data());
+        size_t start = 0;
+        for (size_t i = 0; i < overflow.index; ++i) {
+            start += sizes[i];
+        }
+        bytes.replace(start, sizes[overflow.index], encoded);
+        types[overflow.index] = 3;
+        sizes[overflow.index] = encoded.size();
+    }
+
+    size_t offset = 0;
+    for (size_t column = 0; column < columns_.size(); ++column) {
+        Cell cell{0, std::string_view(ZERO_INT, sizeof(ZERO_INT))};
+        if (column < values.size()) {
+            cell.type = types[column];
+            cell.bytes = std::string_view(bytes.data() + offset, sizes[column]);
+            offset += sizes[column];
+        }
+        columns_[column].insert(columns_[column].begin() + index, cell);
+    }
+    row_count_++;
+}
+
+void PaxLeaf::RemoveRow(int index) {
+    for (auto& cells : columns_) {
+        cells.erase(cells.begin() + index);
+    }
+    if (--row_count_ == 0) {
+        columns_.clear();
+    }
+}
+
+void PaxLeaf::MoveRowsTo(PaxLeaf& dst, int from_index) {
+    Widen(dst.columns_.size());
+    dst.Widen(columns_.size());
+    for (size_t column = 0; column < columns_.size(); ++column) {
+        auto& cells = columns_[column];
+        dst.columns_[column].insert(dst.columns_[column].end(), cells.begin() + from_index, cells.end());
+        cells.resize(from_index);
+    }
+    dst.row_count_ += row_count_ - from_index;
+    row_count_ = from_index;
+    if (row_count_ == 0) {
+        columns_.clear();
+    }
+}
+
+size_t PaxLeaf::GetEncodedSize() const {
+    if (row_count_ == 0) {
+        return 0;
+    }
+    size_t size = sizeof(uint16_t) * (1 + columns_.size());
+    for (const auto& cells : columns_) {
+        size += MinipageSize(cells);
+    }
+    return size;
+}
+
+void PaxLeaf::Encode(char* body) const {
+    if (row_count_ == 0) {
+        return;
+    }
+
+    auto column_count = static_cast<uint16_t>(columns_.size());
+    std::memcpy(body, &column_count, sizeof(column_count));
+    size_t offset = sizeof(uint16_t) * (1 + columns_.size());
+
+    for (size_t column = 0; column < columns_.size(); ++column) {
+        const auto& cells = columns_[column];
+        auto minipage_offset = static_cast<uint16_t>(offset);
+        std::memcpy(body + sizeof(uint16_t) * (1 + column), &minipage_offset, sizeof(minipage_offset));
+
+        Minipage::Kind kind = KindOf(cells);
+        char* data = body + offset;
+        *data++ = static_cast<char>(kind);
+        if (kind == Minipage::VARIABLE) {
+            char* ends = data + cells.size();
+            char* payload = ends + sizeof(uint16_t) * cells.size();
+            uint16_t end = 0;
+            for (size_t row = 0; row < cells.size(); ++row) {
+                data[row] = static_cast<char>(cells[row].type);
+                std::memcpy(payload + end, cells[row].bytes.data(), cells[row].bytes.size());
+                end = static_cast<uint16_t>(end + cells[row].bytes.size());
+                std::memcpy(ends + sizeof(uint16_t) * row, &end, sizeof(end));
+            }
+        } else {
+            for (const auto& cell : cells) {
+                std::memcpy(data, cell.bytes.data(), cell.bytes.size());
+                data += cell.bytes.size();
+            }
+        }
+        offset += MinipageSize(cells);
+    }
+}
+
+void PaxLeaf::Widen(size_t column_count) {
+    while (columns_.size() < column_count) {
+        columns_.emplace_back(row_count_, Cell{0, std::string_view(ZERO_INT, sizeof(ZERO_INT))});
+    }
+}
+
+Minipage::Kind PaxLeaf::KindOf(const std::vector<Cell>& column) {
+    uint8_t type = column.empty() ? 0 : column[0].type;
+    for (const auto& cell : column) {
+        if (cell.type != type) {
+            return Minipage::VARIABLE;
+        }
+    }
+    return type == 0 ? Minipage::INT : type == 1 ? Minipage::DOUBLE : Minipage::VARIABLE;
+}
+
+size_t PaxLeaf::MinipageSize(const std::vector<Cell>& column) {
+    size_t size = 1;
+    Minipage::Kind kind = KindOf(column);
+    if (kind == Minipage::VARIABLE) {
+        size += (1 + sizeof(uint16_t)) * column.size();
+    }
+    for (const auto& cell : column) {
+        size += cell.bytes.size();
+    }
+    return size;
+}
\ No newline at end of file
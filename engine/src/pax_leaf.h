@@ -0,0 +1,44 @@
+#pragma once
+#include "btree_page.h"
+#include "record.h"
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Decoded copy of the columns of a PAX leaf, edited row by row and then
+// encoded back as a whole. Every change to a PAX leaf rewrites its minipages,
+// which is the price paid for scans that touch only a few columns.
+class PaxLeaf {
+public:
+    PaxLeaf(std::string_view body, int row_count);
+    ~PaxLeaf() = default;
+
+    int GetRowCount() const { return row_count_; }
+
+    // Rows with fewer values than the leaf has columns are padded with 0.
+    void InsertRow(int index, const Record& record);
+    void RemoveRow(int index);
+    // Appends the rows from from_index on to dst and removes them here. dst
+    // refers to the values of this leaf until it has been encoded.
+    void MoveRowsTo(PaxLeaf& dst, int from_index);
+
+    size_t GetEncodedSize() const;
+    void Encode(char* body) const;
+
+private:
+    struct Cell {
+        uint8_t type;
+        std::string_view bytes;
+    };
+
+    std::string body_;
+    std::deque<std::string> added_;
+    std::vector<std::vector<Cell>> columns_;
+    int row_count_;
+
+    void Widen(size_t column_count);
+    static Minipage::Kind KindOf(const std::vector<Cell>& column);
+    static size_t MinipageSize(const std::vector<Cell>& column);
+};
\ No newline at end of file
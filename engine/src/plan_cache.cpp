@@ -0,0 +1,40 @@
+#include "plan_cache.h"
+
+PlanCache::PlanCache(size_t capacity) : capacity_(capacity) {}
+
+std::shared_ptr<const Plan> PlanCache::Get(const std::string& sql) {
+    auto it = index_.find(sql);
+    if (it == index_.end()) {
+        misses_++;
+        return nullptr;
+    }
+
+    hits_++;
+    entries_.splice(entries_.begin(), entries_, it->second);
+    return it->second->second;
+}
+
+void PlanCache::Put(const std::string& sql, std::shared_ptr<const Plan> plan) {
+    if (capacity_ == 0) {
+        return;
+    }
+
+    auto it = index_.find(sql);
+    if (it != index_.end()) {
+        it->second->second = std::move(plan);
+        entries_.splice(entries_.begin(), entries_, it->second);
+        return;
+    }
+
+    if (entries_.size() >= capacity_) {
+        index_.erase(entries_.back().first);
+        entries_.pop_back();
+    }
+    entries_.emplace_front(sql, std::move(plan));
+    index_[sql] = entries_.begin();
+}
+
+void PlanCache::Clear() {
+    entries_.clear();
+    index_.clear();
+}
\ No newline at end of file
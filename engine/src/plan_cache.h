@@ -0,0 +1,31 @@
+#pragma once
+#include "prepared_statement.h"
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+// LRU cache of plans keyed by normalized SQL text.
+class PlanCache {
+public:
+    explicit PlanCache(size_t capacity);
+    ~PlanCache() = default;
+
+    std::shared_ptr<const Plan> Get(const std::string& sql);
+    void Put(const std::string& sql, std::shared_ptr<const Plan> plan);
+    void Clear();
+
+    size_t GetSize() const { return entries_.size(); }
+    uint64_t GetHitCount() const { return hits_; }
+    uint64_t GetMissCount() const { return misses_; }
+
+private:
+    using Entry = std::pair<std::string, std::shared_ptr<const Plan>>;
+
+    size_t capacity_;
+    std::list<Entry> entries_;
+    std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+    uint64_t hits_{0};
+    uint64_t misses_{0};
+};
\ No newline at end of file
@@ -0,0 +1,62 @@
+#include "posix_storage_manager.h"
+#include <algorithm>
+#include <cerrno>
+#include <iostream>
+#include <fcntl.h>
+#include <unistd.h>
+
+PosixStorageManager::PosixStorageManager(const std::string& db_file, bool direct_io)
+    : StorageManager(db_file), direct_io_(false) {
+#ifdef O_DIRECT
+    if (direct_io && OpenFile(O_DIRECT)) {
+        direct_io_ = true;
+        return;
+    }
+    if (direct_io) {
+        std::cerr << "O_DIRECT unavailable for " << db_file << ", using buffered I/O" << std::endl;
+    }
+#endif
+    OpenFile(0);
+}
+
+PosixStorageManager::~PosixStorageManager() {
+    TrimFile();
+}
+
+bool PosixStorageManager::ReadPage(page_id_t page_id, char* data) {
+    off_t offset = static_cast<off_t>(page_id) * PAGE_SIZE;
+    size_t read_bytes = 0;
+    while (read_bytes < PAGE_SIZE) {
+        ssize_t n = ::pread(fd_, data + read_bytes, PAGE_SIZE - read_bytes, offset + read_bytes);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            break;
+        }
+        read_bytes += static_cast<size_t>(n);
+    }
+
+    if (read_bytes != PAGE_SIZE) {
+        std::cerr << "Warning: Read less than expected page size" << std::endl;
+        std::fill(data + read_bytes, data + PAGE_SIZE, 0);
+        return false;
+    }
+    return true;
+}
+
+bool PosixStorageManager::WritePage(page_id_t page_id, const char* data) {
+    off_t offset = static_cast<off_t>(page_id) * PAGE_SIZE;
+    size_t written = 0;
+    while (written < PAGE_SIZE) {
+        ssize_t n = ::pwrite(fd_, data + written, PAGE_SIZE - written, offset + written);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        written += static_cast<size_t>(n);
+    }
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,16 @@
+#pragma once
+#include "storage_manager.h"
+
+class PosixStorageManager : public StorageManager {
+public:
+    PosixStorageManager(const std::string& db_file, bool direct_io);
+    ~PosixStorageManager() override;
+
+    bool ReadPage(page_id_t page_id, char* data) override;
+    bool WritePage(page_id_t page_id, const char* data) override;
+
+    bool IsDirectIO() const { return direct_io_; }
+
+private:
+    bool direct_io_;
+};
\ No newline at end of file
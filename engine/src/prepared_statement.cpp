@@ -0,0 +1,58 @@
+#include "prepared_statement.h"
+#include "database.h"
+#include <algorithm>
+#include <iostream>
+
+PreparedStatement::PreparedStatement(Database* database, std::shared_ptr<const Plan> plan)
+    : database_(database), plan_(std::move(plan)),
+      parameters_(plan_->query->placeholders.size()), bound_(plan_->query->placeholders.size(), false) {}
+
+bool PreparedStatement::Bind(size_t index, int value) {
+    return BindValue(index, value);
+}
+
+bool PreparedStatement::Bind(size_t index, double value) {
+    return BindValue(index, value);
+}
+
+bool PreparedStatement::Bind(size_t index, const std::string& value) {
+    return BindValue(index, value);
+}
+
+void PreparedStatement::ClearBindings() {
+    std::fill(bound_.begin(), bound_.end(), false);
+}
+
+bool PreparedStatement::Execute() {
+    if (!AllBound()) {
+        return false;
+    }
+    return database_->ExecutePlan(plan_, parameters_);
+}
+
+std::unique_ptr<Cursor> PreparedStatement::Query() {
+    if (!AllBound()) {
+        return nullptr;
+    }
+    return database_->QueryPlan(plan_, parameters_);
+}
+
+bool PreparedStatement::BindValue(size_t index, Value value) {
+    if (index >= parameters_.size()) {
+        std::cerr << "Parameter index out of range: " << index << std::endl;
+        return false;
+    }
+    parameters_[index] = std::move(value);
+    bound_[index] = true;
+    return true;
+}
+
+bool PreparedStatement::AllBound() const {
+    for (size_t i = 0; i < bound_.size(); ++i) {
+        if (!bound_[i]) {
+            std::cerr << "Parameter " << i << " is not bound" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
\ No newline at end of file
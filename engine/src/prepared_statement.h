@@ -0,0 +1,61 @@
+#pragma once
+#include "sql_parser.h"
+#include "compare_op.h"
+#include "cursor.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+class Database;
+class SecondaryIndex;
+struct Table;
+
+// Parsed statement with its table, condition columns and access path already
+// resolved. Plans are immutable and shared between statement handles.
+struct Plan {
+    std::unique_ptr<Query> query;
+    Table* table{nullptr};
+    Table* join_table{nullptr};  // columns of a join are numbered across table, then join_table
+    int join_column{-1};         // column of table in the ON condition
+    int join_table_column{-1};   // column of join_table in the ON condition
+    std::vector<int> projection;  // columns a SELECT returns, empty for all; -1 for COUNT(*)
+    std::vector<AggregateFunction> aggregates;  // per projected column, empty unless the SELECT aggregates
+    std::vector<int> group_by;
+    std::vector<SortKey> order_by;  // on table columns, or on select list entries when aggregating
+    std::vector<int> condition_columns;
+    std::vector<CompareOp> condition_ops;
+    bool conjunctive{true};  // no OR in the WHERE clause
+    std::vector<int> key_conditions;       // conditions on the primary key bounding the scan
+    std::vector<int> join_key_conditions;  // the same for join_table
+    std::vector<int> residual_conditions;  // conditions checked on every row the scan returns
+    SecondaryIndex* index{nullptr};
+    int index_condition{-1};  // condition driving a scan of index, when there are no key conditions
+};
+
+// Handle returned by Database::Prepare. Every '?' in the statement must be
+// bound before it is executed; bindings survive across executions.
+class PreparedStatement {
+public:
+    PreparedStatement(Database* database, std::shared_ptr<const Plan> plan);
+    ~PreparedStatement() = default;
+
+    size_t GetParameterCount() const { return parameters_.size(); }
+
+    // Parameters are numbered from 0 in the order they appear in the SQL.
+    bool Bind(size_t index, int value);
+    bool Bind(size_t index, double value);
+    bool Bind(size_t index, const std::string& value);
+    void ClearBindings();
+
+    bool Execute();
+    std::unique_ptr<Cursor> Query();
+
+private:
+    Database* database_;
+    std::shared_ptr<const Plan> plan_;
+    std::vector<Value> parameters_;
+    std::vector<bool> bound_;
+
+    bool BindValue(size_t index, Value value);
+    bool AllBound() const;
+};
\ No newline at end of file
@@ -1,8 +1,45 @@
 #include "record.h"
+#include "varint.h"
+#include <algorithm>
 #include <sstream>
 
 Record::Record(const std::vector<Value>& values) : values_(values) {}
 
+void OverflowRef::Encode(char* data) const {
+    std::memcpy(data, &length, sizeof(length));
+    std::memcpy(data + sizeof(length), &page, sizeof(page));
+    std::memcpy(data + HEADER_SIZE, prefix.data(), prefix.size());
+}
+
+OverflowRef OverflowRef::Decode(std::string_view bytes) {
+    OverflowRef ref;
+    std::memcpy(&ref.length, bytes.data(), sizeof(ref.length));
+    std::memcpy(&ref.page, bytes.data() + sizeof(ref.length), sizeof(ref.page));
+    ref.prefix = bytes.substr(HEADER_SIZE);
+    return ref;
+}
+
+void Record::SetValue(size_t index, Value value) {
+    values_[index] = std::move(value);
+    overflow_.erase(std::remove_if(overflow_.begin(), overflow_.end(),
+                                   [index](const Overflow& overflow) { return overflow.index == index; }),
+                    overflow_.end());
+}
+
+void Record::SetOverflow(size_t index, std::string prefix, uint64_t length, page_id_t page) {
+    SetValue(index, std::move(prefix));
+    overflow_.push_back(Overflow{index, length, page});
+}
+
+const Record::Overflow* Record::FindOverflow(size_t index) const {
+    for (const auto& overflow : overflow_) {
+        if (overflow.index == index) {
+            return &overflow;
+        }
+    }
+    return nullptr;
+}
+
 Value Record::GetValue(size_t index) const {
     if (index >= values_.size()) {
         return 0;
@@ -11,89 +48,59 @@ Value Record::GetValue(size_t index) const {
 }
 
 size_t Record::GetSize() const {
-    size_t size = sizeof(size_t);
-    for (const auto& value : values_) {
+    size_t size = VarintSize(values_.size());
+    for (size_t i = 0; i < values_.size(); ++i) {
         size += sizeof(uint8_t);
-        std::visit([&size](const auto& v) {
+        std::visit([&](const auto& v) {
             using T = std::decay_t<decltype(v)>;
             if constexpr (std::is_same_v<T, int> || std::is_same_v<T, double>) {
                 size += sizeof(T);
             } else {
-                size += sizeof(size_t) + v.length();
+                size_t length = v.length() + (FindOverflow(i) ? OverflowRef::HEADER_SIZE : 0);
+                size += VarintSize(length) + length;
             }
-        }, value);
+        }, values_[i]);
     }
     return size;
 }
 
 void Record::Serialize(char* data) const {
-    size_t offset = 0;
-    
-    size_t count = values_.size();
-    std::memcpy(data + offset, &count, sizeof(count));
-    offset += sizeof(count);
-    
-    for (const auto& value : values_) {
+    size_t offset = EncodeVarint(values_.size(), data);
+    for (size_t i = 0; i < values_.size(); ++i) {
         std::visit([&](const auto& v) {
             using T = std::decay_t<decltype(v)>;
-            if constexpr (std::is_same_v<T, int>) {
-                uint8_t type = 0;
-                std::memcpy(data + offset, &type, sizeof(type));
-                offset += sizeof(type);
-                std::memcpy(data + offset, &v, sizeof(v));
-                offset += sizeof(v);
-            } else if constexpr (std::is_same_v<T, double>) {
-                uint8_t type = 1;
-                std::memcpy(data + offset, &type, sizeof(type));
-                offset += sizeof(type);
+            if constexpr (std::is_same_v<T, int> || std::is_same_v<T, double>) {
+                data[offset++] = std::is_same_v<T, int> ? 0 : 1;
                 std::memcpy(data + offset, &v, sizeof(v));
                 offset += sizeof(v);
+            } else if (const Overflow* overflow = overflow_.empty() ? nullptr : FindOverflow(i)) {
+                data[offset++] = 3;
+                offset += EncodeVarint(OverflowRef::HEADER_SIZE + v.length(), data + offset);
+                OverflowRef{overflow->length, overflow->page, v}.Encode(data + offset);
+                offset += OverflowRef::HEADER_SIZE + v.length();
             } else {
-                uint8_t type = 2;
-                std::memcpy(data + offset, &type, sizeof(type));
-                offset += sizeof(type);
-                size_t len = v.length();
-                std::memcpy(data + offset, &len, sizeof(len));
-                offset += sizeof(len);
-                std::memcpy(data + offset, v.c_str(), len);
-                offset += len;
+                data[offset++] = 2;
+                offset += EncodeVarint(v.length(), data + offset);
+                std::memcpy(data + offset, v.data(), v.length());
+                offset += v.length();
             }
-        }, value);
+        }, values_[i]);
     }
 }
 
 Record Record::Deserialize(const char* data, size_t& offset) {
     Record record;
-    
-    size_t count;
-    std::memcpy(&count, data + offset, sizeof(count));
-    offset += sizeof(count);
-    
-    for (size_t i = 0; i < count; ++i) {
-        uint8_t type;
-        std::memcpy(&type, data + offset, sizeof(type));
-        offset += sizeof(type);
-        
-        if (type == 0) {
-            int value;
-            std::memcpy(&value, data + offset, sizeof(value));
-            offset += sizeof(value);
-            record.AddValue(value);
-        } else if (type == 1) {
-            double value;
-            std::memcpy(&value, data + offset, sizeof(value));
-            offset += sizeof(value);
-            record.AddValue(value);
+    VisitSerialized(data + offset, [&record](size_t index, const auto& value) {
+        using T = std::decay_t<decltype(value)>;
+        if constexpr (std::is_same_v<T, OverflowRef>) {
+            record.AddValue(std::string());
+            record.SetOverflow(index, std::string(value.prefix), value.length, value.page);
+        } else if constexpr (std::is_same_v<T, std::string_view>) {
+            record.AddValue(std::string(value));
         } else {
-            size_t len;
-            std::memcpy(&len, data + offset, sizeof(len));
-            offset += sizeof(len);
-            std::string value(data + offset, len);
-            offset += len;
             record.AddValue(value);
         }
-    }
-    
+    }, &offset);
     return record;
 }
 
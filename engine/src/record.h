@@ -1,26 +1,103 @@
 #pragma once
+#include "page.h"
+#include "varint.h"
 #include <string>
 #include <vector>
 #include <variant>
+#include <cstdint>
 #include <cstring>
+#include <string_view>
 
 using Value = std::variant<int, double, std::string>;
 
+// A string kept out of line in a chain of overflow pages, with only its first
+// bytes in the record. Serialized like a string but with type 3, as
+//   [length][first page][prefix]
+struct OverflowRef {
+    static constexpr size_t HEADER_SIZE = sizeof(uint64_t) + sizeof(page_id_t);
+
+    uint64_t length;  // of the whole string
+    page_id_t page;
+    std::string_view prefix;
+
+    void Encode(char* data) const;
+    static OverflowRef Decode(std::string_view bytes);
+};
+
 class Record {
 public:
     Record() = default;
     explicit Record(const std::vector<Value>& values);
     
     void AddValue(const Value& value) { values_.push_back(value); }
+    void SetValue(size_t index, Value value);
     const std::vector<Value>& GetValues() const { return values_; }
     Value GetValue(size_t index) const;
+
+    // A string value whose rest is in overflow pages: the value holds only
+    // prefix. Set by the B+tree, which reads such values back before they
+    // leave it; SetValue replaces one with a plain value.
+    struct Overflow {
+        size_t index;
+        uint64_t length;
+        page_id_t page;
+    };
+    void SetOverflow(size_t index, std::string prefix, uint64_t length, page_id_t page);
+    const std::vector<Overflow>& GetOverflow() const { return overflow_; }
     
     size_t GetSize() const;
     void Serialize(char* data) const;
     static Record Deserialize(const char* data, size_t& offset);
+
+    // Serialized records are self-describing: a varint value count, then per
+    // value a type byte and an int, a double, or a varint length and bytes.
+    // Calls visit(index, value) for each value of a serialized record without
+    // materializing it. Strings are passed as a std::string_view into data,
+    // and overflowed strings as an OverflowRef. size, if given, is advanced by
+    // the size of the record.
+    template <typename Visitor>
+    static void VisitSerialized(const char* data, Visitor&& visit, size_t* size = nullptr);
     
     std::string ToString() const;
 
 private:
     std::vector<Value> values_;
-};
\ No newline at end of file
+    std::vector<Overflow> overflow_;
+
+    const Overflow* FindOverflow(size_t index) const;
+};
+
+template <typename Visitor>
+void Record::VisitSerialized(const char* data, Visitor&& visit, size_t* size) {
+    uint64_t count;
+    size_t offset = DecodeVarint(data, count);
+
+    for (size_t i = 0; i < count; ++i) {
+        uint8_t type = static_cast<uint8_t>(data[offset]);
+        offset += sizeof(type);
+        if (type == 0) {
+            int value;
+            std::memcpy(&value, data + offset, sizeof(value));
+            offset += sizeof(value);
+            visit(i, value);
+        } else if (type == 1) {
+            double value;
+            std::memcpy(&value, data + offset, sizeof(value));
+            offset += sizeof(value);
+            visit(i, value);
+        } else {
+            uint64_t len;
+            offset += DecodeVarint(data + offset, len);
+            std::string_view bytes(data + offset, len);
+            offset += len;
+            if (type == 3) {
+                visit(i, OverflowRef::Decode(bytes));
+            } else {
+                visit(i, bytes);
+            }
+        }
+    }
+    if (size) {
+        *size += offset;
+    }
+}
\ No newline at end of file
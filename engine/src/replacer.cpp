@@ -0,0 +1,13 @@
+#include "replacer.h"
+#include "clock_replacer.h"
+#include "lru_k_replacer.h"
+
+std::unique_ptr<Replacer> Replacer::Create(ReplacerType type, size_t num_frames) {
+    switch (type) {
+        case ReplacerType::CLOCK:
+            return std::make_unique<ClockReplacer>(num_frames);
+        case ReplacerType::LRU_K:
+        default:
+            return std::make_unique<LRUKReplacer>(num_frames);
+    }
+}
\ No newline at end of file
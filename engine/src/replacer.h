@@ -0,0 +1,30 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+using frame_id_t = uint32_t;
+
+enum class ReplacerType {
+    LRU_K,
+    CLOCK
+};
+
+// Tracks which frames may be evicted. Pin marks a frame as in use and records
+// an access; Unpin makes it a candidate again. All operations are O(1)
+// (CLOCK victim selection is amortized O(1)).
+class Replacer {
+public:
+    virtual ~Replacer() = default;
+
+    virtual void Pin(frame_id_t frame_id) = 0;
+    virtual void Unpin(frame_id_t frame_id) = 0;
+    virtual bool Victim(frame_id_t* frame_id) = 0;
+    virtual void Remove(frame_id_t frame_id) = 0;
+    virtual size_t Size() const = 0;
+    // Grows the range of frame ids to [0, num_frames), for frames that move
+    // in from another buffer pool shard.
+    virtual void Resize(size_t num_frames) = 0;
+
+    static std::unique_ptr<Replacer> Create(ReplacerType type, size_t num_frames);
+};
\ No newline at end of file
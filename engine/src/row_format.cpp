@@ -0,0 +1,155 @@
+#include "row_format.h"
+#include <algorithm>
+#include <cctype>
+#include <string>
+
+RowFormat::RowFormat(std::vector<ColumnType> types) : types_(std::move(types)) {
+    size_t offset = (types_.size() + 3) / 4;
+    fixed_offsets_.resize(types_.size(), 0);
+    for (size_t column = 0; column < types_.size(); ++column) {
+        if (types_[column] == ColumnType::INT) {
+            fixed_offsets_[column] = static_cast<uint16_t>(offset);
+            offset += sizeof(int);
+        } else if (types_[column] == ColumnType::DOUBLE) {
+            fixed_offsets_[column] = static_cast<uint16_t>(offset);
+            offset += sizeof(double);
+        }
+    }
+    header_size_ = offset;
+}
+
+ColumnType RowFormat::TypeOf(std::string_view type_name) {
+    std::string name(type_name);
+    std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return std::toupper(c); });
+    if (name == "INT" || name == "INTEGER") {
+        return ColumnType::INT;
+    }
+    if (name == "DOUBLE" || name == "FLOAT" || name == "REAL") {
+        return ColumnType::DOUBLE;
+    }
+    return ColumnType::STRING;
+}
+
+bool RowFormat::CanEncode(const Record& record) const {
+    return !IsTyped() || record.GetValues().size() <= types_.size();
+}
+
+RowFormat::State RowFormat::StateOf(const Record& record, size_t column) const {
+    const auto& values = record.GetValues();
+    if (column >= values.size()) {
+        return NULL_VALUE;
+    }
+    for (const auto& overflow : record.GetOverflow()) {
+        if (overflow.index == column) {
+            return OVERFLOWED;
+        }
+    }
+    return values[column].index() == static_cast<size_t>(types_[column]) ? DECLARED : OTHER_TYPE;
+}
+
+size_t RowFormat::GetSize(const Record& record) const {
+    if (!IsTyped()) {
+        return record.GetSize();
+    }
+
+    const auto& values = record.GetValues();
+    size_t size = header_size_;
+    for (size_t column = 0; column < values.size() && column < types_.size(); ++column) {
+        State state = StateOf(record, column);
+        const Value& value = values[column];
+        if (state == DECLARED && IsFixed(column)) {
+            continue;
+        }
+        if (state == OVERFLOWED) {
+            size_t length = OverflowRef::HEADER_SIZE + std::get<std::string>(value).size();
+            size += VarintSize(length) + length;
+            continue;
+        }
+        size += state == OTHER_TYPE ? sizeof(uint8_t) : 0;
+        if (std::holds_alternative<int>(value)) {
+            size += sizeof(int);
+        } else if (std::holds_alternative<double>(value)) {
+            size += sizeof(double);
+        } else {
+            size_t length = std::get<std::string>(value).size();
+            size += VarintSize(length) + length;
+        }
+    }
+    return size;
+}
+
+void RowFormat::Encode(const Record& record, char* data) const {
+    if (!IsTyped()) {
+        record.Serialize(data);
+        return;
+    }
+
+    const auto& values = record.GetValues();
+    std::memset(data, 0, header_size_);
+    size_t offset = header_size_;
+    for (size_t column = 0; column < types_.size(); ++column) {
+        State state = StateOf(record, column);
+        data[column / 4] = static_cast<char>(static_cast<uint8_t>(data[column / 4]) | (state << (column % 4 * 2)));
+        if (state == NULL_VALUE) {
+            continue;
+        }
+
+        const Value& value = values[column];
+        if (state == DECLARED && IsFixed(column)) {
+            std::visit([&](const auto& v) {
+                using T = std::decay_t<decltype(v)>;
+                if constexpr (!std::is_same_v<T, std::string>) {
+                    std::memcpy(data + fixed_offsets_[column], &v, sizeof(v));
+                }
+            }, value);
+            continue;
+        }
+        if (state == OVERFLOWED) {
+            const std::string& prefix = std::get<std::string>(value);
+            for (const auto& overflow : record.GetOverflow()) {
+                if (overflow.index == column) {
+                    offset += EncodeVarint(OverflowRef::HEADER_SIZE + prefix.size(), data + offset);
+                    OverflowRef{overflow.length, overflow.page, prefix}.Encode(data + offset);
+                    offset += OverflowRef::HEADER_SIZE + prefix.size();
+                }
+            }
+            continue;
+        }
+
+        if (state == OTHER_TYPE) {
+            data[offset++] = static_cast<char>(value.index());
+        }
+        std::visit([&](const auto& v) {
+            using T = std::decay_t<decltype(v)>;
+            if constexpr (std::is_same_v<T, std::string>) {
+                offset += EncodeVarint(v.size(), data + offset);
+                std::memcpy(data + offset, v.data(), v.size());
+                offset += v.size();
+            } else {
+                std::memcpy(data + offset, &v, sizeof(v));
+                offset += sizeof(v);
+            }
+        }, value);
+    }
+}
+
+Record RowFormat::Decode(const char* data) const {
+    if (!IsTyped()) {
+        size_t offset = 0;
+        return Record::Deserialize(data, offset);
+    }
+
+    Record record;
+    Visit(data, nullptr, [&record](size_t column, const auto& value) {
+        using T = std::decay_t<decltype(value)>;
+        if constexpr (std::is_same_v<T, OverflowRef>) {
+            record.AddValue(std::string());
+            record.SetOverflow(column, std::string(value.prefix), value.length, value.page);
+        } else if constexpr (std::is_same_v<T, std::string_view>) {
+            record.AddValue(std::string(value));
+        } else {
+            record.AddValue(value);
+        }
+    });
+    return record;
+}
\ No newline at end of file
@@ -0,0 +1,127 @@
+#pragma once
+#include "record.h"
+#include "varint.h"
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+enum class ColumnType : uint8_t {
+    INT = 0,
+    DOUBLE = 1,
+    STRING = 2
+};
+
+// Encoding of the rows of a row-layout B+tree, driven by the column types of
+// its table:
+//   [column states, two bits each][fixed slots][variable area]
+// Each INT and DOUBLE column has a slot at an offset known from the schema,
+// so it can be read without decoding the row. The variable area holds, in
+// column order, the strings as a varint length and bytes, overflowed strings
+// as a varint length and their OverflowRef, and values of a type other than
+// their column's as a type byte and the value as in a serialized Record.
+// Columns past the end of a shorter record are null. A format without
+// columns keeps rows in the self-describing Record format.
+class RowFormat {
+public:
+    enum State : uint8_t {
+        DECLARED = 0,
+        NULL_VALUE = 1,
+        OTHER_TYPE = 2,
+        OVERFLOWED = 3
+    };
+
+    RowFormat() = default;
+    explicit RowFormat(std::vector<ColumnType> types);
+
+    // INT and INTEGER are ints, DOUBLE, FLOAT and REAL are doubles, and any
+    // other type holds strings.
+    static ColumnType TypeOf(std::string_view type_name);
+
+    bool IsTyped() const { return !types_.empty(); }
+    // A typed format cannot encode a record with more values than columns.
+    bool CanEncode(const Record& record) const;
+    size_t GetSize(const Record& record) const;
+    void Encode(const Record& record, char* data) const;
+    Record Decode(const char* data) const;
+
+    // Calls visit(index, value) as Record::VisitSerialized does, skipping
+    // null columns and, when needed is given, the columns not set in it.
+    template <typename Visitor>
+    void Visit(const char* data, const std::vector<bool>* needed, Visitor&& visit) const;
+
+private:
+    std::vector<ColumnType> types_;
+    std::vector<uint16_t> fixed_offsets_;  // from the start of the row, for INT and DOUBLE columns
+    size_t header_size_{0};                // states and fixed slots
+
+    State StateAt(const char* data, size_t column) const {
+        return static_cast<State>((static_cast<uint8_t>(data[column / 4]) >> (column % 4 * 2)) & 3);
+    }
+    bool IsFixed(size_t column) const { return types_[column] != ColumnType::STRING; }
+    State StateOf(const Record& record, size_t column) const;
+};
+
+template <typename Visitor>
+void RowFormat::Visit(const char* data, const std::vector<bool>* needed, Visitor&& visit) const {
+    if (!IsTyped()) {
+        Record::VisitSerialized(data, [&](size_t index, const auto& value) {
+            if (!needed || (index < needed->size() && (*needed)[index])) {
+                visit(index, value);
+            }
+        });
+        return;
+    }
+
+    size_t offset = header_size_;
+    for (size_t column = 0; column < types_.size(); ++column) {
+        State state = StateAt(data, column);
+        bool wanted = !needed || (column < needed->size() && (*needed)[column]);
+        if (state == NULL_VALUE) {
+            continue;
+        }
+        if (state == DECLARED && IsFixed(column)) {
+            if (!wanted) {
+                continue;
+            }
+            const char* slot = data + fixed_offsets_[column];
+            if (types_[column] == ColumnType::INT) {
+                int value;
+                std::memcpy(&value, slot, sizeof(value));
+                visit(column, value);
+            } else {
+                double value;
+                std::memcpy(&value, slot, sizeof(value));
+                visit(column, value);
+            }
+            continue;
+        }
+
+        uint8_t type = state == OTHER_TYPE ? static_cast<uint8_t>(data[offset++]) : 2;
+        if (type == 0) {
+            int value;
+            std::memcpy(&value, data + offset, sizeof(value));
+            offset += sizeof(value);
+            if (wanted) {
+                visit(column, value);
+            }
+        } else if (type == 1) {
+            double value;
+            std::memcpy(&value, data + offset, sizeof(value));
+            offset += sizeof(value);
+            if (wanted) {
+                visit(column, value);
+            }
+        } else {
+            uint64_t length;
+            offset += DecodeVarint(data + offset, length);
+            std::string_view bytes(data + offset, length);
+            offset += length;
+            if (wanted && state == OVERFLOWED) {
+                visit(column, OverflowRef::Decode(bytes));
+            } else if (wanted) {
+                visit(column, bytes);
+            }
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,64 @@
+#include "secondary_index.h"
+#include <climits>
+#include <cstring>
+
+SecondaryIndex::SecondaryIndex(const std::string& name, int column, BufferPoolManager* buffer_pool_manager)
+    : name_(name), column_(column), tree_(buffer_pool_manager) {}
+
+SecondaryIndex::SecondaryIndex(const std::string& name, int column, BufferPoolManager* buffer_pool_manager,
+                               page_id_t root_page_id)
+    : name_(name), column_(column), tree_(buffer_pool_manager, root_page_id) {}
+
+bool SecondaryIndex::Insert(const Record& record, int primary_key, lsn_t lsn) {
+    return tree_.Insert(MakeKey(Prefix(record.GetValue(column_)), primary_key), Record(), lsn);
+}
+
+bool SecondaryIndex::Delete(const Record& record, int primary_key, lsn_t lsn) {
+    return tree_.Delete(MakeKey(Prefix(record.GetValue(column_)), primary_key), lsn);
+}
+
+BTreeIterator SecondaryIndex::Scan(CompareOp op, const Value& value) {
+    int32_t prefix = Prefix(value);
+    btree_key_t start_key = INT64_MIN;
+    btree_key_t end_key = INT64_MAX;
+    if (op == CompareOp::EQ || op == CompareOp::GT || op == CompareOp::GE) {
+        start_key = MakeKey(prefix, INT_MIN);
+    }
+    if (op == CompareOp::EQ || op == CompareOp::LT || op == CompareOp::LE) {
+        end_key = MakeKey(prefix, INT_MAX);
+    }
+    return tree_.Scan(start_key, end_key);
+}
+
+int SecondaryIndex::PrimaryKeyOf(btree_key_t key) {
+    return static_cast<int32_t>(static_cast<uint32_t>(key) ^ 0x80000000u);
+}
+
+// Order-preserving within each type: integers map to themselves, doubles to
+// the high half of their sortable bit pattern and strings to their first four
+// bytes read big-endian.
+int32_t SecondaryIndex::Prefix(const Value& value) {
+    uint32_t bits;
+    if (std::holds_alternative<int>(value)) {
+        return std::get<int>(value);
+    } else if (std::holds_alternative<double>(value)) {
+        uint64_t pattern;
+        double number = std::get<double>(value);
+        std::memcpy(&pattern, &number, sizeof(pattern));
+        pattern = (pattern >> 63) ? ~pattern : pattern ^ (1ULL << 63);
+        bits = static_cast<uint32_t>(pattern >> 32);
+    } else {
+        const std::string& text = std::get<std::string>(value);
+        bits = 0;
+        for (size_t i = 0; i < 4; ++i) {
+            bits = (bits << 8) | (i < text.size() ? static_cast<unsigned char>(text[i]) : 0);
+        }
+    }
+    return static_cast<int32_t>(bits ^ 0x80000000u);
+}
+
+btree_key_t SecondaryIndex::MakeKey(int32_t prefix, int primary_key) {
+    uint64_t high = static_cast<uint32_t>(prefix) ^ 0x80000000u;
+    uint64_t low = static_cast<uint32_t>(primary_key) ^ 0x80000000u;
+    return static_cast<btree_key_t>(((high << 32) | low) ^ (1ULL << 63));
+}
\ No newline at end of file
@@ -0,0 +1,39 @@
+#pragma once
+#include "btree.h"
+#include "compare_op.h"
+#include "record.h"
+#include <string>
+
+// B+tree mapping the value of one column to the primary keys of the rows
+// holding it. Each entry is a single 64-bit key: an order-preserving 32-bit
+// prefix of the value in the high half and the primary key in the low half,
+// so duplicate values stay unique and sort by primary key. Prefixes of
+// doubles and strings are lossy, so scans return a superset of the matching
+// rows and the caller re-checks the predicate on the row itself.
+class SecondaryIndex {
+public:
+    SecondaryIndex(const std::string& name, int column, BufferPoolManager* buffer_pool_manager);
+    SecondaryIndex(const std::string& name, int column, BufferPoolManager* buffer_pool_manager,
+                   page_id_t root_page_id);
+    ~SecondaryIndex() = default;
+
+    const std::string& GetName() const { return name_; }
+    int GetColumn() const { return column_; }
+    BTree* GetTree() { return &tree_; }
+
+    bool Insert(const Record& record, int primary_key, lsn_t lsn = INVALID_LSN);
+    bool Delete(const Record& record, int primary_key, lsn_t lsn = INVALID_LSN);
+
+    // Entries whose value may satisfy "column op value".
+    BTreeIterator Scan(CompareOp op, const Value& value);
+
+    static int PrimaryKeyOf(btree_key_t key);
+
+private:
+    std::string name_;
+    int column_;
+    BTree tree_;
+
+    static int32_t Prefix(const Value& value);
+    static btree_key_t MakeKey(int32_t prefix, int primary_key);
+};
\ No newline at end of file
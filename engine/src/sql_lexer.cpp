@@ -0,0 +1,218 @@
+#include "sql_lexer.h"
+#include <array>
+
+struct KeywordEntry {
+    std::string_view name;
+    Keyword keyword;
+};
+
+static constexpr KeywordEntry KEYWORDS[] = {
+    {"SELECT", Keyword::SELECT}, {"FROM", Keyword::FROM},     {"WHERE", Keyword::WHERE},
+    {"AND", Keyword::AND},       {"INSERT", Keyword::INSERT}, {"INTO", Keyword::INTO},
+    {"VALUES", Keyword::VALUES}, {"CREATE", Keyword::CREATE}, {"TABLE", Keyword::TABLE},
+    {"INDEX", Keyword::INDEX},   {"ON", Keyword::ON},         {"DELETE", Keyword::DELETE},
+    {"BETWEEN", Keyword::BETWEEN}, {"OR", Keyword::OR},   {"WITH", Keyword::WITH},
+    {"GROUP", Keyword::GROUP},   {"BY", Keyword::BY},     {"JOIN", Keyword::JOIN},
+    {"ORDER", Keyword::ORDER},   {"ASC", Keyword::ASC},   {"DESC", Keyword::DESC},
+    {"LIMIT", Keyword::LIMIT},   {"OFFSET", Keyword::OFFSET},
+};
+
+static constexpr size_t KEYWORD_COUNT = sizeof(KEYWORDS) / sizeof(KEYWORDS[0]);
+static constexpr size_t KEYWORD_TABLE_SIZE = 64;
+
+static constexpr size_t MaxKeywordLength() {
+    size_t length = 0;
+    for (const auto& entry : KEYWORDS) {
+        length = entry.name.size() > length ? entry.name.size() : length;
+    }
+    return length;
+}
+
+static constexpr size_t MAX_KEYWORD_LENGTH = MaxKeywordLength();
+
+static_assert(KEYWORD_TABLE_SIZE >= 2 * KEYWORD_COUNT, "keyword table is too dense");
+
+static constexpr char ToUpper(char c) {
+    return c >= 'a' && c <= 'z' ? static_cast<char>(c - 'a' + 'A') : c;
+}
+
+static constexpr size_t KeywordSlot(std::string_view word, uint32_t seed) {
+    uint32_t hash = seed;
+    for (char c : word) {
+        hash = (hash ^ static_cast<uint8_t>(ToUpper(c))) * 16777619u;
+    }
+    return (hash ^ (hash >> 15)) & (KEYWORD_TABLE_SIZE - 1);
+}
+
+// Smallest seed under which no two keywords share a slot.
+static constexpr uint32_t FindKeywordSeed() {
+    for (uint32_t seed = 1;; ++seed) {
+        bool used[KEYWORD_TABLE_SIZE] = {};
+        bool perfect = true;
+        for (const auto& entry : KEYWORDS) {
+            size_t slot = KeywordSlot(entry.name, seed);
+            if (used[slot]) {
+                perfect = false;
+                break;
+            }
+            used[slot] = true;
+        }
+        if (perfect) {
+            return seed;
+        }
+    }
+}
+
+static constexpr uint32_t KEYWORD_SEED = FindKeywordSeed();
+
+static constexpr std::array<uint8_t, KEYWORD_TABLE_SIZE> BuildKeywordTable() {
+    std::array<uint8_t, KEYWORD_TABLE_SIZE> table{};
+    for (size_t i = 0; i < KEYWORD_TABLE_SIZE; ++i) {
+        table[i] = 0xff;
+    }
+    for (size_t i = 0; i < KEYWORD_COUNT; ++i) {
+        table[KeywordSlot(KEYWORDS[i].name, KEYWORD_SEED)] = static_cast<uint8_t>(i);
+    }
+    return table;
+}
+
+static constexpr std::array<uint8_t, KEYWORD_TABLE_SIZE> KEYWORD_TABLE = BuildKeywordTable();
+
+static bool IsIdentifierStart(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+}
+
+static bool IsDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+static bool IsSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+}
+
+Keyword SQLLexer::LookupKeyword(std::string_view word) {
+    if (word.size() > MAX_KEYWORD_LENGTH) {
+        return Keyword::NONE;
+    }
+
+    uint8_t index = KEYWORD_TABLE[KeywordSlot(word, KEYWORD_SEED)];
+    if (index == 0xff || KEYWORDS[index].name.size() != word.size()) {
+        return Keyword::NONE;
+    }
+    for (size_t i = 0; i < word.size(); ++i) {
+        if (ToUpper(word[i]) != KEYWORDS[index].name[i]) {
+            return Keyword::NONE;
+        }
+    }
+    return KEYWORDS[index].keyword;
+}
+
+std::string_view SQLLexer::KeywordName(Keyword keyword) {
+    for (const auto& entry : KEYWORDS) {
+        if (entry.keyword == keyword) {
+            return entry.name;
+        }
+    }
+    return {};
+}
+
+Token SQLLexer::Next() {
+    while (position_ < sql_.size() && IsSpace(sql_[position_])) {
+        position_++;
+    }
+
+    Token token;
+    if (position_ >= sql_.size()) {
+        return token;
+    }
+
+    size_t start = position_;
+    char c = sql_[position_];
+
+    if (IsIdentifierStart(c)) {
+        // A qualified name, table.column, is a single identifier.
+        while (position_ < sql_.size() &&
+               (IsIdentifierStart(sql_[position_]) || IsDigit(sql_[position_]) ||
+                (sql_[position_] == '.' && position_ + 1 < sql_.size() && IsIdentifierStart(sql_[position_ + 1])))) {
+            position_++;
+        }
+        token.text = sql_.substr(start, position_ - start);
+        token.keyword = LookupKeyword(token.text);
+        token.type = token.keyword == Keyword::NONE ? TokenType::IDENTIFIER : TokenType::KEYWORD;
+        return token;
+    }
+
+    bool negative = c == '-' && position_ + 1 < sql_.size() &&
+                    (IsDigit(sql_[position_ + 1]) || sql_[position_ + 1] == '.');
+    if (IsDigit(c) || negative || (c == '.' && position_ + 1 < sql_.size() && IsDigit(sql_[position_ + 1]))) {
+        token.type = TokenType::INTEGER;
+        if (negative) {
+            position_++;
+        }
+        while (position_ < sql_.size() && (IsDigit(sql_[position_]) || sql_[position_] == '.')) {
+            if (sql_[position_] == '.') {
+                if (token.type == TokenType::FLOAT) {
+                    break;
+                }
+                token.type = TokenType::FLOAT;
+            }
+            position_++;
+        }
+        token.text = sql_.substr(start, position_ - start);
+        return token;
+    }
+
+    if (c == '\'') {
+        position_++;
+        while (position_ < sql_.size()) {
+            if (sql_[position_] == '\'') {
+                if (position_ + 1 < sql_.size() && sql_[position_ + 1] == '\'') {
+                    position_ += 2;
+                    continue;
+                }
+                token.type = TokenType::STRING;
+                token.text = sql_.substr(start + 1, position_ - start - 1);
+                position_++;
+                return token;
+            }
+            position_++;
+        }
+        token.type = TokenType::INVALID;
+        token.text = sql_.substr(start);
+        return token;
+    }
+
+    position_++;
+    token.type = TokenType::SYMBOL;
+    switch (c) {
+        case '?':
+            token.type = TokenType::PARAMETER;
+            break;
+        case '<':
+            if (position_ < sql_.size() && (sql_[position_] == '=' || sql_[position_] == '>')) {
+                position_++;
+            }
+            break;
+        case '>':
+        case '!':
+            if (position_ < sql_.size() && sql_[position_] == '=') {
+                position_++;
+            } else if (c == '!') {
+                token.type = TokenType::INVALID;
+            }
+            break;
+        case '(':
+        case ')':
+        case ',':
+        case ';':
+        case '*':
+        case '=':
+        case '.':
+            break;
+        default:
+            token.type = TokenType::INVALID;
+            break;
+    }
+    token.text = sql_.substr(start, position_ - start);
+    return token;
+}
\ No newline at end of file
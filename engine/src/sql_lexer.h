@@ -0,0 +1,68 @@
+#pragma once
+#include <cstdint>
+#include <string_view>
+
+enum class Keyword : uint8_t {
+    NONE,
+    SELECT,
+    FROM,
+    WHERE,
+    AND,
+    INSERT,
+    INTO,
+    VALUES,
+    CREATE,
+    TABLE,
+    INDEX,
+    ON,
+    DELETE,
+    BETWEEN,
+    OR,
+    WITH,
+    GROUP,
+    BY,
+    JOIN,
+    ORDER,
+    ASC,
+    DESC,
+    LIMIT,
+    OFFSET
+};
+
+enum class TokenType : uint8_t {
+    END,
+    IDENTIFIER,
+    KEYWORD,
+    INTEGER,
+    FLOAT,
+    STRING,     // text excludes the quotes; '' escapes are left doubled
+    PARAMETER,
+    SYMBOL,
+    INVALID
+};
+
+struct Token {
+    TokenType type{TokenType::END};
+    Keyword keyword{Keyword::NONE};
+    std::string_view text;
+
+    bool Is(Keyword k) const { return type == TokenType::KEYWORD && keyword == k; }
+    bool IsSymbol(std::string_view symbol) const { return type == TokenType::SYMBOL && text == symbol; }
+};
+
+// Single-pass lexer producing views into the SQL text, which must outlive
+// the tokens. Keywords are recognized case-insensitively through a perfect
+// hash built at compile time; nothing is allocated.
+class SQLLexer {
+public:
+    explicit SQLLexer(std::string_view sql) : sql_(sql) {}
+
+    Token Next();
+
+    static Keyword LookupKeyword(std::string_view word);
+    static std::string_view KeywordName(Keyword keyword);
+
+private:
+    std::string_view sql_;
+    size_t position_{0};
+};
\ No newline at end of file
@@ -1,201 +1,453 @@
 #include "sql_parser.h"
-#include <sstream>
-#include <algorithm>
 #include <cctype>
+#include <charconv>
+#include <cstring>
 
-std::unique_ptr<Query> SQLParser::Parse(const std::string& sql) {
-    auto tokens = Tokenize(sql);
-    if (tokens.empty()) {
+Query::Query(std::string_view sql) : arena(arena_buffer.data(), arena_buffer.size()) {
+    char* copy = static_cast<char*>(arena.allocate(sql.size() + 1, 1));
+    std::memcpy(copy, sql.data(), sql.size());
+    copy[sql.size()] = '\0';
+    text = std::string_view(copy, sql.size());
+}
+
+std::unique_ptr<Query> SQLParser::Parse(std::string_view sql) {
+    auto query = std::make_unique<Query>(sql);
+    ParseContext context(*query);
+    Advance(context);
+
+    bool parsed;
+    if (Accept(context, Keyword::SELECT)) {
+        parsed = ParseSelect(context);
+    } else if (Accept(context, Keyword::INSERT)) {
+        parsed = ParseInsert(context);
+    } else if (Accept(context, Keyword::DELETE)) {
+        parsed = ParseDelete(context);
+    } else if (Accept(context, Keyword::CREATE)) {
+        parsed = Accept(context, Keyword::INDEX) ? ParseCreateIndex(context) : ParseCreateTable(context);
+    } else {
         return nullptr;
     }
-    
-    std::string command = ToUpper(tokens[0]);
-    
-    if (command == "SELECT") {
-        return ParseSelect(tokens);
-    } else if (command == "INSERT") {
-        return ParseInsert(tokens);
-    } else if (command == "CREATE") {
-        return ParseCreateTable(tokens);
-    }
-    
-    return nullptr;
-}
-
-std::vector<std::string> SQLParser::Tokenize(const std::string& sql) {
-    std::vector<std::string> tokens;
-    std::istringstream iss(sql);
-    std::string token;
-    
-    while (iss >> token) {
-        if (token.back() == ',' || token.back() == ';') {
-            std::string main_token = token.substr(0, token.length() - 1);
-            if (!main_token.empty()) {
-                tokens.push_back(main_token);
-            }
-            tokens.push_back(std::string(1, token.back()));
-        } else if (token.front() == '(' || token.back() == ')') {
-            if (token.front() == '(') {
-                tokens.push_back("(");
-                token = token.substr(1);
-            }
-            if (token.back() == ')') {
-                std::string main_token = token.substr(0, token.length() - 1);
-                if (!main_token.empty()) {
-                    tokens.push_back(main_token);
-                }
-                tokens.push_back(")");
-            } else if (!token.empty()) {
-                tokens.push_back(token);
-            }
-        } else {
-            tokens.push_back(token);
-        }
+
+    AcceptSymbol(context, ";");
+    if (!parsed || context.current.type != TokenType::END) {
+        return nullptr;
     }
-    
-    return tokens;
+    return query;
 }
 
-std::unique_ptr<Query> SQLParser::ParseSelect(const std::vector<std::string>& tokens) {
-    auto query = std::make_unique<Query>();
-    query->type = QueryType::SELECT;
-    
-    size_t i = 1;
-    
-    while (i < tokens.size() && ToUpper(tokens[i]) != "FROM") {
-        if (tokens[i] != ",") {
-            query->columns.push_back(tokens[i]);
+std::string SQLParser::Normalize(std::string_view sql, std::vector<Value>* literals) {
+    SQLLexer lexer(sql);
+    Token token = lexer.Next();
+    if (literals && !token.Is(Keyword::SELECT) && !token.Is(Keyword::INSERT) && !token.Is(Keyword::DELETE)) {
+        literals = nullptr;
+    }
+
+    std::string normalized;
+    normalized.reserve(sql.size());
+    for (; token.type != TokenType::END; token = lexer.Next()) {
+        if (!normalized.empty()) {
+            normalized += ' ';
         }
-        i++;
-    }
-    
-    if (i < tokens.size() && ToUpper(tokens[i]) == "FROM") {
-        i++;
-        if (i < tokens.size()) {
-            query->table_name = tokens[i];
-            i++;
+
+        Value value;
+        bool literal = token.type == TokenType::INTEGER || token.type == TokenType::FLOAT ||
+                       token.type == TokenType::STRING;
+        if (literals && literal && LiteralValue(token, value)) {
+            literals->push_back(std::move(value));
+            normalized += '?';
+        } else if (token.type == TokenType::KEYWORD) {
+            normalized += SQLLexer::KeywordName(token.keyword);
+        } else if (token.type == TokenType::STRING) {
+            normalized += '\'';
+            normalized += token.text;
+            normalized += '\'';
+        } else {
+            normalized += token.text;
         }
     }
-    
-    if (i < tokens.size() && ToUpper(tokens[i]) == "WHERE") {
-        i++;
-        while (i + 2 < tokens.size()) {
-            Condition condition;
-            condition.column = tokens[i];
-            condition.op = tokens[i + 1];
-            condition.value = ParseValue(tokens[i + 2]);
-            query->conditions.push_back(condition);
-            
-            i += 3;
-            if (i < tokens.size() && ToUpper(tokens[i]) == "AND") {
-                i++;
-            } else {
-                break;
+    return normalized;
+}
+
+void SQLParser::Advance(ParseContext& context) {
+    context.current = context.lexer.Next();
+}
+
+bool SQLParser::Accept(ParseContext& context, Keyword keyword) {
+    if (!context.current.Is(keyword)) {
+        return false;
+    }
+    Advance(context);
+    return true;
+}
+
+bool SQLParser::AcceptSymbol(ParseContext& context, std::string_view symbol) {
+    if (!context.current.IsSymbol(symbol)) {
+        return false;
+    }
+    Advance(context);
+    return true;
+}
+
+bool SQLParser::ParseIdentifier(ParseContext& context, std::string_view& identifier) {
+    if (context.current.type != TokenType::IDENTIFIER) {
+        return false;
+    }
+    identifier = context.current.text;
+    Advance(context);
+    return true;
+}
+
+bool SQLParser::ParseValue(ParseContext& context, Value& value, Placeholder placeholder) {
+    if (context.current.type == TokenType::PARAMETER) {
+        context.query.placeholders.push_back(placeholder);
+        value = 0;
+        Advance(context);
+        return true;
+    }
+
+    if (!LiteralValue(context.current, value)) {
+        return false;
+    }
+    Advance(context);
+    return true;
+}
+
+// select := SELECT ('*' | item {',' item}) FROM ident [JOIN ident ON ident '=' ident] where
+//           [GROUP BY ident {',' ident}] [order] [limit]
+bool SQLParser::ParseSelect(ParseContext& context) {
+    Query& query = context.query;
+    query.type = QueryType::SELECT;
+
+    if (!AcceptSymbol(context, "*")) {
+        do {
+            if (!ParseSelectItem(context)) {
+                return false;
             }
+        } while (AcceptSymbol(context, ","));
+    }
+
+    if (!Accept(context, Keyword::FROM) || !ParseIdentifier(context, query.table_name)) {
+        return false;
+    }
+    if (Accept(context, Keyword::JOIN) &&
+        (!ParseIdentifier(context, query.join_table) || !Accept(context, Keyword::ON) ||
+         !ParseIdentifier(context, query.join_columns[0]) || !AcceptSymbol(context, "=") ||
+         !ParseIdentifier(context, query.join_columns[1]))) {
+        return false;
+    }
+    if (!ParseWhere(context)) {
+        return false;
+    }
+    if (Accept(context, Keyword::GROUP)) {
+        if (!Accept(context, Keyword::BY)) {
+            return false;
         }
+        do {
+            std::string_view column;
+            if (!ParseIdentifier(context, column)) {
+                return false;
+            }
+            query.group_by.push_back(column);
+        } while (AcceptSymbol(context, ","));
     }
-    
-    return query;
+    return ParseOrderBy(context) && ParseLimit(context);
+}
+
+bool SQLParser::ParseSelectItem(ParseContext& context) {
+    std::string_view column;
+    AggregateFunction function;
+    if (!ParseItem(context, column, function)) {
+        return false;
+    }
+    context.query.columns.push_back(column);
+    context.query.functions.push_back(function);
+    return true;
 }
 
-std::unique_ptr<Query> SQLParser::ParseInsert(const std::vector<std::string>& tokens) {
-    auto query = std::make_unique<Query>();
-    query->type = QueryType::INSERT;
-    
-    size_t i = 1;
-    if (i < tokens.size() && ToUpper(tokens[i]) == "INTO") {
-        i++;
-        if (i < tokens.size()) {
-            query->table_name = tokens[i];
-            i++;
+// order := [ORDER BY item [ASC | DESC] {',' item [ASC | DESC]}]
+bool SQLParser::ParseOrderBy(ParseContext& context) {
+    Query& query = context.query;
+    if (!Accept(context, Keyword::ORDER)) {
+        return true;
+    }
+    if (!Accept(context, Keyword::BY)) {
+        return false;
+    }
+    do {
+        std::string_view column;
+        AggregateFunction function;
+        if (!ParseItem(context, column, function)) {
+            return false;
+        }
+        query.order_by.push_back(column);
+        query.order_functions.push_back(function);
+        query.order_descending.push_back(Accept(context, Keyword::DESC));
+        if (!query.order_descending.back()) {
+            Accept(context, Keyword::ASC);
         }
+    } while (AcceptSymbol(context, ","));
+    return true;
+}
+
+// limit := [LIMIT value [OFFSET value]]
+bool SQLParser::ParseLimit(ParseContext& context) {
+    Query& query = context.query;
+    if (!Accept(context, Keyword::LIMIT)) {
+        return true;
     }
-    
-    if (i < tokens.size() && ToUpper(tokens[i]) == "VALUES") {
-        i++;
-        if (i < tokens.size() && tokens[i] == "(") {
-            i++;
-            while (i < tokens.size() && tokens[i] != ")") {
-                if (tokens[i] != ",") {
-                    query->values.push_back(ParseValue(tokens[i]));
-                }
-                i++;
+    query.has_limit = true;
+
+    Placeholder placeholder;
+    placeholder.limit = 0;
+    if (!ParseValue(context, query.limit, placeholder)) {
+        return false;
+    }
+    placeholder.limit = 1;
+    return !Accept(context, Keyword::OFFSET) || ParseValue(context, query.offset, placeholder);
+}
+
+// item := ident | function '(' ('*' | ident) ')'
+bool SQLParser::ParseItem(ParseContext& context, std::string_view& column, AggregateFunction& function) {
+    std::string_view name;
+    if (!ParseIdentifier(context, name)) {
+        return false;
+    }
+    if (!AcceptSymbol(context, "(")) {
+        column = name;
+        function = AggregateFunction::NONE;
+        return true;
+    }
+
+    column = "*";
+    if (!LookupAggregate(name, function)) {
+        return false;
+    }
+    if (!(function == AggregateFunction::COUNT && AcceptSymbol(context, "*")) && !ParseIdentifier(context, column)) {
+        return false;
+    }
+    return AcceptSymbol(context, ")");
+}
+
+// where := [WHERE cond {AND cond} {OR cond {AND cond}}]
+bool SQLParser::ParseWhere(ParseContext& context) {
+    if (!Accept(context, Keyword::WHERE)) {
+        return true;
+    }
+    do {
+        do {
+            if (!ParseCondition(context)) {
+                return false;
             }
-        }
+        } while (Accept(context, Keyword::AND));
+        context.group++;
+    } while (Accept(context, Keyword::OR));
+    return true;
+}
+
+// cond := ident op value | ident BETWEEN value AND value
+bool SQLParser::ParseCondition(ParseContext& context) {
+    std::string_view column;
+    if (!ParseIdentifier(context, column)) {
+        return false;
     }
-    
-    return query;
+
+    // BETWEEN is split into the two inclusive bounds it stands for.
+    if (Accept(context, Keyword::BETWEEN)) {
+        return ParseComparison(context, column, ">=") && Accept(context, Keyword::AND) &&
+               ParseComparison(context, column, "<=");
+    }
+
+    const Token& op = context.current;
+    if (!op.IsSymbol("=") && !op.IsSymbol("!=") && !op.IsSymbol("<>") && !op.IsSymbol("<") &&
+        !op.IsSymbol("<=") && !op.IsSymbol(">") && !op.IsSymbol(">=")) {
+        return false;
+    }
+    std::string_view op_text = op.IsSymbol("<>") ? "!=" : op.text;
+    Advance(context);
+    return ParseComparison(context, column, op_text);
+}
+
+bool SQLParser::ParseComparison(ParseContext& context, std::string_view column, std::string_view op) {
+    Condition condition;
+    condition.column = column;
+    condition.op = op;
+    condition.group = context.group;
+
+    Placeholder placeholder;
+    placeholder.condition = static_cast<int>(context.query.conditions.size());
+    if (!ParseValue(context, condition.value, placeholder)) {
+        return false;
+    }
+    context.query.conditions.push_back(std::move(condition));
+    return true;
 }
 
-std::unique_ptr<Query> SQLParser::ParseCreateTable(const std::vector<std::string>& tokens) {
-    auto query = std::make_unique<Query>();
-    query->type = QueryType::CREATE_TABLE;
-    
-    size_t i = 1;
-    if (i < tokens.size() && ToUpper(tokens[i]) == "TABLE") {
-        i++;
-        if (i < tokens.size()) {
-            query->table_name = tokens[i];
-            i++;
+// insert := INSERT INTO ident VALUES row {',' row}
+bool SQLParser::ParseInsert(ParseContext& context) {
+    Query& query = context.query;
+    query.type = QueryType::INSERT;
+
+    if (!Accept(context, Keyword::INTO) || !ParseIdentifier(context, query.table_name) ||
+        !Accept(context, Keyword::VALUES)) {
+        return false;
+    }
+
+    do {
+        if (!ParseRow(context)) {
+            return false;
         }
+    } while (AcceptSymbol(context, ","));
+    return true;
+}
+
+// row := '(' value {',' value} ')'
+bool SQLParser::ParseRow(ParseContext& context) {
+    Query& query = context.query;
+    if (!AcceptSymbol(context, "(")) {
+        return false;
     }
-    
-    if (i < tokens.size() && tokens[i] == "(") {
-        i++;
-        while (i + 1 < tokens.size() && tokens[i] != ")") {
-            if (tokens[i] != ",") {
-                Column col;
-                col.name = tokens[i];
-                col.type = tokens[i + 1];
-                query->table_columns.push_back(col);
-                i += 2;
-            } else {
-                i++;
-            }
+
+    auto& row = query.rows.emplace_back();
+    do {
+        Placeholder placeholder;
+        placeholder.row = static_cast<int>(query.rows.size() - 1);
+        placeholder.column = static_cast<int>(row.size());
+        Value value;
+        if (!ParseValue(context, value, placeholder)) {
+            return false;
         }
+        row.push_back(std::move(value));
+    } while (AcceptSymbol(context, ","));
+
+    return AcceptSymbol(context, ")");
+}
+
+// delete := DELETE FROM ident where
+bool SQLParser::ParseDelete(ParseContext& context) {
+    Query& query = context.query;
+    query.type = QueryType::DELETE;
+
+    if (!Accept(context, Keyword::FROM) || !ParseIdentifier(context, query.table_name)) {
+        return false;
     }
-    
-    return query;
+    return ParseWhere(context);
 }
 
-std::string SQLParser::ToUpper(const std::string& str) {
-    std::string result = str;
-    std::transform(result.begin(), result.end(), result.begin(), ::toupper);
-    return result;
-}
-
-bool SQLParser::IsNumber(const std::string& str) {
-    if (str.empty()) return false;
-    
-    size_t start = 0;
-    if (str[0] == '-' || str[0] == '+') start = 1;
-    if (start >= str.length()) return false;
-    
-    bool has_dot = false;
-    for (size_t i = start; i < str.length(); ++i) {
-        if (str[i] == '.') {
-            if (has_dot) return false;
-            has_dot = true;
-        } else if (!std::isdigit(str[i])) {
+// create := CREATE TABLE ident '(' ident type ['(' integer ')'] {',' ...} ')'
+//           [WITH '(' storage '=' ident ')']
+bool SQLParser::ParseCreateTable(ParseContext& context) {
+    Query& query = context.query;
+    query.type = QueryType::CREATE_TABLE;
+
+    if (!Accept(context, Keyword::TABLE) || !ParseIdentifier(context, query.table_name) ||
+        !AcceptSymbol(context, "(")) {
+        return false;
+    }
+
+    do {
+        ColumnDefinition column;
+        if (!ParseIdentifier(context, column.name) || !ParseIdentifier(context, column.type)) {
             return false;
         }
+        if (AcceptSymbol(context, "(")) {
+            if (context.current.type != TokenType::INTEGER) {
+                return false;
+            }
+            Advance(context);
+            if (!AcceptSymbol(context, ")")) {
+                return false;
+            }
+        }
+        query.table_columns.push_back(column);
+    } while (AcceptSymbol(context, ","));
+
+    if (!AcceptSymbol(context, ")")) {
+        return false;
     }
-    
-    return true;
+    if (!Accept(context, Keyword::WITH)) {
+        return true;
+    }
+
+    std::string_view option;
+    if (!AcceptSymbol(context, "(") || !ParseIdentifier(context, option) || option != "storage" ||
+        !AcceptSymbol(context, "=") || !ParseIdentifier(context, query.storage)) {
+        return false;
+    }
+    return AcceptSymbol(context, ")");
 }
 
-Value SQLParser::ParseValue(const std::string& str) {
-    if (IsNumber(str)) {
-        if (str.find('.') != std::string::npos) {
-            return std::stod(str);
-        } else {
-            return std::stoi(str);
+// index := CREATE INDEX ident ON ident '(' ident ')'
+bool SQLParser::ParseCreateIndex(ParseContext& context) {
+    Query& query = context.query;
+    query.type = QueryType::CREATE_INDEX;
+
+    std::string_view column;
+    if (!ParseIdentifier(context, query.index_name) || !Accept(context, Keyword::ON) ||
+        !ParseIdentifier(context, query.table_name) || !AcceptSymbol(context, "(") ||
+        !ParseIdentifier(context, column)) {
+        return false;
+    }
+    query.columns.push_back(column);
+    return AcceptSymbol(context, ")");
+}
+
+bool SQLParser::LiteralValue(const Token& token, Value& value) {
+    const char* begin = token.text.data();
+    const char* end = begin + token.text.size();
+
+    switch (token.type) {
+        case TokenType::INTEGER: {
+            int number;
+            auto result = std::from_chars(begin, end, number);
+            if (result.ec != std::errc() || result.ptr != end) {
+                return false;
+            }
+            value = number;
+            return true;
+        }
+        case TokenType::FLOAT: {
+            double number;
+            auto result = std::from_chars(begin, end, number);
+            if (result.ec != std::errc() || result.ptr != end) {
+                return false;
+            }
+            value = number;
+            return true;
+        }
+        case TokenType::STRING: {
+            std::string text;
+            text.reserve(token.text.size());
+            for (size_t i = 0; i < token.text.size(); ++i) {
+                text += token.text[i];
+                if (token.text[i] == '\'') {
+                    i++;
+                }
+            }
+            value = std::move(text);
+            return true;
         }
+        default:
+            return false;
     }
-    
-    if (str.length() >= 2 && str.front() == '\'' && str.back() == '\'') {
-        return str.substr(1, str.length() - 2);
+}
+
+bool SQLParser::LookupAggregate(std::string_view name, AggregateFunction& function) {
+    static constexpr std::pair<std::string_view, AggregateFunction> FUNCTIONS[] = {
+        {"COUNT", AggregateFunction::COUNT}, {"SUM", AggregateFunction::SUM}, {"AVG", AggregateFunction::AVG},
+        {"MIN", AggregateFunction::MIN},     {"MAX", AggregateFunction::MAX},
+    };
+    for (const auto& entry : FUNCTIONS) {
+        if (entry.first.size() != name.size()) {
+            continue;
+        }
+        bool match = true;
+        for (size_t i = 0; i < name.size() && match; ++i) {
+            match = std::toupper(static_cast<unsigned char>(name[i])) == entry.first[i];
+        }
+        if (match) {
+            function = entry.second;
+            return true;
+        }
     }
-    
-    return str;
+    return false;
 }
\ No newline at end of file
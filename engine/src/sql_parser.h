@@ -1,51 +1,139 @@
 #pragma once
 #include "record.h"
+#include "sql_lexer.h"
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
 #include <string>
+#include <string_view>
 #include <vector>
-#include <memory>
 
 enum class QueryType {
     SELECT,
     INSERT,
     DELETE,
     CREATE_TABLE,
+    CREATE_INDEX,
     UNKNOWN
 };
 
+enum class AggregateFunction {
+    NONE,
+    COUNT,
+    SUM,
+    AVG,
+    MIN,
+    MAX
+};
+
 struct Column {
     std::string name;
     std::string type;
 };
 
+struct ColumnDefinition {
+    std::string_view name;
+    std::string_view type;
+};
+
+// WHERE clauses are kept in disjunctive normal form: conditions sharing a
+// group are ANDed, and the groups are ORed.
 struct Condition {
-    std::string column;
-    std::string op;
+    std::string_view column;
+    std::string_view op;
     Value value;
+    int group{0};
+};
+
+// Position of a '?' placeholder: the value of a WHERE condition, a value in
+// one of the rows of an INSERT, or the LIMIT or OFFSET of a SELECT.
+struct Placeholder {
+    int condition{-1};
+    int row{-1};
+    int column{-1};
+    int limit{-1};  // 0 for the LIMIT count, 1 for the OFFSET
 };
 
+// Parsed statement. Names are views into a copy of the SQL text, and every
+// container draws from an arena owned by the query, so a short statement is
+// parsed without touching the heap beyond the Query itself.
 struct Query {
+    static constexpr size_t INLINE_ARENA_SIZE = 1024;
+
+    explicit Query(std::string_view sql);
+    Query(const Query&) = delete;
+    Query& operator=(const Query&) = delete;
+
+    std::array<std::byte, INLINE_ARENA_SIZE> arena_buffer;
+    std::pmr::monotonic_buffer_resource arena;
+
+    std::string_view text;
     QueryType type{QueryType::UNKNOWN};
-    std::string table_name;
-    std::vector<std::string> columns;
-    std::vector<Value> values;
-    std::vector<Condition> conditions;
-    std::vector<Column> table_columns;
+    std::string_view table_name;
+    std::string_view join_table;  // FROM table_name JOIN join_table
+    std::array<std::string_view, 2> join_columns;  // the two sides of its ON condition
+    std::string_view index_name;
+    std::string_view storage;  // CREATE TABLE ... WITH (storage = ...), empty by default
+    std::pmr::vector<std::string_view> columns{&arena};  // SELECT list, or the indexed column
+    std::pmr::vector<AggregateFunction> functions{&arena};  // per SELECT list entry; COUNT(*) has column "*"
+    std::pmr::vector<std::string_view> group_by{&arena};
+    std::pmr::vector<std::string_view> order_by{&arena};
+    std::pmr::vector<AggregateFunction> order_functions{&arena};
+    std::pmr::vector<bool> order_descending = std::pmr::vector<bool>(&arena);  // not {}: that would hold a bool
+    bool has_limit{false};
+    Value limit{0};
+    Value offset{0};
+    std::pmr::vector<std::pmr::vector<Value>> rows{&arena};
+    std::pmr::vector<Condition> conditions{&arena};
+    std::pmr::vector<ColumnDefinition> table_columns{&arena};
+    std::pmr::vector<Placeholder> placeholders{&arena};
 };
 
+// Recursive-descent parser over SQLLexer tokens. The parser holds no state of
+// its own and may be shared between threads.
 class SQLParser {
 public:
     SQLParser() = default;
     ~SQLParser() = default;
 
-    std::unique_ptr<Query> Parse(const std::string& sql);
+    std::unique_ptr<Query> Parse(std::string_view sql);
+
+    // Canonical text of a statement: single-spaced tokens with upper-case
+    // keywords. When literals is given, the literals of a SELECT, INSERT or
+    // DELETE are replaced by '?' and returned in order.
+    std::string Normalize(std::string_view sql, std::vector<Value>* literals);
 
 private:
-    std::vector<std::string> Tokenize(const std::string& sql);
-    std::string ToUpper(const std::string& str);
-    bool IsNumber(const std::string& str);
-    Value ParseValue(const std::string& str);
-    
-    std::unique_ptr<Query> ParseSelect(const std::vector<std::string>& tokens);
-    std::unique_ptr<Query> ParseInsert(const std::vector<std::string>& tokens);
-    std::unique_ptr<Query> ParseCreateTable(const std::vector<std::string>& tokens);
+    struct ParseContext {
+        explicit ParseContext(Query& query) : lexer(query.text), query(query) {}
+
+        SQLLexer lexer;
+        Token current;
+        Query& query;
+        int group{0};
+    };
+
+    void Advance(ParseContext& context);
+    bool Accept(ParseContext& context, Keyword keyword);
+    bool AcceptSymbol(ParseContext& context, std::string_view symbol);
+    bool ParseIdentifier(ParseContext& context, std::string_view& identifier);
+    bool ParseValue(ParseContext& context, Value& value, Placeholder placeholder);
+
+    bool ParseSelect(ParseContext& context);
+    bool ParseSelectItem(ParseContext& context);
+    bool ParseOrderBy(ParseContext& context);
+    bool ParseLimit(ParseContext& context);
+    bool ParseItem(ParseContext& context, std::string_view& column, AggregateFunction& function);
+    bool ParseWhere(ParseContext& context);
+    bool ParseCondition(ParseContext& context);
+    bool ParseComparison(ParseContext& context, std::string_view column, std::string_view op);
+    bool ParseInsert(ParseContext& context);
+    bool ParseRow(ParseContext& context);
+    bool ParseDelete(ParseContext& context);
+    bool ParseCreateTable(ParseContext& context);
+    bool ParseCreateIndex(ParseContext& context);
+
+    static bool LiteralValue(const Token& token, Value& value);
+    static bool LookupAggregate(std::string_view name, AggregateFunction& function);
 };
\ No newline at end of file
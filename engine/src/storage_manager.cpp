@@ -1,63 +1,92 @@
 #include "storage_manager.h"
+#include "posix_storage_manager.h"
+#include "mmap_storage_manager.h"
+#include "compressed_storage_manager.h"
+#include <algorithm>
 #include <iostream>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
-StorageManager::StorageManager(const std::string& db_file) : db_file_(db_file) {
-    if (!OpenFile()) {
-        std::cerr << "Failed to open database file: " << db_file_ << std::endl;
-    }
-}
+StorageManager::StorageManager(const std::string& db_file) : db_file_(db_file) {}
 
 StorageManager::~StorageManager() {
-    CloseFile();
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
 }
 
-bool StorageManager::OpenFile() {
-    file_stream_.open(db_file_, std::ios::in | std::ios::out | std::ios::binary);
-    
-    if (!file_stream_.is_open()) {
-        file_stream_.clear();
-        file_stream_.open(db_file_, std::ios::out | std::ios::binary);
-        file_stream_.close();
-        file_stream_.open(db_file_, std::ios::in | std::ios::out | std::ios::binary);
+std::unique_ptr<StorageManager> StorageManager::Open(const std::string& db_file, StorageBackend backend) {
+    std::unique_ptr<StorageManager> storage_manager;
+    switch (backend) {
+        case StorageBackend::MMAP:
+            storage_manager = std::make_unique<MmapStorageManager>(db_file);
+            break;
+        case StorageBackend::COMPRESSED:
+            storage_manager = std::make_unique<CompressedStorageManager>(db_file);
+            break;
+        case StorageBackend::DIRECT_IO:
+            storage_manager = std::make_unique<PosixStorageManager>(db_file, true);
+            break;
+        case StorageBackend::PREAD:
+        default:
+            storage_manager = std::make_unique<PosixStorageManager>(db_file, false);
+            break;
     }
-    
-    if (file_stream_.is_open()) {
-        file_stream_.seekg(0, std::ios::end);
-        auto file_size = file_stream_.tellg();
-        next_page_id_ = static_cast<page_id_t>(file_size / PAGE_SIZE);
-        return true;
+
+    if (storage_manager->fd_ < 0) {
+        std::cerr << "Failed to open database file: " << db_file << std::endl;
     }
-    
-    return false;
+    return storage_manager;
 }
 
-void StorageManager::CloseFile() {
-    if (file_stream_.is_open()) {
-        file_stream_.close();
+bool StorageManager::OpenFile(int extra_flags) {
+    fd_ = ::open(db_file_.c_str(), O_RDWR | O_CREAT | extra_flags, 0644);
+    if (fd_ < 0) {
+        return false;
+    }
+
+    struct stat file_stat;
+    if (::fstat(fd_, &file_stat) != 0) {
+        return false;
     }
+    next_page_id_ = static_cast<page_id_t>(file_stat.st_size / PAGE_SIZE);
+    return true;
 }
 
-std::unique_ptr<Page> StorageManager::ReadPage(page_id_t page_id) {
-    auto page = std::make_unique<Page>(page_id);
-    
-    file_stream_.seekg(page_id * PAGE_SIZE, std::ios::beg);
-    file_stream_.read(page->GetData(), PAGE_SIZE);
-    
-    if (file_stream_.gcount() != PAGE_SIZE) {
-        std::cerr << "Warning: Read less than expected page size" << std::endl;
+page_id_t StorageManager::AllocatePage() {
+    // The file is extended ahead of the page ids handed out, and the new
+    // size synced, so that a page id handed out before a crash is never
+    // handed out again after recovery.
+    page_id_t page_id = next_page_id_.fetch_add(1);
+    off_t required_size = static_cast<off_t>(page_id + 1) * PAGE_SIZE;
+
+    // Concurrent allocations must not interleave their size check and
+    // truncate: a late ftruncate to a smaller size would cut off a page
+    // another thread has already allocated and written.
+    std::lock_guard<std::mutex> guard(extend_latch_);
+    struct stat file_stat;
+    if (::fstat(fd_, &file_stat) == 0 && file_stat.st_size < required_size) {
+        // Extensions grow with the file, to keep the syncs of a large load few.
+        off_t extension_size = std::max<off_t>(EXTEND_PAGES, file_stat.st_size / PAGE_SIZE / 8) * PAGE_SIZE;
+        off_t new_size = std::max(required_size, file_stat.st_size + extension_size);
+        if (::ftruncate(fd_, new_size) != 0 || ::fdatasync(fd_) != 0) {
+            std::cerr << "Failed to extend database file: " << db_file_ << std::endl;
+        } else {
+            extended_size_ = new_size;
+        }
     }
-    
-    return page;
+    return page_id;
 }
 
-bool StorageManager::WritePage(const Page& page) {
-    file_stream_.seekp(page.GetPageId() * PAGE_SIZE, std::ios::beg);
-    file_stream_.write(page.GetData(), PAGE_SIZE);
-    file_stream_.flush();
-    
-    return file_stream_.good();
+void StorageManager::TrimFile() {
+    std::lock_guard<std::mutex> guard(extend_latch_);
+    off_t used_size = static_cast<off_t>(GetPageCount()) * PAGE_SIZE;
+    if (fd_ >= 0 && extended_size_ > used_size && ::ftruncate(fd_, used_size) != 0) {
+        std::cerr << "Failed to trim database file: " << db_file_ << std::endl;
+    }
 }
 
-page_id_t StorageManager::AllocatePage() {
-    return next_page_id_++;
+bool StorageManager::Sync() {
+    return fd_ >= 0 && ::fdatasync(fd_) == 0;
 }
\ No newline at end of file
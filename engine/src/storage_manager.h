@@ -1,23 +1,69 @@
 #pragma once
 #include "page.h"
-#include <fstream>
 #include <string>
 #include <memory>
+#include <atomic>
+#include <mutex>
+#include <sys/types.h>
+
+enum class StorageBackend {
+    PREAD,       // positional pread/pwrite through the OS page cache
+    DIRECT_IO,   // pread/pwrite with O_DIRECT, bypassing the OS page cache
+    MMAP,        // read-mostly shared mapping of the database file
+    COMPRESSED   // LZ4-compressed pages in variable-size extents of the file
+};
+
+// Counted by backends that transform pages on their way to disk.
+struct StorageStats {
+    uint64_t pages_read{0};
+    uint64_t pages_written{0};
+    uint64_t stored_bytes{0};  // on disk, for the pages written
+    uint64_t compress_ns{0};
+    uint64_t decompress_ns{0};
+
+    double CompressionRatio() const {
+        return stored_bytes == 0 ? 1.0 : static_cast<double>(pages_written * PAGE_SIZE) / stored_bytes;
+    }
+    double CompressMicrosPerPage() const { return pages_written == 0 ? 0 : compress_ns / 1e3 / pages_written; }
+    double DecompressMicrosPerPage() const { return pages_read == 0 ? 0 : decompress_ns / 1e3 / pages_read; }
+};
 
 class StorageManager {
 public:
-    explicit StorageManager(const std::string& db_file);
-    ~StorageManager();
+    // The file grows by at least this many pages at a time, each extension
+    // made durable before any page in it is handed out.
+    static constexpr size_t EXTEND_PAGES = 16;
+
+    virtual ~StorageManager();
+
+    static std::unique_ptr<StorageManager> Open(const std::string& db_file,
+                                                StorageBackend backend = StorageBackend::PREAD);
 
-    std::unique_ptr<Page> ReadPage(page_id_t page_id);
-    bool WritePage(const Page& page);
-    page_id_t AllocatePage();
+    // Buffers passed to ReadPage/WritePage are PAGE_SIZE bytes and
+    // PAGE_SIZE-aligned. All calls are safe to issue concurrently.
+    virtual bool ReadPage(page_id_t page_id, char* data) = 0;
+    virtual bool WritePage(page_id_t page_id, const char* data) = 0;
+    virtual page_id_t AllocatePage();
+    virtual bool Sync();
+    virtual StorageStats GetStats() const { return StorageStats(); }
+
+    // Whether page i is stored as is at offset i * PAGE_SIZE of the file, so
+    // it can be read from the file descriptor directly.
+    virtual bool StoresPagesInPlace() const { return true; }
+
+    page_id_t GetPageCount() const { return next_page_id_.load(); }
+    int GetFileDescriptor() const { return fd_; }
+
+protected:
+    explicit StorageManager(const std::string& db_file);
 
-private:
     std::string db_file_;
-    std::fstream file_stream_;
-    page_id_t next_page_id_{0};
-    
-    bool OpenFile();
-    void CloseFile();
+    int fd_{-1};
+    std::atomic<page_id_t> next_page_id_{0};
+    std::mutex extend_latch_;
+    off_t extended_size_{0};  // file size after the last extension, if any
+
+    bool OpenFile(int extra_flags);
+    // Cuts the file back to the pages handed out, on a clean close.
+    void TrimFile();
 };
\ No newline at end of file
@@ -0,0 +1,58 @@
+#include "thread_pool_async_io.h"
+
+ThreadPoolAsyncIO::ThreadPoolAsyncIO(StorageManager* storage_manager, size_t thread_count)
+    : storage_manager_(storage_manager) {
+    for (size_t i = 0; i < thread_count; ++i) {
+        workers_.emplace_back(&ThreadPoolAsyncIO::WorkerLoop, this);
+    }
+}
+
+ThreadPoolAsyncIO::~ThreadPoolAsyncIO() {
+    Submit();
+    {
+        std::lock_guard<std::mutex> guard(latch_);
+        stop_ = true;
+    }
+    queue_cv_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+void ThreadPoolAsyncIO::ReadPage(page_id_t page_id, char* data, Callback callback) {
+    std::lock_guard<std::mutex> guard(latch_);
+    pending_.push_back(Request{page_id, data, std::move(callback)});
+}
+
+void ThreadPoolAsyncIO::Submit() {
+    {
+        std::lock_guard<std::mutex> guard(latch_);
+        if (pending_.empty()) {
+            return;
+        }
+        for (auto& request : pending_) {
+            queue_.push_back(std::move(request));
+        }
+        pending_.clear();
+    }
+    queue_cv_.notify_all();
+}
+
+void ThreadPoolAsyncIO::WorkerLoop() {
+    std::unique_lock<std::mutex> lock(latch_);
+    while (true) {
+        queue_cv_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+        if (queue_.empty()) {
+            return;
+        }
+
+        Request request = std::move(queue_.front());
+        queue_.pop_front();
+        lock.unlock();
+
+        bool success = storage_manager_->ReadPage(request.page_id, request.data);
+        request.callback(success);
+
+        lock.lock();
+    }
+}
\ No newline at end of file
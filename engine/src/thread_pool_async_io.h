@@ -0,0 +1,35 @@
+#pragma once
+#include "async_io.h"
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPoolAsyncIO : public AsyncIO {
+public:
+    static constexpr size_t DEFAULT_THREAD_COUNT = 4;
+
+    explicit ThreadPoolAsyncIO(StorageManager* storage_manager, size_t thread_count = DEFAULT_THREAD_COUNT);
+    ~ThreadPoolAsyncIO() override;
+
+    void ReadPage(page_id_t page_id, char* data, Callback callback) override;
+    void Submit() override;
+
+private:
+    struct Request {
+        page_id_t page_id;
+        char* data;
+        Callback callback;
+    };
+
+    StorageManager* storage_manager_;
+    std::mutex latch_;
+    std::condition_variable queue_cv_;
+    std::deque<Request> pending_;
+    std::deque<Request> queue_;
+    bool stop_{false};
+    std::vector<std::thread> workers_;
+
+    void WorkerLoop();
+};
\ No newline at end of file
@@ -0,0 +1,37 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// LEB128 varints: seven bits per byte, low bits first, with the high bit set
+// on every byte but the last.
+inline size_t VarintSize(uint64_t value) {
+    size_t size = 1;
+    while (value >= 0x80) {
+        value >>= 7;
+        size++;
+    }
+    return size;
+}
+
+inline size_t EncodeVarint(uint64_t value, char* data) {
+    size_t size = 0;
+    while (value >= 0x80) {
+        data[size++] = static_cast<char>((value & 0x7f) | 0x80);
+        value >>= 7;
+    }
+    data[size++] = static_cast<char>(value);
+    return size;
+}
+
+inline size_t DecodeVarint(const char* data, uint64_t& value) {
+    value = 0;
+    size_t size = 0;
+    int shift = 0;
+    uint8_t byte;
+    do {
+        byte = static_cast<uint8_t>(data[size++]);
+        value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        shift += 7;
+    } while (byte & 0x80);
+    return size;
+}
\ No newline at end of file
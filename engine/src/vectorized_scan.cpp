@@ -0,0 +1,47 @@
+#include "vectorized_scan.h"
+#include <algorithm>
+
+VectorizedScan::VectorizedScan(BTreeIterator iterator, std::vector<BatchFilter> filters, std::vector<bool> columns)
+    : iterator_(std::move(iterator)), filters_(std::move(filters)), columns_(std::move(columns)) {
+    for (const auto& filter : filters_) {
+        columns_[filter.column] = true;
+    }
+}
+
+bool VectorizedScan::NextBatch(ColumnBatch& batch) {
+    batch.Clear();
+    while (!iterator_.IsEnd() && !batch.IsFull()) {
+        LeafNodeView leaf = iterator_.GetLeaf();
+        if (leaf.IsColumnar()) {
+            size_t count = std::min<size_t>(iterator_.GetRunLength(), BATCH_SIZE - batch.GetSize());
+            batch.AppendLeaf(leaf, iterator_.GetIndex(), count, columns_, iterator_.GetBufferPoolManager());
+            iterator_.Advance(static_cast<int>(count));
+        } else {
+            batch.AppendSerialized(iterator_.GetRecordData(), iterator_.GetRowFormat(), columns_,
+                                   iterator_.GetBufferPoolManager());
+            iterator_.Next();
+        }
+    }
+    if (batch.GetSize() == 0) {
+        return false;
+    }
+
+    uint16_t* selection = batch.GetSelection();
+    size_t selected = batch.GetSize();
+    bool dense = true;
+    for (const auto& filter : filters_) {
+        if (selected == 0) {
+            break;
+        }
+        selected = FilterKernels::Filter(batch.GetColumn(filter.column), filter.op, filter.constant, dense,
+                                         selected, selection);
+        dense = false;
+    }
+    if (dense) {
+        for (size_t row = 0; row < selected; ++row) {
+            selection[row] = static_cast<uint16_t>(row);
+        }
+    }
+    batch.SetSelectedCount(selected);
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,32 @@
+#pragma once
+#include "btree_iterator.h"
+#include "column_batch.h"
+#include "filter_kernels.h"
+#include <vector>
+
+struct BatchFilter {
+    int column;
+    CompareOp op;
+    Value constant;
+};
+
+// Table scan that decodes leaves straight into column batches and applies
+// its filters with the batch kernels, one column at a time, instead of
+// evaluating each condition row by row. PAX leaves are copied a minipage at a
+// time, and only for the columns the scan reads.
+class VectorizedScan {
+public:
+    // columns marks the columns the caller reads from the batches; the filter
+    // columns are read as well.
+    VectorizedScan(BTreeIterator iterator, std::vector<BatchFilter> filters, std::vector<bool> columns);
+    ~VectorizedScan() = default;
+
+    // Refills batch with the next rows of the scan and selects the rows that
+    // pass every filter, possibly none. Returns false once the scan is done.
+    bool NextBatch(ColumnBatch& batch);
+
+private:
+    BTreeIterator iterator_;
+    std::vector<BatchFilter> filters_;
+    std::vector<bool> columns_;
+};
\ No newline at end of file
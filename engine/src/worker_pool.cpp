@@ -0,0 +1,93 @@
+#include "worker_pool.h"
+#include <algorithm>
+
+WorkerPool::WorkerPool(size_t thread_count) {
+    thread_count = std::max<size_t>(1, thread_count);
+    for (size_t i = 0; i < thread_count; ++i) {
+        queues_.emplace_back(std::make_unique<Queue>());
+    }
+    for (size_t i = 0; i < thread_count; ++i) {
+        threads_.emplace_back(&WorkerPool::WorkerLoop, this, i);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> guard(latch_);
+        stop_ = true;
+    }
+    work_cv_.notify_all();
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+}
+
+void WorkerPool::Run(size_t task_count, const std::function<void(size_t worker, size_t task)>& task) {
+    std::lock_guard<std::mutex> run_guard(run_latch_);
+    size_t worker_count = threads_.size();
+    for (size_t worker = 0; worker < worker_count; ++worker) {
+        std::lock_guard<std::mutex> guard(queues_[worker]->latch);
+        for (size_t i = worker * task_count / worker_count; i < (worker + 1) * task_count / worker_count; ++i) {
+            queues_[worker]->tasks.push_back(i);
+        }
+    }
+
+    std::unique_lock<std::mutex> lock(latch_);
+    task_ = &task;
+    busy_workers_ = worker_count;
+    generation_++;
+    work_cv_.notify_all();
+    // Every worker has to check in, not only every task finish, so that none
+    // is still looking at the queues when the next batch is handed out.
+    done_cv_.wait(lock, [this] { return busy_workers_ == 0; });
+    task_ = nullptr;
+}
+
+void WorkerPool::WorkerLoop(size_t worker) {
+    uint64_t seen = 0;
+    while (true) {
+        const std::function<void(size_t, size_t)>* task;
+        {
+            std::unique_lock<std::mutex> lock(latch_);
+            work_cv_.wait(lock, [this, seen] { return stop_ || generation_ != seen; });
+            if (stop_) {
+                return;
+            }
+            seen = generation_;
+            task = task_;
+        }
+
+        size_t index;
+        while (NextTask(worker, index)) {
+            (*task)(worker, index);
+        }
+
+        std::lock_guard<std::mutex> guard(latch_);
+        if (--busy_workers_ == 0) {
+            done_cv_.notify_all();
+        }
+    }
+}
+
+bool WorkerPool::NextTask(size_t worker, size_t& task) {
+    {
+        Queue& own = *queues_[worker];
+        std::lock_guard<std::mutex> guard(own.latch);
+        if (!own.tasks.empty()) {
+            task = own.tasks.front();
+            own.tasks.pop_front();
+            return true;
+        }
+    }
+
+    for (size_t i = 1; i < queues_.size(); ++i) {
+        Queue& victim = *queues_[(worker + i) % queues_.size()];
+        std::lock_guard<std::mutex> guard(victim.latch);
+        if (!victim.tasks.empty()) {
+            task = victim.tasks.back();
+            victim.tasks.pop_back();
+            return true;
+        }
+    }
+    return false;
+}
\ No newline at end of file
@@ -0,0 +1,47 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of threads that run batches of tasks to completion. Each worker
+// starts on its own contiguous share of a batch and, once that is drained,
+// steals from the far end of the other workers' shares, so that neighbouring
+// tasks tend to run on the same thread.
+class WorkerPool {
+public:
+    explicit WorkerPool(size_t thread_count);
+    ~WorkerPool();
+
+    size_t GetThreadCount() const { return threads_.size(); }
+
+    // Runs task(worker, index) for every index in [0, task_count) and returns
+    // once all of them have finished. Concurrent calls run one after another.
+    void Run(size_t task_count, const std::function<void(size_t worker, size_t task)>& task);
+
+private:
+    struct Queue {
+        std::mutex latch;
+        std::deque<size_t> tasks;
+    };
+
+    std::vector<std::thread> threads_;
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::mutex run_latch_;
+
+    std::mutex latch_;
+    std::condition_variable work_cv_;
+    std::condition_variable done_cv_;
+    const std::function<void(size_t, size_t)>* task_{nullptr};
+    uint64_t generation_{0};
+    size_t busy_workers_{0};
+    bool stop_{false};
+
+    void WorkerLoop(size_t worker);
+    bool NextTask(size_t worker, size_t& task);
+};
\ No newline at end of file
@@ -0,0 +1,139 @@
+#include "test.h"
+#include "database.h"
+#include <algorithm>
+#include <map>
+#include <random>
+
+struct AggregateRow {
+    int id;
+    int k;
+    double v;
+    std::string s;
+};
+
+static std::vector<AggregateRow> MakeAggregateRows() {
+    std::mt19937 rng(7);
+    std::vector<AggregateRow> rows;
+    for (int id = 0; id < 20000; id += 1 + rng() % 2) {
+        rows.push_back({id, static_cast<int>(rng() % 50), (rng() % 1000) / 4.0, "s" + std::to_string(rng() % 3000)});
+    }
+    return rows;
+}
+
+static std::vector<std::string> RunQueries(const std::string& file, size_t scan_threads, size_t memory_bytes,
+                                           const std::vector<std::string>& queries) {
+    DatabaseOptions options;
+    options.scan_threads = scan_threads;
+    options.aggregate_memory_bytes = memory_bytes;
+    Database db(file, options);
+    std::vector<std::string> results;
+    for (const std::string& query : queries) {
+        CHECK(db.ExecuteQuery(query));
+        std::string result;
+        for (const Record& record : db.GetLastResults()) {
+            result += record.ToString() + "\n";
+        }
+        results.push_back(result);
+    }
+    return results;
+}
+
+// Groups are compared with those computed from the loaded rows, with the
+// groups held in memory and with a budget small enough to spill them, on one
+// scan thread and on several, for both table layouts.
+TEST(AggregateGroupBySpilled) {
+    TestFile file("aggregate_test.db");
+    std::vector<AggregateRow> rows = MakeAggregateRows();
+    {
+        Database db(file.GetName());
+        CHECK(db.ExecuteQuery("CREATE TABLE r (id INT, k INT, v DOUBLE, s VARCHAR)"));
+        CHECK(db.ExecuteQuery("CREATE TABLE c (id INT, k INT, v DOUBLE, s VARCHAR) WITH (storage = columnar)"));
+        for (const char* table : {"r", "c"}) {
+            size_t next = 0;
+            CHECK(db.BulkLoad(table, [&](Record& record) {
+                if (next == rows.size()) {
+                    return false;
+                }
+                const AggregateRow& row = rows[next++];
+                record = Record({row.id, row.k, row.v, row.s});
+                return true;
+            }));
+        }
+    }
+
+    struct ByK {
+        int count{0};
+        int sum{0};
+        std::string min;
+        double max{0};
+    };
+    struct ByS {
+        int count{0};
+        double sum{0};
+    };
+    std::map<int, ByK> by_k;
+    std::map<std::string, ByS> by_s;
+    for (const AggregateRow& row : rows) {
+        ByK& k = by_k[row.k];
+        k.min = k.count == 0 ? row.s : std::min(k.min, row.s);
+        k.max = k.count == 0 ? row.v : std::max(k.max, row.v);
+        k.count++;
+        k.sum += row.id;
+        ByS& s = by_s[row.s];
+        s.count++;
+        s.sum += row.v;
+    }
+    std::string expected_by_k;
+    for (const auto& [key, group] : by_k) {
+        expected_by_k += Record({key, group.count, group.sum, group.min, group.max}).ToString() + "\n";
+    }
+    std::string expected_by_s;
+    for (const auto& [key, group] : by_s) {
+        expected_by_s += Record({key, group.count, group.sum / group.count, group.sum}).ToString() + "\n";
+    }
+    int filtered = static_cast<int>(std::count_if(rows.begin(), rows.end(), [](const AggregateRow& row) {
+        return row.id >= 100 && row.id <= 5000;
+    }));
+
+    std::vector<std::string> queries;
+    for (std::string table : {"r", "c"}) {
+        queries.push_back("SELECT k, COUNT(*), SUM(id), MIN(s), MAX(v) FROM " + table + " GROUP BY k");
+        queries.push_back("SELECT s, COUNT(*), AVG(v), SUM(v) FROM " + table + " GROUP BY s");
+        queries.push_back("SELECT COUNT(*) FROM " + table + " WHERE id BETWEEN 100 AND 5000");
+        queries.push_back("SELECT COUNT(*), SUM(k), MAX(s) FROM " + table + " WHERE k > 1000");
+    }
+    for (size_t scan_threads : {1, 4}) {
+        for (size_t memory_bytes : {size_t{16} * 1024 * 1024, size_t{4096}}) {
+            std::vector<std::string> results = RunQueries(file.GetName(), scan_threads, memory_bytes, queries);
+            for (size_t i = 0; i < results.size(); i += 4) {
+                CHECK(results[i] == expected_by_k);
+                CHECK(results[i + 1] == expected_by_s);
+                CHECK(results[i + 2] == Record({filtered}).ToString() + "\n");
+                CHECK(results[i + 3] == Record({0, 0, 0}).ToString() + "\n");
+            }
+        }
+    }
+}
+
+// With a budget of one page, groups spill to temporary pages, and every
+// group comes back once with the rows of all its partitions combined.
+TEST(AggregateSpilledPartitions) {
+    TestFile file("aggregate_spill_test.db");
+    auto storage_manager = StorageManager::Open(file.GetName(), StorageBackend::PREAD);
+    BufferPoolManager buffer_pool_manager(32, storage_manager.get());
+    HashAggregate aggregate({0}, {{AggregateFunction::COUNT, -1}, {AggregateFunction::SUM, 1}}, &buffer_pool_manager,
+                            PAGE_SIZE);
+    const int groups = 5000;
+    for (int round = 0; round < 3; ++round) {
+        for (int group = 0; group < groups; ++group) {
+            aggregate.Add(Record({group, round + 1}));
+        }
+    }
+    CHECK(storage_manager->GetPageCount() > 0);
+
+    std::vector<Record> results = aggregate.Finish();
+    CHECK(results.size() == groups);
+    for (size_t i = 0; i < results.size(); ++i) {
+        CHECK(results[i].GetValues() == std::vector<Value>({static_cast<int>(i), 3, 6}));
+    }
+}
\ No newline at end of file
@@ -0,0 +1,179 @@
+#include "test.h"
+#include "database.h"
+#include <algorithm>
+#include <map>
+#include <random>
+
+struct Customer {
+    int id;
+    int region;
+    std::string name;
+};
+
+struct Order {
+    int id;
+    int customer;
+    double amount;
+    int tag;
+};
+
+// Tables of customers and of the orders that refer to them, with some orders
+// whose customer does not exist, loaded into a database and kept to compute
+// the expected join results from.
+class JoinTest {
+public:
+    JoinTest() : file_("join_test.db"), db_(file_.GetName()) {
+        std::mt19937 rng(11);
+        for (int id = 0; id < 1500; id += 1 + rng() % 3) {
+            customers_.push_back({id, static_cast<int>(rng() % 10), "c" + std::to_string(id)});
+        }
+        for (int id = 0; id < 6000; ++id) {
+            orders_.push_back({id, static_cast<int>(rng() % 1700), (rng() % 1000) / 8.0, static_cast<int>(rng() % 2000)});
+        }
+        CHECK(db_.ExecuteQuery("CREATE TABLE customers (id INT, region INT, name VARCHAR)"));
+        CHECK(db_.ExecuteQuery("CREATE TABLE orders (id INT, customer INT, amount DOUBLE, tag INT)"));
+        size_t next = 0;
+        CHECK(db_.BulkLoad("customers", [&](Record& record) {
+            if (next == customers_.size()) {
+                return false;
+            }
+            const Customer& customer = customers_[next++];
+            record = Record({customer.id, customer.region, customer.name});
+            return true;
+        }));
+        next = 0;
+        CHECK(db_.BulkLoad("orders", [&](Record& record) {
+            if (next == orders_.size()) {
+                return false;
+            }
+            const Order& order = orders_[next++];
+            record = Record({order.id, order.customer, order.amount, order.tag});
+            return true;
+        }));
+    }
+
+    // The rows of a query, sorted, since a join promises no order.
+    std::vector<std::string> Query(const std::string& sql) {
+        std::vector<std::string> rows;
+        CHECK(db_.ExecuteQuery(sql));
+        for (const Record& record : db_.GetLastResults()) {
+            rows.push_back(record.ToString());
+        }
+        std::sort(rows.begin(), rows.end());
+        return rows;
+    }
+
+    template <typename Predicate, typename Projection>
+    std::vector<std::string> Expect(Predicate predicate, Projection project) {
+        std::vector<std::string> rows;
+        for (const Order& order : orders_) {
+            for (const Customer& customer : customers_) {
+                if (order.customer == customer.id && predicate(order, customer)) {
+                    rows.push_back(project(order, customer).ToString());
+                }
+            }
+        }
+        std::sort(rows.begin(), rows.end());
+        return rows;
+    }
+
+    Database& GetDatabase() { return db_; }
+    const std::vector<Customer>& GetCustomers() const { return customers_; }
+    const std::vector<Order>& GetOrders() const { return orders_; }
+
+private:
+    TestFile file_;
+    Database db_;
+    std::vector<Customer> customers_;
+    std::vector<Order> orders_;
+};
+
+// The join column is the key of customers, so each order probes its tree.
+TEST(JoinIndexNestedLoop) {
+    JoinTest test;
+    std::vector<std::string> rows = test.Query(
+        "SELECT orders.id, name, amount FROM orders JOIN customers ON orders.customer = customers.id "
+        "WHERE region = 3 AND amount > 60.0");
+    CHECK(!rows.empty());
+    CHECK(rows == test.Expect([](const Order& order, const Customer& customer) {
+        return customer.region == 3 && order.amount > 60.0;
+    }, [](const Order& order, const Customer& customer) {
+        return Record({order.id, customer.name, order.amount});
+    }));
+
+    auto project = [](const Order& order, const Customer& customer) { return Record({customer.id, order.id}); };
+    std::vector<std::string> expected = test.Expect([](const Order&, const Customer& customer) {
+        return customer.id >= 100 && customer.id <= 400;
+    }, project);
+    CHECK(test.Query("SELECT customers.id, orders.id FROM customers JOIN orders ON customers.id = orders.customer "
+                     "WHERE customers.id BETWEEN 100 AND 400") == expected);
+    CHECK(test.Query("SELECT customers.id, orders.id FROM orders JOIN customers ON customers.id = orders.customer "
+                     "WHERE customers.id BETWEEN 100 AND 400") == expected);
+}
+
+// Neither join column is a key, so one side is built into a hash table.
+TEST(JoinHash) {
+    JoinTest test;
+    Database& db = test.GetDatabase();
+    CHECK(db.ExecuteQuery("CREATE TABLE tags (id INT, tag INT, label VARCHAR)"));
+    std::vector<std::pair<int, int>> tags;
+    std::mt19937 rng(5);
+    for (int id = 0; id < 4000; ++id) {
+        tags.push_back({id, static_cast<int>(rng() % 2000)});
+    }
+    size_t next = 0;
+    CHECK(db.BulkLoad("tags", [&](Record& record) {
+        if (next == tags.size()) {
+            return false;
+        }
+        record = Record({tags[next].first, tags[next].second, "l" + std::to_string(tags[next].first)});
+        ++next;
+        return true;
+    }));
+
+    std::vector<std::string> expected;
+    for (const Order& order : test.GetOrders()) {
+        for (const auto& [id, tag] : tags) {
+            if (order.tag == tag && order.id < 3000) {
+                expected.push_back(Record({order.id, id}).ToString());
+            }
+        }
+    }
+    std::sort(expected.begin(), expected.end());
+    std::vector<std::string> rows =
+        test.Query("SELECT orders.id, tags.id FROM orders JOIN tags ON orders.tag = tags.tag WHERE orders.id < 3000");
+    CHECK(!rows.empty());
+    CHECK(rows == expected);
+}
+
+TEST(JoinFilterAndAggregate) {
+    JoinTest test;
+    CHECK(test.Query("SELECT orders.id FROM orders JOIN customers ON customer = customers.id "
+                     "WHERE region = 1 OR amount < 2.0") ==
+          test.Expect([](const Order& order, const Customer& customer) {
+              return customer.region == 1 || order.amount < 2.0;
+          }, [](const Order& order, const Customer&) { return Record({order.id}); }));
+
+    std::map<int, int> counts;
+    for (const Order& order : test.GetOrders()) {
+        for (const Customer& customer : test.GetCustomers()) {
+            if (order.customer == customer.id) {
+                counts[customer.region]++;
+            }
+        }
+    }
+    std::vector<std::string> expected;
+    for (const auto& [region, count] : counts) {
+        expected.push_back(Record({region, count}).ToString());
+    }
+    std::sort(expected.begin(), expected.end());
+    CHECK(test.Query("SELECT region, COUNT(*) FROM orders JOIN customers ON customer = customers.id GROUP BY region") ==
+          expected);
+}
+
+TEST(JoinErrors) {
+    JoinTest test;
+    Database& db = test.GetDatabase();
+    CHECK(!db.ExecuteQuery("SELECT * FROM orders JOIN missing ON a = b"));
+    CHECK(!db.ExecuteQuery("SELECT * FROM orders JOIN customers ON orders.id = orders.tag"));
+}
\ No newline at end of file
@@ -0,0 +1,113 @@
+#include "test.h"
+#include "lz4_codec.h"
+#include "compressed_storage_manager.h"
+#include <random>
+
+static std::vector<std::string> MakeInputs() {
+    std::mt19937 rng(3);
+    std::vector<std::string> inputs;
+    inputs.push_back(std::string(PAGE_SIZE, '\0'));
+    std::string random(PAGE_SIZE, '\0');
+    for (char& c : random) {
+        c = static_cast<char>(rng());
+    }
+    inputs.push_back(random);
+    std::string text;
+    while (text.size() < PAGE_SIZE) {
+        text += "row " + std::to_string(text.size() % 97) + " name=customer" + std::to_string(rng() % 50) + ";";
+    }
+    inputs.push_back(text.substr(0, PAGE_SIZE));
+    // Matches that overlap the bytes they copy, and random runs between them.
+    std::string mixed;
+    while (mixed.size() < 3 * PAGE_SIZE) {
+        mixed += std::string(1 + rng() % 300, static_cast<char>(rng()));
+        mixed += std::string(1 + rng() % 20, 'a') + "ab";
+        for (size_t i = rng() % 40; i > 0; --i) {
+            mixed += static_cast<char>(rng());
+        }
+    }
+    inputs.push_back(mixed);
+    for (size_t size = 1; size <= 32; ++size) {
+        inputs.push_back(text.substr(0, size));
+        inputs.push_back(random.substr(0, size));
+    }
+    return inputs;
+}
+
+TEST(Lz4CodecRoundTrip) {
+    for (const std::string& input : MakeInputs()) {
+        std::string compressed(input.size() + input.size() / 255 + 16, '\0');
+        size_t size = Lz4Codec::Compress(input.data(), input.size(), compressed.data(), compressed.size());
+        CHECK(size > 0);
+
+        std::string output(input.size(), '\0');
+        CHECK(Lz4Codec::Decompress(compressed.data(), size, output.data(), output.size()));
+        CHECK(output == input);
+    }
+}
+
+TEST(Lz4CodecCompresses) {
+    std::vector<std::string> inputs = MakeInputs();
+    std::string compressed(2 * PAGE_SIZE, '\0');
+    CHECK(Lz4Codec::Compress(inputs[0].data(), PAGE_SIZE, compressed.data(), compressed.size()) < PAGE_SIZE / 50);
+    CHECK(Lz4Codec::Compress(inputs[2].data(), PAGE_SIZE, compressed.data(), compressed.size()) < PAGE_SIZE / 2);
+    CHECK(Lz4Codec::Compress(inputs[1].data(), PAGE_SIZE, compressed.data(), PAGE_SIZE / 2) == 0);
+}
+
+// Blocks that are cut short or decode to another size are rejected.
+TEST(Lz4CodecRejectsMalformed) {
+    for (const std::string& input : MakeInputs()) {
+        std::string compressed(input.size() + input.size() / 255 + 16, '\0');
+        size_t size = Lz4Codec::Compress(input.data(), input.size(), compressed.data(), compressed.size());
+        std::string output(input.size() + 1, '\0');
+        CHECK(!Lz4Codec::Decompress(compressed.data(), size, output.data(), input.size() + 1));
+        CHECK(!Lz4Codec::Decompress(compressed.data(), size, output.data(), input.size() - 1));
+        for (size_t cut = 0; cut < size; cut += 1 + size / 64) {
+            CHECK(!Lz4Codec::Decompress(compressed.data(), cut, output.data(), input.size()));
+        }
+    }
+}
+
+// Pages read back as written, and after reopening as of the last Sync.
+TEST(CompressedStorageRoundTrip) {
+    TestFile file("compressed_storage_test.db");
+    std::vector<std::string> inputs = MakeInputs();
+    std::vector<std::string> pages;
+    for (size_t i = 0; i < 48; ++i) {
+        std::string page = inputs[i % 3];
+        page.replace(i % 100 * 8, 8, std::to_string(10000000 + i));
+        pages.push_back(page);
+    }
+    Page buffer;
+
+    {
+        auto storage_manager = StorageManager::Open(file.GetName(), StorageBackend::COMPRESSED);
+        CHECK(storage_manager != nullptr);
+        for (size_t i = 0; storage_manager && i < pages.size(); ++i) {
+            page_id_t page_id = storage_manager->AllocatePage();
+            CHECK(page_id == i);
+            std::memcpy(buffer.GetData(), pages[i].data(), PAGE_SIZE);
+            CHECK(storage_manager->WritePage(page_id, buffer.GetData()));
+        }
+        for (size_t i = 0; storage_manager && i < pages.size(); ++i) {
+            CHECK(storage_manager->ReadPage(static_cast<page_id_t>(i), buffer.GetData()));
+            CHECK(std::string(buffer.GetData(), PAGE_SIZE) == pages[i]);
+        }
+        CHECK(storage_manager && storage_manager->Sync());
+        CHECK(storage_manager && storage_manager->GetStats().CompressionRatio() > 1.5);
+
+        // Not synced, so not there after reopening.
+        for (size_t i = 0; storage_manager && i < pages.size(); i += 5) {
+            std::memcpy(buffer.GetData(), inputs[(i + 1) % 3].data(), PAGE_SIZE);
+            CHECK(storage_manager->WritePage(static_cast<page_id_t>(i), buffer.GetData()));
+        }
+    }
+
+    auto storage_manager = StorageManager::Open(file.GetName(), StorageBackend::COMPRESSED);
+    CHECK(storage_manager != nullptr);
+    CHECK(storage_manager && storage_manager->GetPageCount() == pages.size());
+    for (size_t i = 0; storage_manager && i < pages.size(); ++i) {
+        CHECK(storage_manager->ReadPage(static_cast<page_id_t>(i), buffer.GetData()));
+        CHECK(std::string(buffer.GetData(), PAGE_SIZE) == pages[i]);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,140 @@
+#include "test.h"
+#include "database.h"
+#include "external_sort.h"
+#include <algorithm>
+#include <random>
+
+struct SortRow {
+    int id;
+    int a;
+    double b;
+    std::string s;
+};
+
+template <typename Less, typename Projection>
+static std::vector<std::string> ExpectSorted(std::vector<SortRow> rows, Less less, Projection project,
+                                             size_t offset = 0, size_t limit = SIZE_MAX) {
+    std::stable_sort(rows.begin(), rows.end(), less);
+    std::vector<std::string> results;
+    for (size_t i = offset; i < rows.size() && i - offset < limit; ++i) {
+        results.push_back(project(rows[i]).ToString());
+    }
+    return results;
+}
+
+static std::vector<std::string> RunQuery(Database& db, const std::string& sql) {
+    std::vector<std::string> results;
+    CHECK(db.ExecuteQuery(sql));
+    for (const Record& record : db.GetLastResults()) {
+        results.push_back(record.ToString());
+    }
+    return results;
+}
+
+// A sort budget of a few pages makes far more runs than can be merged at
+// once, so the sorted results come out of several merge passes.
+TEST(OrderByMultiPass) {
+    TestFile file("order_by_test.db");
+    std::mt19937 rng(3);
+    std::vector<SortRow> rows;
+    for (int i = 0; i < 20000; ++i) {
+        rows.push_back({i * 2, static_cast<int>(rng() % 100), (rng() % 5000) / 4.0,
+                        "s" + std::to_string(rng() % 100000)});
+    }
+    DatabaseOptions options;
+    options.sort_memory_bytes = 4 * PAGE_SIZE;
+    Database db(file.GetName(), options);
+    CHECK(db.ExecuteQuery("CREATE TABLE t (id INT, a INT, b DOUBLE, s VARCHAR)"));
+    size_t next = 0;
+    CHECK(db.BulkLoad("t", [&](Record& record) {
+        if (next == rows.size()) {
+            return false;
+        }
+        const SortRow& row = rows[next++];
+        record = Record({row.id, row.a, row.b, row.s});
+        return true;
+    }));
+
+    auto all = [](const SortRow& row) { return Record({row.id, row.a, row.b, row.s}); };
+    CHECK(RunQuery(db, "SELECT * FROM t ORDER BY a, id DESC") ==
+          ExpectSorted(rows, [](const SortRow& x, const SortRow& y) {
+              return x.a != y.a ? x.a < y.a : x.id > y.id;
+          }, all));
+    CHECK(RunQuery(db, "SELECT id, s FROM t ORDER BY b DESC, id LIMIT 17 OFFSET 5") ==
+          ExpectSorted(rows, [](const SortRow& x, const SortRow& y) {
+              return x.b != y.b ? x.b > y.b : x.id < y.id;
+          }, [](const SortRow& row) { return Record({row.id, row.s}); }, 5, 17));
+    CHECK(RunQuery(db, "SELECT s, id FROM t ORDER BY s DESC") ==
+          ExpectSorted(rows, [](const SortRow& x, const SortRow& y) {
+              return x.s != y.s ? x.s > y.s : x.id < y.id;
+          }, [](const SortRow& row) { return Record({row.s, row.id}); }));
+
+    auto cursor = db.Query("SELECT id FROM t ORDER BY b, id");
+    CHECK(cursor != nullptr);
+    std::vector<std::string> streamed;
+    Record record;
+    while (cursor && cursor->Next(record)) {
+        streamed.push_back(record.ToString());
+    }
+    CHECK(streamed == ExpectSorted(rows, [](const SortRow& x, const SortRow& y) {
+        return x.b != y.b ? x.b < y.b : x.id < y.id;
+    }, [](const SortRow& row) { return Record({row.id}); }));
+}
+
+// Rows with equal keys keep the order they were added in across the passes.
+TEST(OrderByExternalSortStable) {
+    TestFile file("order_by_sort_test.db");
+    auto storage_manager = StorageManager::Open(file.GetName(), StorageBackend::PREAD);
+    BufferPoolManager buffer_pool_manager(32, storage_manager.get());
+    const size_t memory_budget = 4 * PAGE_SIZE;
+    ExternalSort sort({{0, true}}, SIZE_MAX, &buffer_pool_manager, memory_budget);
+    const int count = 20000;
+    for (int i = 0; i < count; ++i) {
+        sort.Add(Record({i % 7, i}));
+    }
+    CHECK(sort.GetRunCount() > memory_budget / (2 * PAGE_SIZE));
+    sort.Finish();
+
+    Record record;
+    int previous_key = 7;
+    int previous_sequence = -1;
+    int rows = 0;
+    while (sort.Next(record)) {
+        int key = std::get<int>(record.GetValue(0));
+        int sequence = std::get<int>(record.GetValue(1));
+        CHECK(key < previous_key || (key == previous_key && sequence > previous_sequence));
+        previous_key = key;
+        previous_sequence = sequence;
+        ++rows;
+    }
+    CHECK(rows == count);
+}
+
+// With a limit the first rows are kept in a bounded heap, and nothing spills.
+TEST(OrderByTopK) {
+    TestFile file("order_by_top_test.db");
+    auto storage_manager = StorageManager::Open(file.GetName(), StorageBackend::PREAD);
+    BufferPoolManager buffer_pool_manager(32, storage_manager.get());
+    ExternalSort sort({{1, false}, {0, true}}, 10, &buffer_pool_manager, 4 * PAGE_SIZE);
+    std::mt19937 rng(9);
+    std::vector<std::pair<int, int>> values;
+    for (int i = 0; i < 10000; ++i) {
+        int value = static_cast<int>(rng() % 1000);
+        values.push_back({value, i});
+        sort.Add(Record({i, value}));
+    }
+    sort.Finish();
+    CHECK(sort.GetRunCount() == 1);
+    CHECK(storage_manager->GetPageCount() == 0);
+
+    std::sort(values.begin(), values.end(), [](const auto& x, const auto& y) {
+        return x.first != y.first ? x.first < y.first : x.second > y.second;
+    });
+    Record record;
+    size_t rows = 0;
+    while (sort.Next(record)) {
+        CHECK(rows < 10 && record.GetValues() == std::vector<Value>({values[rows].second, values[rows].first}));
+        ++rows;
+    }
+    CHECK(rows == 10);
+}
\ No newline at end of file
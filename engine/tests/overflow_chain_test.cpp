@@ -0,0 +1,134 @@
+#include "test.h"
+#include "database.h"
+#include "overflow_chain.h"
+#include <algorithm>
+
+static std::string MakeBytes(size_t length, int seed) {
+    std::string bytes(length, '\0');
+    for (size_t i = 0; i < length; ++i) {
+        bytes[i] = static_cast<char>((i * 31 + seed * 7) % 251);
+    }
+    return bytes;
+}
+
+// The pool is smaller than the longer chains, so they are read back from the
+// file rather than from the frames that wrote them.
+TEST(OverflowChainRoundTrip) {
+    TestFile file("overflow_chain_test.db");
+    auto storage_manager = StorageManager::Open(file.GetName(), StorageBackend::PREAD);
+    BufferPoolManager buffer_pool_manager(16, storage_manager.get());
+
+    const size_t capacity = OverflowChain::CAPACITY;
+    for (size_t length : {size_t{1}, capacity - 1, capacity, capacity + 1, 40 * capacity + 17}) {
+        std::string data = MakeBytes(length, static_cast<int>(length));
+        page_id_t first_page;
+        CHECK(OverflowChain::Write(&buffer_pool_manager, data, first_page));
+
+        std::string read = "prefix";
+        CHECK(OverflowChain::Read(&buffer_pool_manager, first_page, length, read));
+        CHECK(read == "prefix" + data);
+
+        std::string head;
+        CHECK(OverflowChain::Read(&buffer_pool_manager, first_page, length / 2, head));
+        CHECK(head == data.substr(0, length / 2));
+
+        std::string past_end;
+        CHECK(!OverflowChain::Read(&buffer_pool_manager, first_page, length + 1, past_end));
+    }
+}
+
+TEST(OverflowChainFree) {
+    TestFile file("overflow_chain_free_test.db");
+    auto storage_manager = StorageManager::Open(file.GetName(), StorageBackend::PREAD);
+    BufferPoolManager buffer_pool_manager(16, storage_manager.get());
+
+    page_id_t first_page;
+    CHECK(OverflowChain::Write(&buffer_pool_manager, MakeBytes(3 * OverflowChain::CAPACITY, 1), first_page));
+    CHECK(buffer_pool_manager.GetFreePages().empty());
+    OverflowChain::Free(&buffer_pool_manager, first_page);
+    std::vector<page_id_t> free_pages = buffer_pool_manager.GetFreePages();
+    CHECK(free_pages.size() == 3);
+    CHECK(std::find(free_pages.begin(), free_pages.end(), first_page) != free_pages.end());
+}
+
+// Repair rewrites a chain only from its first page older than the record.
+TEST(OverflowChainRepair) {
+    TestFile file("overflow_chain_repair_test.db");
+    auto storage_manager = StorageManager::Open(file.GetName(), StorageBackend::PREAD);
+    BufferPoolManager buffer_pool_manager(16, storage_manager.get());
+
+    size_t length = 3 * OverflowChain::CAPACITY + 5;
+    std::string old_data = MakeBytes(length, 1);
+    std::string new_data = MakeBytes(length, 2);
+    page_id_t first_page;
+    CHECK(OverflowChain::Write(&buffer_pool_manager, old_data, first_page, 10));
+
+    std::string read;
+    CHECK(OverflowChain::Repair(&buffer_pool_manager, new_data, first_page, 5));
+    CHECK(OverflowChain::Read(&buffer_pool_manager, first_page, length, read));
+    CHECK(read == old_data);
+
+    read.clear();
+    CHECK(OverflowChain::Repair(&buffer_pool_manager, new_data, first_page, 20));
+    CHECK(OverflowChain::Read(&buffer_pool_manager, first_page, length, read));
+    CHECK(read == new_data);
+}
+
+// A rewritten chain keeps its pages when the data shrinks and grows when it
+// does not fit.
+TEST(OverflowChainRewrite) {
+    TestFile file("overflow_chain_rewrite_test.db");
+    auto storage_manager = StorageManager::Open(file.GetName(), StorageBackend::PREAD);
+    BufferPoolManager buffer_pool_manager(16, storage_manager.get());
+
+    page_id_t first_page = INVALID_PAGE_ID;
+    uint32_t page_count = 0;
+    const size_t capacity = OverflowChain::CAPACITY;
+    uint32_t expected_pages = 0;
+    int seed = 0;
+    for (size_t length : {2 * capacity + 1, size_t{10}, 5 * capacity, capacity, 6 * capacity + 3}) {
+        std::string data = MakeBytes(length, ++seed);
+        CHECK(OverflowChain::Rewrite(&buffer_pool_manager, data, first_page, page_count));
+        expected_pages = std::max<uint32_t>(expected_pages, static_cast<uint32_t>((length + capacity - 1) / capacity));
+        CHECK(page_count == expected_pages);
+
+        std::string read;
+        CHECK(OverflowChain::Read(&buffer_pool_manager, first_page, length, read));
+        CHECK(read == data);
+    }
+}
+
+// Strings longer than a leaf can hold are kept in overflow chains by both
+// table layouts, and read back whole after the database is reopened.
+TEST(OverflowChainLongStrings) {
+    TestFile file("overflow_chain_strings_test.db");
+    std::vector<size_t> lengths = {0, 100, PAGE_SIZE / 2, PAGE_SIZE, 3 * PAGE_SIZE + 1, 20 * PAGE_SIZE};
+    {
+        Database db(file.GetName());
+        for (std::string storage : {"row", "columnar"}) {
+            std::string table = storage == "row" ? "r" : "c";
+            CHECK(db.ExecuteQuery("CREATE TABLE " + table + " (id INT, body VARCHAR, n INT) WITH (storage = " +
+                                  storage + ")"));
+            auto insert = db.Prepare("INSERT INTO " + table + " VALUES (?, ?, ?)");
+            CHECK(insert != nullptr);
+            for (size_t i = 0; insert && i < lengths.size(); ++i) {
+                int id = static_cast<int>(i);
+                insert->Bind(0, id);
+                insert->Bind(1, MakeBytes(lengths[i], id));
+                insert->Bind(2, id * 2);
+                CHECK(insert->Execute());
+            }
+        }
+    }
+
+    Database db(file.GetName());
+    for (std::string table : {"r", "c"}) {
+        CHECK(db.ExecuteQuery("SELECT * FROM " + table));
+        const std::vector<Record>& results = db.GetLastResults();
+        CHECK(results.size() == lengths.size());
+        for (size_t i = 0; i < results.size() && i < lengths.size(); ++i) {
+            int id = static_cast<int>(i);
+            CHECK(results[i].GetValues() == std::vector<Value>({id, MakeBytes(lengths[i], id), id * 2}));
+        }
+    }
+}
\ No newline at end of file
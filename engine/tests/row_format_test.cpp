@@ -0,0 +1,92 @@
+#include "test.h"
+#include "row_format.h"
+
+// Encodes record into a buffer with guard bytes after GetSize, and checks
+// that the encoding fills it exactly and decodes to the same values.
+static Record RoundTrip(const RowFormat& format, const Record& record) {
+    const char guard = '\x5a';
+    size_t size = format.GetSize(record);
+    std::string buffer(size + 16, guard);
+    format.Encode(record, buffer.data());
+    CHECK(buffer.substr(size) == std::string(16, guard));
+
+    Record decoded = format.Decode(buffer.data());
+    CHECK(decoded.GetValues() == record.GetValues());
+    return decoded;
+}
+
+TEST(RowFormatTypedRoundTrip) {
+    RowFormat format({ColumnType::INT, ColumnType::STRING, ColumnType::DOUBLE, ColumnType::INT, ColumnType::STRING});
+    std::vector<Record> records = {
+        Record({1, std::string("one"), 1.5, -7, std::string("")}),
+        Record({-2147483647, std::string(1000, 'x'), -0.25, 2147483647, std::string("last")}),
+        // Values of another type than their column's.
+        Record({std::string("not an int"), 42, std::string("not a double"), 3.75, 9}),
+        // Columns past the end of a shorter record are null.
+        Record({5, std::string("short")}),
+        Record({6}),
+        Record(),
+    };
+    for (const Record& record : records) {
+        CHECK(format.CanEncode(record));
+        RoundTrip(format, record);
+    }
+    CHECK(!format.CanEncode(Record({1, std::string("a"), 2.0, 3, std::string("b"), 4})));
+}
+
+TEST(RowFormatUntypedRoundTrip) {
+    RowFormat format;
+    CHECK(!format.IsTyped());
+    Record record({1, 2.5, std::string("three"), std::string(300, 'y'), -4});
+    CHECK(format.CanEncode(record));
+    CHECK(format.GetSize(record) == record.GetSize());
+    RoundTrip(format, record);
+}
+
+TEST(RowFormatOverflowRoundTrip) {
+    for (RowFormat format : {RowFormat({ColumnType::INT, ColumnType::STRING, ColumnType::INT}), RowFormat()}) {
+        Record record({7, std::string(), 8});
+        record.SetOverflow(1, std::string(64, 'p'), 100000, 1234);
+        Record decoded = RoundTrip(format, record);
+        CHECK(decoded.GetOverflow().size() == 1);
+        if (decoded.GetOverflow().size() == 1) {
+            const Record::Overflow& overflow = decoded.GetOverflow()[0];
+            CHECK(overflow.index == 1);
+            CHECK(overflow.length == 100000);
+            CHECK(overflow.page == 1234);
+        }
+    }
+}
+
+// Visit passes only the columns asked for, reading fixed slots in place.
+TEST(RowFormatVisitNeeded) {
+    RowFormat format({ColumnType::INT, ColumnType::DOUBLE, ColumnType::STRING, ColumnType::INT});
+    Record record({11, 2.5, std::string("text"), std::string("other type")});
+    std::string buffer(format.GetSize(record), '\0');
+    format.Encode(record, buffer.data());
+
+    std::vector<bool> needed = {false, true, false, true};
+    std::vector<size_t> columns;
+    std::vector<Value> values;
+    format.Visit(buffer.data(), &needed, [&](size_t column, const auto& value) {
+        using T = std::decay_t<decltype(value)>;
+        columns.push_back(column);
+        if constexpr (std::is_same_v<T, std::string_view>) {
+            values.push_back(std::string(value));
+        } else if constexpr (std::is_same_v<T, OverflowRef>) {
+            values.push_back(std::string(value.prefix));
+        } else {
+            values.push_back(value);
+        }
+    });
+    CHECK(columns == std::vector<size_t>({1, 3}));
+    CHECK(values == std::vector<Value>({2.5, std::string("other type")}));
+}
+
+TEST(RowFormatTypeOf) {
+    CHECK(RowFormat::TypeOf("integer") == ColumnType::INT);
+    CHECK(RowFormat::TypeOf("INT") == ColumnType::INT);
+    CHECK(RowFormat::TypeOf("Real") == ColumnType::DOUBLE);
+    CHECK(RowFormat::TypeOf("FLOAT") == ColumnType::DOUBLE);
+    CHECK(RowFormat::TypeOf("VARCHAR") == ColumnType::STRING);
+}
\ No newline at end of file
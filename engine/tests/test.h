@@ -0,0 +1,50 @@
+#pragma once
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// A small harness for the engine tests: TEST defines a test case and
+// registers it with the runner in test_main.cpp, and CHECK reports a failed
+// condition and carries on with the test.
+struct TestCase {
+    const char* name;
+    void (*run)();
+};
+
+std::vector<TestCase>& GetTestCases();
+void ReportFailure(const char* file, int line, const char* condition);
+
+struct TestRegistration {
+    TestRegistration(const char* name, void (*run)()) { GetTestCases().push_back({name, run}); }
+};
+
+#define TEST(name)                                                  \
+    static void name();                                             \
+    static TestRegistration name##_registration(#name, name);       \
+    static void name()
+
+#define CHECK(condition)                                            \
+    do {                                                            \
+        if (!(condition)) {                                         \
+            ReportFailure(__FILE__, __LINE__, #condition);          \
+        }                                                           \
+    } while (0)
+
+// A database file for one test, removed with its log and hot-page list when
+// the test is done with it.
+class TestFile {
+public:
+    explicit TestFile(std::string name) : name_(std::move(name)) { Remove(); }
+    ~TestFile() { Remove(); }
+
+    const std::string& GetName() const { return name_; }
+
+private:
+    std::string name_;
+
+    void Remove() {
+        for (const char* suffix : {"", ".wal", ".hot", ".hot.tmp"}) {
+            std::remove((name_ + suffix).c_str());
+        }
+    }
+};
\ No newline at end of file
@@ -0,0 +1,37 @@
+#include "test.h"
+#include <cstring>
+#include <iostream>
+
+static int failures = 0;
+
+std::vector<TestCase>& GetTestCases() {
+    static std::vector<TestCase> test_cases;
+    return test_cases;
+}
+
+void ReportFailure(const char* file, int line, const char* condition) {
+    std::cerr << file << ":" << line << ": CHECK(" << condition << ") failed" << std::endl;
+    ++failures;
+}
+
+// Runs every test, or those whose names contain the first argument.
+int main(int argc, char* argv[]) {
+    size_t run = 0;
+    int failed = 0;
+    for (const TestCase& test_case : GetTestCases()) {
+        if (argc > 1 && !std::strstr(test_case.name, argv[1])) {
+            continue;
+        }
+        int before = failures;
+        test_case.run();
+        ++run;
+        if (failures != before) {
+            ++failed;
+            std::cout << "FAILED " << test_case.name << std::endl;
+        } else {
+            std::cout << "ok     " << test_case.name << std::endl;
+        }
+    }
+    std::cout << run - failed << " of " << run << " tests passed" << std::endl;
+    return failed == 0 ? 0 : 1;
+}
\ No newline at end of file